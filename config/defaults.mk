@@ -8,6 +8,9 @@ LIBS_osx += -Dplatform_lib=$(word 1,$(PLATFORM) osx)
 LIBS_osx += -Dasset_lib=$(word 1,$(ASSET) fs)
 LIBS_osx += -Dhttp_lib=$(word 1,$(HTTP) nsurl)
 LIBS_osx += -Dcache_lib=$(word 1,$(CACHE) sqlite)
+LIBS_osx += -Dgl_recording=$(word 1,$(GL_RECORDING) 0)
+LIBS_osx += -Dgl_call_counting=$(word 1,$(GL_CALL_COUNTING) 0)
+LIBS_osx += -Dcollision_rtree=$(word 1,$(COLLISION_RTREE) 0)
 LIBS_osx += --depth=. -Goutput_dir=.
 
 
@@ -28,6 +31,9 @@ LIBS_linux += -Dplatform_lib=$(word 1,$(PLATFORM) linux)
 LIBS_linux += -Dasset_lib=$(word 1,$(ASSET) fs)
 LIBS_linux += -Dhttp_lib=$(word 1,$(HTTP) curl)
 LIBS_linux += -Dcache_lib=$(word 1,$(CACHE) sqlite)
+LIBS_linux += -Dgl_recording=$(word 1,$(GL_RECORDING) 0)
+LIBS_linux += -Dgl_call_counting=$(word 1,$(GL_CALL_COUNTING) 0)
+LIBS_linux += -Dcollision_rtree=$(word 1,$(COLLISION_RTREE) 0)
 LIBS_linux += --depth=. -Goutput_dir=.
 
 ANDROID_ABIS += android-lib-arm-v8
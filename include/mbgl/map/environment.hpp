@@ -6,6 +6,7 @@
 
 #include <thread>
 #include <functional>
+#include <memory>
 #include <vector>
 
 typedef struct uv_loop_s uv_loop_t;
@@ -41,6 +42,12 @@ public:
     // File request APIs
     Request* request(const Resource&, std::function<void(const Response&)>);
     void cancelRequest(Request*);
+    void setRequestPriority(Request*, double priority);
+
+    // Stores data derived from resources in the file source's cache. Can be called from
+    // any thread.
+    void store(const Resource&, std::shared_ptr<const Response>);
+    bool storesDerivedData() const;
 
     // #############################################################################################
 
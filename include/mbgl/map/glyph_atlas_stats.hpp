@@ -0,0 +1,35 @@
+#ifndef MBGL_MAP_GLYPH_ATLAS_STATS
+#define MBGL_MAP_GLYPH_ATLAS_STATS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+
+// Usage of the texture atlas that holds the glyphs of all labels.
+struct GlyphAtlasStats {
+    // Pages that are in use. A second page is only allocated once the glyphs of a tile's
+    // labels don't fit on the first one anymore.
+    std::size_t pages = 0;
+
+    // Glyphs in the atlas. Glyphs that no tile uses anymore are kept until their space is
+    // needed for others, so that tiles that come back don't have to upload them again.
+    std::size_t glyphs = 0;
+    std::size_t unusedGlyphs = 0;
+
+    // How scattered the free space of the most fragmented page is, from 0 to 1. Once it is
+    // too high to place a glyph, the free space is rebuilt around the glyphs in use.
+    float fragmentation = 0;
+
+    // Unused glyphs that were evicted to make room for others, and the number of times the
+    // free space was rebuilt.
+    uint64_t evictions = 0;
+    uint64_t compactions = 0;
+
+    // Glyphs that didn't fit on any page. Their labels are missing characters.
+    uint64_t overflows = 0;
+};
+
+}
+
+#endif
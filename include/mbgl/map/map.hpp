@@ -4,6 +4,10 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/map/update.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/map/tile_cache_stats.hpp>
+#include <mbgl/map/memory_stats.hpp>
+#include <mbgl/map/render_stats.hpp>
+#include <mbgl/map/glyph_atlas_stats.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/vec.hpp>
@@ -120,8 +124,38 @@ public:
     LatLngBounds getBoundsForAnnotations(const std::vector<uint32_t>&);
 
     // Memory
+    // Limits the tile cache of each source to the given number of tiles. 0 means that
+    // only the byte budget applies, which is the default.
     void setSourceTileCacheSize(size_t);
+    // Limits the estimated memory footprint of the tile cache of each source.
+    void setSourceTileCacheBudget(size_t bytes);
+    // Returns the combined statistics of the tile caches of all sources. The peak is
+    // the sum of the peaks of each source.
+    TileCacheStats getSourceTileCacheStats() const;
+    // Limits the memory footprint of the compressed data of tiles that were evicted from
+    // the tile cache of each source. Tiles that are found there are parsed again without
+    // being loaded. 0 disables this second tier.
+    void setSourceCompressedTileCacheBudget(size_t bytes);
+    // Returns the combined statistics of the compressed tiers. Its hits are tiles that
+    // didn't have to be loaded again.
+    TileCacheStats getSourceCompressedTileCacheStats() const;
+    // Limits the estimated total memory usage of the map. When it is exceeded, cached
+    // tiles are evicted first; see MemoryPressure for the levels of eviction. 0 means
+    // that memory usage is not limited.
+    void setMemoryBudget(size_t bytes);
+    MemoryStats getMemoryStats() const;
+    // Evicts everything that can be reloaded, as if the memory budget was exceeded at
+    // the critical level.
     void onLowMemory();
+    // Limits the tiles that each source requests ahead of the map, along the active
+    // transition or the velocity of a pan gesture: the number of requests in flight, and
+    // the bytes loaded until the map comes to rest. 0 requests disable prefetching.
+    void setTilePrefetchBudget(size_t requests, size_t bytes);
+    // Returns what it took to render the last frame, e.g. the number of GL calls.
+    RenderStats getRenderStats() const;
+    // Returns how full and fragmented the glyph atlas is, and how many glyphs were evicted
+    // from it or didn't fit.
+    GlyphAtlasStats getGlyphAtlasStats() const;
 
     // Debug
     void setDebug(bool value);
@@ -0,0 +1,51 @@
+#ifndef MBGL_MAP_MEMORY_STATS
+#define MBGL_MAP_MEMORY_STATS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+
+// How far memory usage exceeded the budget, and thus what was evicted to get back within it.
+enum class MemoryPressure : uint8_t {
+    // Within the budget; nothing was evicted.
+    Normal,
+
+    // Over the budget, but trimming the least recently used tiles from the tile caches
+    // was enough to get back within it.
+    Moderate,
+
+    // Over the budget even without the tile caches, or the system is low on memory. The
+    // tile caches and the spare textures were dropped, and the file cache was asked to
+    // release its memory.
+    Critical
+};
+
+// Estimated memory usage, in bytes, broken down by owner.
+struct MemoryStats {
+    // Tiles that are in use, and tiles that went out of view and are cached, including
+    // the compressed data of evicted tiles.
+    std::size_t tiles = 0;
+    std::size_t tileCaches = 0;
+
+    // Including the textures they were uploaded to.
+    std::size_t glyphAtlas = 0;
+    std::size_t spriteAtlas = 0;
+
+    // Textures of tiles that were removed, kept for reuse.
+    std::size_t texturePool = 0;
+
+    // The in-memory part of the file cache.
+    std::size_t fileCache = 0;
+
+    std::size_t budget = 0;
+    MemoryPressure pressure = MemoryPressure::Normal;
+
+    std::size_t total() const {
+        return tiles + tileCaches + glyphAtlas + spriteAtlas + texturePool + fileCache;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef MBGL_MAP_RENDER_STATS
+#define MBGL_MAP_RENDER_STATS
+
+#include <cstddef>
+
+namespace mbgl {
+
+// What it took to render the last frame.
+struct RenderStats {
+    // GL calls made by the painter, including those that were needed to upload buffers and
+    // textures, and to draw the clipping masks. Only counted in builds with gl_call_counting=1.
+    std::size_t glCalls = 0;
+
+    // The bucket of each layer in each tile counts once per render pass it is drawn in.
+    std::size_t tileLayers = 0;
+
+    // Layers whose buckets were drawn together for all tiles, binding each of their shaders
+    // once per render pass instead of once per tile.
+    std::size_t batchedLayers = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef MBGL_MAP_TILE_CACHE_STATS
+#define MBGL_MAP_TILE_CACHE_STATS
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mbgl {
+
+// Memory usage and effectiveness of tile caches. Tiles are cached once they go out of
+// view, so that they don't have to be loaded and parsed again when they come back.
+struct TileCacheStats {
+    std::size_t tiles = 0;
+
+    // Estimated memory footprint of the cached tiles, including their raw data, vertex
+    // buffers, buckets and raster images.
+    std::size_t bytes = 0;
+    std::size_t peakBytes = 0;
+
+    // Lookups for tiles that are needed again.
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+}
+
+#endif
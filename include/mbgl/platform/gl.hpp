@@ -1,6 +1,7 @@
 #ifndef MBGL_RENDERER_GL
 #define MBGL_RENDERER_GL
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 #include <vector>
@@ -29,6 +30,10 @@
     #include <GL/glext.h>
 #endif
 
+#if defined(MBGL_GL_RECORDING)
+#include <mbgl/platform/gl_recording.hpp>
+#endif
+
 namespace mbgl {
 namespace gl {
 
@@ -39,8 +44,45 @@ struct Error : ::std::runtime_error {
 
 void checkError(const char *cmd, const char *file, int line);
 
+// Counts the GL calls that are made through MBGL_CHECK_ERROR on the thread that created it,
+// for as long as it exists. Counters may be nested; only the innermost one counts. Calls are
+// only counted in builds with gl_call_counting=1, and calls stays zero otherwise.
+class CallCounter {
+public:
+    CallCounter();
+    ~CallCounter();
+
+    CallCounter(const CallCounter&) = delete;
+    CallCounter& operator=(const CallCounter&) = delete;
+
+    std::size_t calls = 0;
+
+private:
+    CallCounter* const previous;
+};
+
+#if defined(MBGL_GL_CALL_COUNTING)
+// Counts the call of the MBGL_CHECK_ERROR it is declared in, unless the call made a nested
+// MBGL_CHECK_ERROR call that was counted already, e.g. for wrappers of GL functions.
+class CallScope {
+public:
+    CallScope();
+    ~CallScope();
+
+private:
+    CallCounter* const counter;
+    const std::size_t calls;
+};
+
+#define MBGL_COUNT_GL_CALL ::mbgl::gl::CallScope __MBGL_C_S;
+#else
+#define MBGL_COUNT_GL_CALL
+#endif
+
 #if defined(DEBUG)
-#define MBGL_CHECK_ERROR(cmd) ([&]() { struct __MBGL_C_E { inline ~__MBGL_C_E() { ::mbgl::gl::checkError(#cmd, __FILE__, __LINE__); } } __MBGL_C_E; return cmd; }())
+#define MBGL_CHECK_ERROR(cmd) ([&]() { struct __MBGL_C_E { inline ~__MBGL_C_E() { ::mbgl::gl::checkError(#cmd, __FILE__, __LINE__); } } __MBGL_C_E; MBGL_COUNT_GL_CALL return cmd; }())
+#elif defined(MBGL_GL_CALL_COUNTING)
+#define MBGL_CHECK_ERROR(cmd) ([&]() { MBGL_COUNT_GL_CALL return cmd; }())
 #else
 #define MBGL_CHECK_ERROR(cmd) (cmd)
 #endif
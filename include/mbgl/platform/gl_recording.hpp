@@ -0,0 +1,142 @@
+#ifndef MBGL_PLATFORM_GL_RECORDING
+#define MBGL_PLATFORM_GL_RECORDING
+
+// Included by gl.hpp when building with MBGL_GL_RECORDING. Routes the GL entry points that
+// mbgl uses to stand-ins that don't need a GL context. Instead of calling into the driver,
+// they append the calls to the stream that was passed to gl::recording::start(). Functions
+// that create objects return new names, and status queries report success.
+
+namespace mbgl {
+namespace gl {
+namespace recording {
+
+void ActiveTexture(GLenum texture);
+void AttachShader(GLuint program, GLuint shader);
+void BindBuffer(GLenum target, GLuint buffer);
+void BindTexture(GLenum target, GLuint texture);
+void BlendFunc(GLenum sfactor, GLenum dfactor);
+void BufferData(GLenum target, GLsizeiptr size, const GLvoid* data, GLenum usage);
+void Clear(GLbitfield mask);
+void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+void ClearDepth(double depth);
+void ClearStencil(GLint s);
+void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+void CompileShader(GLuint shader);
+GLuint CreateProgram();
+GLuint CreateShader(GLenum type);
+void DeleteBuffers(GLsizei n, const GLuint* buffers);
+void DeleteProgram(GLuint program);
+void DeleteShader(GLuint shader);
+void DeleteTextures(GLsizei n, const GLuint* textures);
+void DepthFunc(GLenum func);
+void DepthMask(GLboolean flag);
+void DepthRange(double zNear, double zFar);
+void DetachShader(GLuint program, GLuint shader);
+void Disable(GLenum cap);
+void DrawArrays(GLenum mode, GLint first, GLsizei count);
+void DrawElements(GLenum mode, GLsizei count, GLenum type, const GLvoid* indices);
+void Enable(GLenum cap);
+void EnableVertexAttribArray(GLuint index);
+void Finish();
+void GenBuffers(GLsizei n, GLuint* buffers);
+void GenTextures(GLsizei n, GLuint* textures);
+GLint GetAttribLocation(GLuint program, const GLchar* name);
+GLenum GetError();
+void GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void GetProgramiv(GLuint program, GLenum pname, GLint* params);
+void GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog);
+void GetShaderiv(GLuint shader, GLenum pname, GLint* params);
+const GLubyte* GetString(GLenum name);
+GLint GetUniformLocation(GLuint program, const GLchar* name);
+void LineWidth(GLfloat width);
+void LinkProgram(GLuint program);
+void PointSize(GLfloat size);
+void ShaderSource(GLuint shader, GLsizei count, const GLchar* const* string, const GLint* length);
+void StencilFunc(GLenum func, GLint ref, GLuint mask);
+void StencilMask(GLuint mask);
+void StencilOp(GLenum fail, GLenum zfail, GLenum zpass);
+void TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+                GLint border, GLenum format, GLenum type, const GLvoid* pixels);
+void TexParameteri(GLenum target, GLenum pname, GLint param);
+void TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width,
+                   GLsizei height, GLenum format, GLenum type, const GLvoid* pixels);
+void Uniform1f(GLint location, GLfloat v0);
+void Uniform1i(GLint location, GLint v0);
+void Uniform2fv(GLint location, GLsizei count, const GLfloat* value);
+void Uniform3fv(GLint location, GLsizei count, const GLfloat* value);
+void Uniform4fv(GLint location, GLsizei count, const GLfloat* value);
+void UniformMatrix2fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+void UseProgram(GLuint program);
+void ValidateProgram(GLuint program);
+void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+                         const GLvoid* pointer);
+void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+}
+}
+}
+
+#define glActiveTexture ::mbgl::gl::recording::ActiveTexture
+#define glAttachShader ::mbgl::gl::recording::AttachShader
+#define glBindBuffer ::mbgl::gl::recording::BindBuffer
+#define glBindTexture ::mbgl::gl::recording::BindTexture
+#define glBlendFunc ::mbgl::gl::recording::BlendFunc
+#define glBufferData ::mbgl::gl::recording::BufferData
+#define glClear ::mbgl::gl::recording::Clear
+#define glClearColor ::mbgl::gl::recording::ClearColor
+#define glClearDepth ::mbgl::gl::recording::ClearDepth
+#define glClearStencil ::mbgl::gl::recording::ClearStencil
+#define glColorMask ::mbgl::gl::recording::ColorMask
+#define glCompileShader ::mbgl::gl::recording::CompileShader
+#define glCreateProgram ::mbgl::gl::recording::CreateProgram
+#define glCreateShader ::mbgl::gl::recording::CreateShader
+#define glDeleteBuffers ::mbgl::gl::recording::DeleteBuffers
+#define glDeleteProgram ::mbgl::gl::recording::DeleteProgram
+#define glDeleteShader ::mbgl::gl::recording::DeleteShader
+#define glDeleteTextures ::mbgl::gl::recording::DeleteTextures
+#define glDepthFunc ::mbgl::gl::recording::DepthFunc
+#define glDepthMask ::mbgl::gl::recording::DepthMask
+#define glDepthRange ::mbgl::gl::recording::DepthRange
+#define glDetachShader ::mbgl::gl::recording::DetachShader
+#define glDisable ::mbgl::gl::recording::Disable
+#define glDrawArrays ::mbgl::gl::recording::DrawArrays
+#define glDrawElements ::mbgl::gl::recording::DrawElements
+#define glEnable ::mbgl::gl::recording::Enable
+#define glEnableVertexAttribArray ::mbgl::gl::recording::EnableVertexAttribArray
+#define glFinish ::mbgl::gl::recording::Finish
+#define glGenBuffers ::mbgl::gl::recording::GenBuffers
+#define glGenTextures ::mbgl::gl::recording::GenTextures
+#define glGetAttribLocation ::mbgl::gl::recording::GetAttribLocation
+#define glGetError ::mbgl::gl::recording::GetError
+#define glGetProgramInfoLog ::mbgl::gl::recording::GetProgramInfoLog
+#define glGetProgramiv ::mbgl::gl::recording::GetProgramiv
+#define glGetShaderInfoLog ::mbgl::gl::recording::GetShaderInfoLog
+#define glGetShaderiv ::mbgl::gl::recording::GetShaderiv
+#define glGetString ::mbgl::gl::recording::GetString
+#define glGetUniformLocation ::mbgl::gl::recording::GetUniformLocation
+#define glLineWidth ::mbgl::gl::recording::LineWidth
+#define glLinkProgram ::mbgl::gl::recording::LinkProgram
+#define glPointSize ::mbgl::gl::recording::PointSize
+#define glShaderSource ::mbgl::gl::recording::ShaderSource
+#define glStencilFunc ::mbgl::gl::recording::StencilFunc
+#define glStencilMask ::mbgl::gl::recording::StencilMask
+#define glStencilOp ::mbgl::gl::recording::StencilOp
+#define glTexImage2D ::mbgl::gl::recording::TexImage2D
+#define glTexParameteri ::mbgl::gl::recording::TexParameteri
+#define glTexSubImage2D ::mbgl::gl::recording::TexSubImage2D
+#define glUniform1f ::mbgl::gl::recording::Uniform1f
+#define glUniform1i ::mbgl::gl::recording::Uniform1i
+#define glUniform2fv ::mbgl::gl::recording::Uniform2fv
+#define glUniform3fv ::mbgl::gl::recording::Uniform3fv
+#define glUniform4fv ::mbgl::gl::recording::Uniform4fv
+#define glUniformMatrix2fv ::mbgl::gl::recording::UniformMatrix2fv
+#define glUniformMatrix3fv ::mbgl::gl::recording::UniformMatrix3fv
+#define glUniformMatrix4fv ::mbgl::gl::recording::UniformMatrix4fv
+#define glUseProgram ::mbgl::gl::recording::UseProgram
+#define glValidateProgram ::mbgl::gl::recording::ValidateProgram
+#define glVertexAttribPointer ::mbgl::gl::recording::VertexAttribPointer
+#define glViewport ::mbgl::gl::recording::Viewport
+
+#endif
@@ -18,13 +18,29 @@ public:
     void setAccessToken(const std::string& t) { accessToken = t; }
     std::string getAccessToken() const { return accessToken; }
 
+    // Limits the number of network connections that are open at the same time.
+    void setMaxConnections(std::size_t perHost, std::size_t total);
+
+    // Limits the number of network requests in flight, and the number of those that may be
+    // tile requests, so that styles, glyphs and sprites are never stuck behind tiles. Further
+    // requests wait in the file source until a request completes, and never reach the
+    // network if they are canceled before.
+    void setMaxActiveRequests(std::size_t requests, std::size_t tileRequests);
+
     // FileSource API
     Request* request(const Resource&, uv_loop_t*, Callback) override;
     void cancel(Request*) override;
+    void setPriority(Request*, double priority) override;
+    void store(const Resource&, std::shared_ptr<const Response>) override;
+    bool storesDerivedData() const override;
+    void pin(const Resource&) override;
+    std::size_t getMemoryUsage() const override;
+    void releaseMemory() override;
 
 public:
     class Impl;
 private:
+    FileCache* const cache;
     const std::unique_ptr<util::Thread<Impl>> thread;
     std::string accessToken;
 };
@@ -3,6 +3,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 
+#include <cstddef>
 #include <functional>
 #include <memory>
 
@@ -20,6 +21,16 @@ public:
 
     virtual void get(const Resource &resource, Callback callback) = 0;
     virtual void put(const Resource &resource, std::shared_ptr<const Response> response, Hint hint) = 0;
+
+    // Keeps the cached response of a resource from being evicted, e.g. because it belongs to
+    // a region that was downloaded for offline use. Updated responses stay pinned. Caches that
+    // don't evict anything ignore it.
+    virtual void pin(const Resource&) {}
+
+    // The memory held by the cache, e.g. by an in-memory database, and a request to release
+    // as much of it as possible without losing data. These can be called from any thread.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+    virtual void releaseMemory() {}
 };
 
 }
@@ -7,7 +7,9 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/util.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <memory>
 
 typedef struct uv_loop_s uv_loop_t;
 
@@ -28,6 +30,30 @@ public:
     // You can only cancel a request from the same thread it was created in.
     virtual Request* request(const Resource&, uv_loop_t*, Callback) = 0;
     virtual void cancel(Request*) = 0;
+
+    // Changes the priority of a request that wasn't started yet. Requests with a lower value
+    // are started first. Can only be called from the thread the request was created in, before
+    // its callback was invoked. File sources that start all requests right away ignore this.
+    virtual void setPriority(Request*, double /* priority */) {}
+
+    // Stores data that was derived from resources, e.g. the buckets of a parsed tile, so
+    // that later requests for it are answered from the cache. Derived data is never
+    // requested from the network; file sources without a cache ignore it.
+    virtual void store(const Resource&, std::shared_ptr<const Response>) {}
+
+    // Whether stored derived data can be requested again, i.e. whether the file source has a
+    // cache. Lets callers skip requests for derived data that can never succeed.
+    virtual bool storesDerivedData() const { return false; }
+
+    // Keeps the cached response of a resource that was requested before from being evicted,
+    // e.g. because it is part of a region that was downloaded for offline use. File sources
+    // without a cache ignore it.
+    virtual void pin(const Resource&) {}
+
+    // The memory held by the file source, e.g. by its cache, and a request to release as
+    // much of it as possible. These can be called from any thread.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+    virtual void releaseMemory() {}
 };
 
 }
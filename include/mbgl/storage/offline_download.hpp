@@ -0,0 +1,120 @@
+#ifndef MBGL_STORAGE_OFFLINE_DOWNLOAD
+#define MBGL_STORAGE_OFFLINE_DOWNLOAD
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/geo.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <set>
+#include <string>
+#include <unordered_set>
+
+typedef struct uv_loop_s uv_loop_t;
+
+namespace mbgl {
+
+class FileSource;
+class Request;
+class Response;
+class SourceInfo;
+
+// The area and zoom levels of a map that should be available offline.
+struct OfflineRegion {
+    std::string styleURL;
+    LatLngBounds bounds;
+    double minZoom = 0;
+    double maxZoom = 0;
+    float pixelRatio = 1;
+};
+
+struct OfflineProgress {
+    // The number of resources that are known to be required so far. It grows while the style
+    // and the TileJSON of its sources are loaded, and is final once `complete` is set.
+    uint64_t requiredResources = 0;
+
+    // Resources that were downloaded, including those a previous download of the region
+    // already completed, and the size of those that were downloaded by this one.
+    uint64_t completedResources = 0;
+    uint64_t completedBytes = 0;
+
+    // Resources that failed to download.
+    uint64_t failedResources = 0;
+
+    // All required resources were either completed or failed.
+    bool complete = false;
+};
+
+// Downloads everything a region needs through a file source, so that its cache can serve the
+// region without a network connection: the style, the TileJSON and the tiles of its vector and
+// raster sources, the glyph ranges of all font stacks used by its symbol layers, and its sprite.
+// Downloaded resources are pinned in the cache, so that they are never evicted.
+//
+// The URLs of completed resources are appended to a progress file. A download of the same
+// region with the same progress file skips them, so an interrupted download resumes where it
+// stopped. Resources that failed are retried by the next download.
+//
+// All callbacks run on the given loop, which must be the loop of the creating thread.
+class OfflineDownload : private util::noncopyable {
+public:
+    using Callback = std::function<void (const OfflineProgress&)>;
+
+    static const std::size_t defaultConcurrentRequests = 8;
+
+    OfflineDownload(FileSource&, uv_loop_t*, const OfflineRegion&, const std::string& progressPath,
+                    Callback);
+    ~OfflineDownload();
+
+    // The callback is invoked after each requested resource. Its last invocation reports the
+    // download as complete.
+    void start();
+
+    // Cancels the requests in flight. Calling start() again resumes the download.
+    void stop();
+
+    // The maximum number of requests in flight at any time.
+    void setConcurrentRequests(std::size_t count) { concurrentRequests = count; }
+
+    const OfflineProgress& getProgress() const { return progress; }
+
+private:
+    using Parse = std::function<void (const Response&)>;
+
+    void ensure(const Resource&, Parse = nullptr);
+    void requestNext();
+
+    void parseStyle(const std::string& data);
+    void addTiles(const SourceInfo&);
+    void addGlyphs(const std::string& glyphURL, const std::set<std::string>& fontStacks);
+    void addSprite(const std::string& spriteURL);
+
+    FileSource& fileSource;
+    uv_loop_t* const loop;
+    const OfflineRegion region;
+    const std::string progressPath;
+    const Callback callback;
+
+    struct Pending {
+        Resource resource;
+        Parse parse;
+    };
+
+    // Resources that still have to be requested, in the order they were discovered.
+    std::deque<Pending> queue;
+    std::set<Request*> requests;
+    std::size_t concurrentRequests = defaultConcurrentRequests;
+
+    // The URLs recorded in the progress file, and the file itself.
+    std::unordered_set<std::string> completed;
+    std::ofstream progressFile;
+
+    OfflineProgress progress;
+    bool running = false;
+};
+
+}
+
+#endif
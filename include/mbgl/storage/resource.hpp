@@ -14,7 +14,8 @@ struct Resource {
         Tile,
         Glyphs,
         JSON,
-        Image
+        Image,
+        Buckets // Parsed tile buckets, see FileSource::store()
     };
 
     const Kind kind;
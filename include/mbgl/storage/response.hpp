@@ -1,6 +1,8 @@
 #ifndef MBGL_STORAGE_RESPONSE
 #define MBGL_STORAGE_RESPONSE
 
+#include <mbgl/util/chrono.hpp>
+
 #include <string>
 
 namespace mbgl {
@@ -15,6 +17,26 @@ public:
     int64_t expires = 0;
     std::string etag;
     std::string data;
+
+    // The data as it was received, if it was gzip compressed for the transfer. File caches
+    // can store it as is instead of compressing the data again. Empty otherwise.
+    std::string encodedData;
+
+    // Whether the data was just downloaded. False for data that was read from a cache or a
+    // file, including cached data that the server confirmed to be unchanged.
+    bool downloaded = false;
+
+    // How long the phases of a network request took, each measured from the start of the
+    // request. Phases that didn't happen, e.g. because a connection was reused, are zero, as
+    // are all of them for responses that didn't come from the network.
+    struct Timing {
+        Duration nameLookup = Duration::zero();
+        Duration connect = Duration::zero();
+        Duration tlsHandshake = Duration::zero();
+        Duration firstByte = Duration::zero();
+    };
+
+    Timing timing;
 };
 
 }
@@ -3,6 +3,8 @@
 
 #include <mbgl/storage/file_cache.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 namespace mbgl {
@@ -19,10 +21,37 @@ public:
     // FileCache API
     void get(const Resource &resource, Callback callback) override;
     void put(const Resource &resource, std::shared_ptr<const Response> response, Hint hint) override;
+    void pin(const Resource&) override;
+    std::size_t getMemoryUsage() const override;
+    void releaseMemory() override;
+
+    // The maximum size of the database. When it is exceeded, the least recently used
+    // responses are evicted in the background, derived data and tiles before styles and
+    // sources. Pinned responses are never evicted. Defaults to util::maximumCacheSize.
+    void setMaximumSize(uint64_t bytes);
+
+    // The zlib level that responses are compressed with before they are stored. Defaults to
+    // util::fastCompression, since writes happen while tiles are loading; responses that were
+    // gzip encoded for the transfer are stored as they were received regardless.
+    void setCompressionLevel(int level);
+
+    // The size of the database file, and the total size of the responses that were evicted
+    // since the cache was created.
+    uint64_t getSize() const;
+    uint64_t getEvictedBytes() const;
 
     class Impl;
 
 private:
+    // Updated by the database thread after each operation, so that they can be read without
+    // waiting for queued operations.
+    struct Stats {
+        std::atomic<std::size_t> memoryUsage { 0 };
+        std::atomic<uint64_t> size { 0 };
+        std::atomic<uint64_t> evictedBytes { 0 };
+    };
+
+    Stats stats;
     const std::unique_ptr<util::Thread<Impl>> thread;
 };
 
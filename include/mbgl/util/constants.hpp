@@ -2,6 +2,7 @@
 #define MBGL_UTIL_CONSTANTS
 
 #include <cmath>
+#include <cstddef>
 #include <string>
 #include <vector>
 
@@ -11,6 +12,32 @@ namespace util {
 
 extern const float tileSize;
 
+// The default memory budget of the tile cache of each source.
+extern const size_t tileCacheBytes;
+
+// The default memory budget of the compressed tier of the tile cache of each source.
+extern const size_t compressedTileCacheBytes;
+
+// The default budget for the total memory usage of a map.
+extern const size_t memoryBudget;
+
+// The default maximum size of the SQLite file cache database.
+extern const size_t maximumCacheSize;
+
+// The default budget for prefetching the tiles of each source ahead of the map: the number of
+// requests in flight, and the bytes loaded while the map keeps moving.
+extern const size_t prefetchRequests;
+extern const size_t prefetchBytes;
+
+// Tiles are loaded and parsed in the order of their priority, lowest first. Visible tiles are
+// prioritized by their distance to the viewport center, in tiles, plus their distance from
+// the ideal zoom level, which stays below hiddenTilePriority. That is added to the priority of
+// tiles that aren't visible, i.e. fallback tiles that are only retained until the ideal tiles
+// are loaded, and tiles in the cache, so that they only compete among themselves. Prefetched
+// tiles start at prefetchTilePriority, after all of them.
+extern const double hiddenTilePriority;
+extern const double prefetchTilePriority;
+
 extern const double DEG2RAD;
 extern const double RAD2DEG;
 extern const double M2PI;
@@ -322,6 +322,7 @@ void HTTPRequest::handleResult(NSData *data, NSURLResponse *res, NSError *error)
             }
         } else if (responseCode == 200) {
             response->status = Response::Successful;
+            response->downloaded = true;
             status = ResponseStatus::Successful;
         } else if (responseCode >= 500 && responseCode < 600) {
             // Server errors may be temporary, so back off exponentially.
@@ -2,6 +2,7 @@
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/util/chrono.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include <mbgl/util/time.hpp>
@@ -67,6 +68,7 @@ public:
                                RequestBase::Callback,
                                uv_loop_t*,
                                std::shared_ptr<const Response>) override;
+    void setMaxConnections(std::size_t perHost, std::size_t total) override;
 
     static int handleSocket(CURL *handle, curl_socket_t s, int action, void *userp, void *socketp);
     static void perform(uv_poll_t *req, int status, int events);
@@ -83,6 +85,9 @@ public:
 
     uv_loop_t *loop = nullptr;
 
+    // Decodes gzip encoded responses of all requests, which run on the same thread.
+    util::Decompressor decompressor;
+
     // Used as the CURL timer function to periodically check for socket updates.
     uv_timer_t *timeout = nullptr;
 
@@ -90,9 +95,14 @@ public:
     // block and spawn threads.
     CURLM *multi = nullptr;
 
-    // CURL share handles are used for sharing session state (e.g.)
+    // CURL share handles are used for sharing session state (e.g. DNS lookups and TLS sessions)
+    // between the easy handles, so that new connections to a known host are faster.
     CURLSH *share = nullptr;
 
+    // Whether the cURL library supports HTTP/2. If it does, requests to the same host are
+    // multiplexed over one connection when the server supports it as well.
+    bool http2 = false;
+
     // A queue that we use for storing resuable CURL easy handles to avoid creating and destroying
     // them all the time.
     std::queue<CURL *> handles;
@@ -136,6 +146,10 @@ private:
     // In case of revalidation requests, this will store the old response.
     const std::shared_ptr<const Response> existingResponse;
 
+    // Whether the response was sent with a Content-Encoding of gzip. We decode it ourselves
+    // instead of letting curl do it, so that the encoded data can be cached as is.
+    bool gzipEncoded = false;
+
     CURL *handle = nullptr;
     curl_slist *headers = nullptr;
 
@@ -197,13 +211,25 @@ HTTPCURLContext::HTTPCURLContext(uv_loop_t *loop_)
     timeout->data = this;
     uv_timer_init(loop, timeout);
 
+    // All handles are used on this thread only, so the share handle doesn't need locking.
     share = curl_share_init();
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
 
     multi = curl_multi_init();
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETFUNCTION, handleSocket));
     handleError(curl_multi_setopt(multi, CURLMOPT_SOCKETDATA, this));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERFUNCTION, startTimeout));
     handleError(curl_multi_setopt(multi, CURLMOPT_TIMERDATA, this));
+
+#if LIBCURL_VERSION_NUM >= 0x072B00 // 7.43.0
+    if (curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2) {
+        http2 = true;
+        handleError(curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX));
+    }
+#endif
+
+    setMaxConnections(defaultMaxConnectionsPerHost, defaultMaxConnections);
 }
 
 HTTPCURLContext::~HTTPCURLContext() {
@@ -229,6 +255,17 @@ RequestBase* HTTPCURLContext::createRequest(const Resource& resource,
     return new HTTPRequest(this, resource, callback, loop_, response);
 }
 
+void HTTPCURLContext::setMaxConnections(std::size_t perHost, std::size_t total) {
+    MBGL_VERIFY_THREAD(tid);
+#if LIBCURL_VERSION_NUM >= 0x071E00 // 7.30.0
+    handleError(curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, long(perHost)));
+    handleError(curl_multi_setopt(multi, CURLMOPT_MAX_TOTAL_CONNECTIONS, long(total)));
+#else
+    (void)perHost;
+    (void)total;
+#endif
+}
+
 CURL *HTTPCURLContext::getHandle() {
     if (!handles.empty()) {
         auto handle = handles.front();
@@ -488,9 +525,18 @@ HTTPRequest::HTTPRequest(HTTPCURLContext* context_, const Resource& resource_, C
     handleError(curl_easy_setopt(handle, CURLOPT_WRITEDATA, this));
     handleError(curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, headerCallback));
     handleError(curl_easy_setopt(handle, CURLOPT_HEADERDATA, this));
-    handleError(curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip, deflate"));
+    handleError(curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "gzip"));
+    handleError(curl_easy_setopt(handle, CURLOPT_HTTP_CONTENT_DECODING, 0L));
     handleError(curl_easy_setopt(handle, CURLOPT_USERAGENT, "MapboxGL/1.0"));
     handleError(curl_easy_setopt(handle, CURLOPT_SHARE, context->share));
+#if LIBCURL_VERSION_NUM >= 0x072F00 // 7.47.0
+    if (context->http2) {
+        // Negotiates HTTP/2 for https:// URLs, and prefers to wait for a connection that can be
+        // multiplexed over opening a new one.
+        handleError(curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS));
+        handleError(curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L));
+    }
+#endif
 
     start();
 }
@@ -599,6 +645,11 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
     } else if ((begin = headerMatches("expires: ", buffer, length)) != std::string::npos) {
         const std::string value { buffer + begin, length - begin - 2 }; // remove \r\n
         baton->response->expires = curl_getdate(value.c_str(), nullptr);
+    } else if ((begin = headerMatches("content-encoding: ", buffer, length)) != std::string::npos) {
+        baton->gzipEncoded = headerMatches("gzip", buffer + begin, length - begin) != std::string::npos;
+    } else if (headerMatches("http/", buffer, length) != std::string::npos) {
+        // The status line of another response, e.g. after a redirect.
+        baton->gzipEncoded = false;
     }
 
     return length;
@@ -608,6 +659,7 @@ void HTTPRequest::retry(uint64_t timeout) {
     handleError(curl_multi_remove_handle(context->multi, handle));
 
     response.reset();
+    gzipEncoded = false;
 
     assert(!timer);
     timer = new uv_timer_t;
@@ -662,6 +714,19 @@ void HTTPRequest::finish(ResponseStatus status) {
     delete this;
 }
 
+namespace {
+
+// cURL reports the time from the start of a transfer to the end of each phase in seconds.
+Duration getDuration(CURL *handle, CURLINFO info) {
+    double seconds = 0;
+    if (curl_easy_getinfo(handle, info, &seconds) != CURLE_OK) {
+        return Duration::zero();
+    }
+    return std::chrono::duration_cast<Duration>(std::chrono::duration<double>(seconds));
+}
+
+}
+
 void HTTPRequest::handleResult(CURLcode code) {
     MBGL_VERIFY_THREAD(tid);
 
@@ -678,6 +743,11 @@ void HTTPRequest::handleResult(CURLcode code) {
         response = std::make_unique<Response>();
     }
 
+    response->timing.nameLookup = getDuration(handle, CURLINFO_NAMELOOKUP_TIME);
+    response->timing.connect = getDuration(handle, CURLINFO_CONNECT_TIME);
+    response->timing.tlsHandshake = getDuration(handle, CURLINFO_APPCONNECT_TIME);
+    response->timing.firstByte = getDuration(handle, CURLINFO_STARTTRANSFER_TIME);
+
     // Add human-readable error code
     if (code != CURLE_OK) {
         response->status = Response::Error;
@@ -715,7 +785,20 @@ void HTTPRequest::handleResult(CURLcode code) {
                 return finish(ResponseStatus::Successful);
             }
         } else if (responseCode == 200) {
+            if (gzipEncoded) {
+                response->encodedData = std::move(response->data);
+                try {
+                    response->data = context->decompressor.decompress(response->encodedData);
+                } catch (const std::runtime_error& ex) {
+                    response->status = Response::Error;
+                    response->message = std::string("Failed to decode response: ") + ex.what();
+                    response->data.clear();
+                    response->encodedData.clear();
+                    return finish(ResponseStatus::PermanentError);
+                }
+            }
             response->status = Response::Successful;
+            response->downloaded = true;
             return finish(ResponseStatus::Successful);
         } else if (responseCode >= 500 && responseCode < 600) {
             // Server errors may be temporary, so back off exponentially.
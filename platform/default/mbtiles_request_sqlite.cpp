@@ -0,0 +1,292 @@
+#include <mbgl/storage/mbtiles_context.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/thread.hpp>
+#include <mbgl/util/url.hpp>
+#include <mbgl/util/util.hpp>
+
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+#include "sqlite3.hpp"
+
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+namespace mbgl {
+
+namespace {
+
+const char* const scheme = "mbtiles://";
+
+// The tile address part of a tile URL, e.g. /14/8800/5373.pbf.
+struct TileAddress {
+    std::string path;
+    int64_t z = 0;
+    int64_t x = 0;
+    int64_t y = 0;
+};
+
+// Splits path/to/file.mbtiles/z/x/y[.ext] into the path of the file and the tile address.
+bool parseTileAddress(const std::string& location, TileAddress& address) {
+    std::string::size_type end = location.find_first_of("?#");
+    if (end == std::string::npos) {
+        end = location.size();
+    }
+
+    // The y coordinate may be followed by a file extension.
+    int64_t* const coordinates[] = { &address.y, &address.x, &address.z };
+    for (int64_t* coordinate : coordinates) {
+        const std::string::size_type slash = end > 0 ? location.rfind('/', end - 1) : std::string::npos;
+        if (slash == std::string::npos || slash == 0) {
+            return false;
+        }
+
+        const char* const begin = location.c_str() + slash + 1;
+        char* last = nullptr;
+        *coordinate = std::strtoll(begin, &last, 10);
+        const bool extension = coordinate == &address.y && *last == '.';
+        if (last == begin || !std::isdigit(*begin) || (last != location.c_str() + end && !extension)) {
+            return false;
+        }
+        end = slash;
+    }
+
+    address.path = location.substr(0, end);
+    return address.z >= 0 && address.z < 32 && address.x >= 0 && address.y >= 0 &&
+           address.x < (int64_t(1) << address.z) && address.y < (int64_t(1) << address.z);
+}
+
+// Parses a comma separated list of numbers from the metadata table.
+std::vector<double> parseNumbers(const std::string& value) {
+    std::vector<double> numbers;
+    std::istringstream stream(value);
+    std::string number;
+    while (std::getline(stream, number, ',')) {
+        numbers.push_back(std::strtod(number.c_str(), nullptr));
+    }
+    return numbers;
+}
+
+}
+
+// Reads tiles and metadata on a thread of the reader pool. Each reader has its own read-only
+// connection and prepared statements per file, which it keeps open for subsequent requests.
+class MBTilesReader {
+public:
+    MBTilesReader(uv_loop_t*) {}
+
+    std::unique_ptr<Response> read(const Resource&, const std::string& assetRoot);
+
+private:
+    struct File {
+        File(const std::string& path)
+            : db(path, mapbox::sqlite::ReadOnly),
+              tileStmt(db.prepare("SELECT `tile_data` FROM `tiles` "
+                                  "WHERE `zoom_level` = ? AND `tile_column` = ? AND `tile_row` = ?")) {
+        }
+
+        mapbox::sqlite::Database db;
+        mapbox::sqlite::Statement tileStmt;
+    };
+
+    File& open(const std::string& location, const std::string& assetRoot);
+    std::unique_ptr<Response> readTile(File&, const TileAddress&);
+    std::unique_ptr<Response> readTileJSON(File&, const std::string& url);
+
+    std::unordered_map<std::string, std::unique_ptr<File>> files;
+
+    // MBTiles files typically store vector tiles gzip compressed.
+    util::Decompressor decompressor;
+};
+
+MBTilesReader::File& MBTilesReader::open(const std::string& location, const std::string& assetRoot) {
+    std::string path = util::percentDecode(location);
+    if (path.empty() || path[0] != '/') {
+        // This is a relative path. Prefix with the application root.
+        path = assetRoot + "/" + path;
+    }
+
+    auto it = files.find(path);
+    if (it == files.end()) {
+        it = files.emplace(path, std::make_unique<File>(path)).first;
+    }
+    return *it->second;
+}
+
+std::unique_ptr<Response> MBTilesReader::read(const Resource& resource, const std::string& assetRoot) {
+    const std::string location = resource.url.substr(std::strlen(scheme));
+
+    try {
+        if (resource.kind == Resource::Kind::Source) {
+            return readTileJSON(open(location, assetRoot), resource.url);
+        }
+
+        TileAddress address;
+        if (!parseTileAddress(location, address)) {
+            auto response = std::make_unique<Response>();
+            response->message = "Invalid tile URL";
+            return response;
+        }
+        return readTile(open(address.path, assetRoot), address);
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+        auto response = std::make_unique<Response>();
+        response->message = ex.what();
+        return response;
+    } catch (std::runtime_error& ex) {
+        Log::Error(Event::Database, ex.what());
+        auto response = std::make_unique<Response>();
+        response->message = ex.what();
+        return response;
+    }
+}
+
+std::unique_ptr<Response> MBTilesReader::readTile(File& file, const TileAddress& address) {
+    auto response = std::make_unique<Response>();
+
+    // MBTiles rows are numbered from the bottom, like TMS.
+    file.tileStmt.bind(1 /* zoom_level */, address.z);
+    file.tileStmt.bind(2 /* tile_column */, address.x);
+    file.tileStmt.bind(3 /* tile_row */, (int64_t(1) << address.z) - 1 - address.y);
+
+    if (file.tileStmt.run()) {
+        response->status = Response::Successful;
+        response->data = file.tileStmt.get<std::string>(0);
+    } else {
+        response->message = "Tile not found";
+    }
+    file.tileStmt.reset();
+
+    if (util::isGzip(response->data)) {
+        response->data = decompressor.decompress(response->data);
+    }
+
+    return response;
+}
+
+std::unique_ptr<Response> MBTilesReader::readTileJSON(File& file, const std::string& url) {
+    std::unordered_map<std::string, std::string> metadata;
+    mapbox::sqlite::Statement stmt = file.db.prepare("SELECT `name`, `value` FROM `metadata`");
+    while (stmt.run()) {
+        metadata.emplace(stmt.get<std::string>(0), stmt.get<std::string>(1));
+    }
+
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartObject();
+
+    writer.String("tilejson");
+    writer.String("2.1.0");
+    writer.String("tiles");
+    writer.StartArray();
+    writer.String((url + "/{z}/{x}/{y}").c_str());
+    writer.EndArray();
+
+    for (const char* key : { "name", "attribution" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end()) {
+            writer.String(key);
+            writer.String(it->second.c_str());
+        }
+    }
+
+    for (const char* key : { "minzoom", "maxzoom" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end()) {
+            writer.String(key);
+            writer.Uint(unsigned(std::strtoul(it->second.c_str(), nullptr, 10)));
+        }
+    }
+
+    for (const char* key : { "bounds", "center" }) {
+        auto it = metadata.find(key);
+        if (it != metadata.end()) {
+            writer.String(key);
+            writer.StartArray();
+            for (double number : parseNumbers(it->second)) {
+                writer.Double(number);
+            }
+            writer.EndArray();
+        }
+    }
+
+    writer.EndObject();
+
+    auto response = std::make_unique<Response>();
+    response->status = Response::Successful;
+    response->data = { buffer.GetString(), buffer.Size() };
+    return response;
+}
+
+class MBTilesRequest : public RequestBase {
+    MBGL_STORE_THREAD(tid)
+
+public:
+    MBTilesRequest(const Resource& resource_, Callback callback_)
+        : RequestBase(resource_, callback_) {}
+
+    ~MBTilesRequest() {
+        MBGL_VERIFY_THREAD(tid);
+    }
+
+    // The read can't be interrupted once it was queued, so the request deletes itself
+    // when it completes, and only notifies if it wasn't canceled in the meantime.
+    void cancel() override {
+        canceled = true;
+    }
+
+    void finish(std::unique_ptr<Response> response) {
+        MBGL_VERIFY_THREAD(tid);
+        if (!canceled) {
+            notify(std::move(response), FileCache::Hint::No);
+        }
+        delete this;
+    }
+
+private:
+    bool canceled = false;
+};
+
+class MBTilesSQLiteContext : public MBTilesContext {
+public:
+    // Reads are short, so a couple of threads suffice to keep a tile set on flash storage busy.
+    static const std::size_t readerCount = 2;
+
+    MBTilesSQLiteContext() {
+        for (std::size_t i = 0; i < readerCount; i++) {
+            readers.emplace_back(std::make_unique<util::Thread<MBTilesReader>>("MBTiles", util::ThreadPriority::Low));
+        }
+    }
+
+    RequestBase* createRequest(const Resource& resource,
+                               RequestBase::Callback callback,
+                               const std::string& assetRoot) override {
+        auto request = new MBTilesRequest(resource, callback);
+
+        // Every reader can serve every file, so reads are distributed in round-robin order.
+        readers[current]->invokeWithResult(&MBTilesReader::read,
+            std::function<void (std::unique_ptr<Response>)>([request] (std::unique_ptr<Response> response) {
+                request->finish(std::move(response));
+            }), resource, assetRoot);
+        current = (current + 1) % readers.size();
+
+        return request;
+    }
+
+private:
+    std::vector<std::unique_ptr<util::Thread<MBTilesReader>>> readers;
+    std::size_t current = 0;
+};
+
+std::unique_ptr<MBTilesContext> MBTilesContext::createContext(uv_loop_t*) {
+    return std::make_unique<MBTilesSQLiteContext>();
+}
+
+}
@@ -68,6 +68,31 @@ Statement Database::prepare(const char *query) {
     return std::move(Statement(db, query));
 }
 
+bool Database::inTransaction() const {
+    assert(db);
+    return !sqlite3_get_autocommit(db);
+}
+
+bool Database::hasMoved() const {
+    assert(db);
+    int moved = 0;
+    sqlite3_file_control(db, "main", SQLITE_FCNTL_HAS_MOVED, &moved);
+    return moved;
+}
+
+size_t Database::getMemoryUsage() const {
+    assert(db);
+    int current = 0;
+    int highwater = 0;
+    sqlite3_db_status(db, SQLITE_DBSTATUS_CACHE_USED, &current, &highwater, 0);
+    return current;
+}
+
+void Database::releaseMemory() {
+    assert(db);
+    sqlite3_db_release_memory(db);
+}
+
 Statement::Statement(sqlite3 *db, const char *sql) {
     const int err = sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr);
     if (err != SQLITE_OK) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
 #include <stdexcept>
 
@@ -42,6 +43,19 @@ public:
     void exec(const std::string &sql);
     Statement prepare(const char *query);
 
+    // Whether a transaction was started with BEGIN and is still open.
+    bool inTransaction() const;
+
+    // Whether the database file was deleted or renamed since it was opened.
+    bool hasMoved() const;
+
+    // The memory used by the page cache of this connection. For in-memory databases,
+    // this includes all of the data.
+    size_t getMemoryUsage() const;
+
+    // Frees as much of the page cache as possible.
+    void releaseMemory();
+
 private:
     sqlite3 *db = nullptr;
 };
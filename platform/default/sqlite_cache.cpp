@@ -2,9 +2,12 @@
 #include <mbgl/storage/request.hpp>
 #include <mbgl/storage/response.hpp>
 
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/compression.hpp>
+#include <mbgl/util/constants.hpp>
 #include <mbgl/util/io.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/uv_detail.hpp>
 #include <mbgl/platform/log.hpp>
 
 #include "sqlite3.hpp"
@@ -61,23 +64,43 @@ std::string unifyMapboxURLs(const std::string &url) {
 
 using namespace mapbox::sqlite;
 
+namespace {
+
+int64_t now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(SystemClock::now().time_since_epoch()).count();
+}
+
+}
+
 SQLiteCache::SQLiteCache(const std::string& path_)
-    : thread(std::make_unique<util::Thread<Impl>>("SQLite Cache", util::ThreadPriority::Low, path_)) {
+    : thread(std::make_unique<util::Thread<Impl>>("SQLite Cache", util::ThreadPriority::Low, path_, &stats)) {
 }
 
 SQLiteCache::~SQLiteCache() = default;
 
-SQLiteCache::Impl::Impl(uv_loop_t*, const std::string& path_)
-    : path(path_) {
+SQLiteCache::Impl::Impl(uv_loop_t* loop, const std::string& path_, SQLiteCache::Stats* stats_)
+    : path(path_),
+      stats(stats_),
+      flushTimer(loop ? std::make_unique<uv::timer>(loop) : nullptr),
+      vacuumTimer(loop ? std::make_unique<uv::timer>(loop) : nullptr),
+      maximumSize(util::maximumCacheSize) {
 }
 
 SQLiteCache::Impl::~Impl() {
+    flush();
+
     // Deleting these SQLite objects may result in exceptions, but we're in a destructor, so we
     // can't throw anything.
     try {
         getStmt.reset();
         putStmt.reset();
         refreshStmt.reset();
+        pinStmt.reset();
+        accessStmt.reset();
+        evictSelectStmt.reset();
+        evictDeleteStmt.reset();
+        pageCountStmt.reset();
+        freelistCountStmt.reset();
         db.reset();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
@@ -89,7 +112,10 @@ void SQLiteCache::Impl::createDatabase() {
 }
 
 void SQLiteCache::Impl::createSchema() {
+    // Incremental vacuum lets eviction return space to the file system without rewriting
+    // the whole database. It only has an effect before the first table is created.
     constexpr const char *const sql = ""
+        "PRAGMA auto_vacuum = INCREMENTAL;"
         "CREATE TABLE IF NOT EXISTS `http_cache` ("
         "    `url` TEXT PRIMARY KEY NOT NULL,"
         "    `status` INTEGER NOT NULL," // The response status (Successful or Error).
@@ -98,9 +124,15 @@ void SQLiteCache::Impl::createSchema() {
         "    `etag` TEXT,"
         "    `expires` INTEGER," // Timestamp when the server says the file expires.
         "    `data` BLOB,"
-        "    `compressed` INTEGER NOT NULL DEFAULT 0" // Whether the data is compressed.
+        "    `compressed` INTEGER NOT NULL DEFAULT 0," // Whether the data is compressed.
+        "    `accessed` INTEGER NOT NULL DEFAULT 0," // Timestamp when the file was last used.
+        "    `pinned` INTEGER NOT NULL DEFAULT 0" // Whether the file must not be evicted.
         ");"
-        "CREATE INDEX IF NOT EXISTS `http_cache_kind_idx` ON `http_cache` (`kind`);";
+        "CREATE INDEX IF NOT EXISTS `http_cache_kind_idx` ON `http_cache` (`kind`);"
+        // Fail for tables created before `accessed` or `pinned` were added, which are dropped
+        // below.
+        "CREATE INDEX IF NOT EXISTS `http_cache_accessed_idx` ON `http_cache` (`accessed`);"
+        "SELECT `pinned` FROM `http_cache` LIMIT 0;";
 
     try {
         db->exec(sql);
@@ -124,6 +156,52 @@ void SQLiteCache::Impl::createSchema() {
         db->exec("DROP TABLE IF EXISTS `http_cache`");
         db->exec(sql);
     }
+
+    // In WAL mode, commits only append to the log, and readers don't block the writer or
+    // vice versa. Syncing at checkpoints only is enough for a cache: a power loss can't
+    // corrupt the database, it can only lose the last few writes. The journal mode is
+    // stored in the database file, so this only has an effect on first use.
+    try {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+
+        // Databases that were created without incremental vacuum must be rebuilt once, but
+        // only when the cache is idle (see deferVacuum()). Until then, eviction still deletes
+        // responses, it just doesn't shrink the file.
+        if (pragma("auto_vacuum") != 2 /* INCREMENTAL */ && !db->inTransaction()) {
+            db->exec("PRAGMA auto_vacuum = INCREMENTAL");
+            vacuumPending = bool(vacuumTimer);
+        }
+
+        lastUsedSize = usedSize();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Warning(Event::Database, ex.code, ex.what());
+    }
+}
+
+int64_t SQLiteCache::Impl::pragma(const char* name) {
+    Statement stmt = db->prepare((std::string("PRAGMA ") + name).c_str());
+    return stmt.run() ? stmt.get<int64_t>(0) : 0;
+}
+
+int64_t SQLiteCache::Impl::pragma(std::unique_ptr<Statement>& stmt, const char* name) {
+    if (!stmt) {
+        stmt = std::make_unique<Statement>(db->prepare((std::string("PRAGMA ") + name).c_str()));
+    } else {
+        stmt->reset();
+    }
+
+    const int64_t value = stmt->run() ? stmt->get<int64_t>(0) : 0;
+    stmt->reset();
+    return value;
+}
+
+uint64_t SQLiteCache::Impl::usedSize() {
+    if (!pageSize) {
+        pageSize = pragma("page_size");
+    }
+    return uint64_t(pragma(pageCountStmt, "page_count") -
+                    pragma(freelistCountStmt, "freelist_count")) * pageSize;
 }
 
 void SQLiteCache::get(const Resource &resource, Callback callback) {
@@ -145,6 +223,8 @@ std::unique_ptr<Response> SQLiteCache::Impl::get(const Resource &resource) {
             createSchema();
         }
 
+        deferVacuum();
+
         if (!getStmt) {
             // Initialize the statement                                  0         1
             getStmt = std::make_unique<Statement>(db->prepare("SELECT `status`, `modified`, "
@@ -156,7 +236,9 @@ std::unique_ptr<Response> SQLiteCache::Impl::get(const Resource &resource) {
 
         const std::string unifiedURL = unifyMapboxURLs(resource.url);
         getStmt->bind(1, unifiedURL.c_str());
-        if (getStmt->run()) {
+        const bool found = getStmt->run();
+        updateStats();
+        if (found) {
             // There is data.
             auto response = std::make_unique<Response>();
             response->status = Response::Status(getStmt->get<int>(0));
@@ -164,8 +246,20 @@ std::unique_ptr<Response> SQLiteCache::Impl::get(const Resource &resource) {
             response->etag = getStmt->get<std::string>(2);
             response->expires = getStmt->get<int64_t>(3);
             response->data = getStmt->get<std::string>(4);
-            if (getStmt->get<int>(5)) { // == compressed
-                response->data = util::decompress(response->data);
+            const bool compressed = getStmt->get<int>(5);
+
+            // Don't keep the read transaction open, which would block WAL checkpoints.
+            getStmt->reset();
+
+            accesses[unifiedURL] = now();
+            if (accesses.size() >= maxBatchSize) {
+                flush();
+            } else if (flushTimer && batchSize == 0 && accesses.size() == 1) {
+                flushTimer->start(batchInterval, 0, [this] { flush(); });
+            }
+
+            if (compressed) {
+                response->data = decompressor.decompress(response->data);
             }
             return std::move(response);
         } else {
@@ -199,15 +293,21 @@ void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Resp
             createSchema();
         }
 
+        deferVacuum();
+
         if (!putStmt) {
+            // Responses that replace a pinned response stay pinned.
             putStmt = std::make_unique<Statement>(db->prepare("REPLACE INTO `http_cache` ("
-            //     1       2       3         4         5         6        7          8
-                "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`"
-                ") VALUES(?, ?, ?, ?, ?, ?, ?, ?)"));
+            //     1       2       3         4         5         6        7          8             9
+                "`url`, `status`, `kind`, `modified`, `etag`, `expires`, `data`, `compressed`, `accessed`, "
+                "`pinned`) VALUES(?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, "
+                "COALESCE((SELECT `pinned` FROM `http_cache` WHERE `url` = ?1), 0))"));
         } else {
             putStmt->reset();
         }
 
+        beginWrite();
+
         const std::string unifiedURL = unifyMapboxURLs(resource.url);
         putStmt->bind(1 /* url */, unifiedURL.c_str());
         putStmt->bind(2 /* status */, int(response->status));
@@ -217,12 +317,16 @@ void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Resp
         putStmt->bind(6 /* expires */, response->expires);
 
         std::string data;
-        if (resource.kind != Resource::Image) {
+        if (!response->encodedData.empty()) {
+            // The response was gzip encoded for the transfer already.
+            data = response->encodedData;
+        } else if (resource.kind != Resource::Image) {
             // Do not compress images, since they are typically compressed already.
-            data = util::compress(response->data);
+            data = compressor.compress(response->data);
         }
 
-        if (!data.empty() && data.size() < response->data.size()) {
+        const bool compressed = !data.empty() && data.size() < response->data.size();
+        if (compressed) {
             // Store the compressed data when it is smaller than the original
             // uncompressed data.
             putStmt->bind(7 /* data */, data, false); // do not retain the string internally.
@@ -232,9 +336,18 @@ void SQLiteCache::Impl::put(const Resource& resource, std::shared_ptr<const Resp
             putStmt->bind(8 /* compressed */, false);
         }
 
+        putStmt->bind(9 /* accessed */, now());
+
         putStmt->run();
+        writtenBytes += unifiedURL.size() + (compressed ? data.size() : response->data.size());
+        endWrite();
+        updateStats();
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
+        if (batchSize == 0) {
+            // Don't leave a transaction without successful writes open.
+            flush();
+        }
     }
 }
 
@@ -248,6 +361,8 @@ void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
             createSchema();
         }
 
+        deferVacuum();
+
         if (!refreshStmt) {
             refreshStmt = std::make_unique<Statement>( //        1               2
                 db->prepare("UPDATE `http_cache` SET `expires` = ? WHERE `url` = ?"));
@@ -255,12 +370,304 @@ void SQLiteCache::Impl::refresh(const Resource& resource, int64_t expires) {
             refreshStmt->reset();
         }
 
+        beginWrite();
+
         const std::string unifiedURL = unifyMapboxURLs(resource.url);
         refreshStmt->bind(1, int64_t(expires));
         refreshStmt->bind(2, unifiedURL.c_str());
         refreshStmt->run();
+        endWrite();
+        updateStats();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+        if (batchSize == 0) {
+            // Don't leave a transaction without successful writes open.
+            flush();
+        }
+    }
+}
+
+void SQLiteCache::pin(const Resource& resource) {
+    thread->invoke(&Impl::pin, resource);
+}
+
+void SQLiteCache::Impl::pin(const Resource& resource) {
+    try {
+        if (!db) {
+            createDatabase();
+        }
+
+        if (!schema) {
+            createSchema();
+        }
+
+        deferVacuum();
+
+        if (!pinStmt) {
+            pinStmt = std::make_unique<Statement>( //                        1
+                db->prepare("UPDATE `http_cache` SET `pinned` = 1 WHERE `url` = ?"));
+        } else {
+            pinStmt->reset();
+        }
+
+        beginWrite();
+
+        const std::string unifiedURL = unifyMapboxURLs(resource.url);
+        pinStmt->bind(1, unifiedURL.c_str());
+        pinStmt->run();
+        endWrite();
+        updateStats();
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+        if (batchSize == 0) {
+            // Don't leave a transaction without successful writes open.
+            flush();
+        }
+    }
+}
+
+void SQLiteCache::Impl::beginWrite() {
+    if (db->hasMoved()) {
+        // Other journal modes refuse to write to a deleted database, but in WAL mode, the
+        // writes would silently go to the deleted file.
+        throw mapbox::sqlite::Exception { SQLITE_READONLY, sqlite3_errstr(SQLITE_READONLY) };
+    }
+
+    if (flushTimer && !db->inTransaction()) {
+        db->exec("BEGIN");
+    }
+}
+
+void SQLiteCache::Impl::endWrite() {
+    if (!flushTimer || ++batchSize >= maxBatchSize) {
+        flush();
+    } else if (batchSize == 1) {
+        flushTimer->start(batchInterval, 0, [this] { flush(); });
+    }
+}
+
+void SQLiteCache::Impl::flush() {
+    // The timer isn't stopped when a full batch is flushed early, but it is restarted by the
+    // first write of the next batch, and flushing without a pending batch does nothing.
+    batchSize = 0;
+
+    if (!db) {
+        return;
+    }
+
+    try {
+        writeAccesses();
+        if (db->inTransaction()) {
+            db->exec("COMMIT");
+        }
+    } catch (mapbox::sqlite::Exception& ex) {
+        Log::Error(Event::Database, ex.code, ex.what());
+        try {
+            // The batch is lost, but it's only a cache.
+            if (db->inTransaction()) {
+                db->exec("ROLLBACK");
+            }
+        } catch (mapbox::sqlite::Exception&) {
+        }
+    }
+
+    if (evictionPending || (writtenBytes > 0 && lastUsedSize + writtenBytes > maximumSize)) {
+        evict();
+    } else if (stats) {
+        try {
+            stats->size = getSize();
+        } catch (mapbox::sqlite::Exception& ex) {
+            Log::Error(Event::Database, ex.code, ex.what());
+        }
+    }
+}
+
+void SQLiteCache::Impl::writeAccesses() {
+    if (accesses.empty() || db->hasMoved()) {
+        // A deleted database would refuse the writes anyway.
+        accesses.clear();
+        return;
+    }
+
+    if (!accessStmt) {
+        accessStmt = std::make_unique<Statement>( //          1                2
+            db->prepare("UPDATE `http_cache` SET `accessed` = ? WHERE `url` = ?"));
+    }
+
+    if (!db->inTransaction()) {
+        db->exec("BEGIN");
+    }
+
+    // Take the accesses first, so that they aren't retried forever if the writes fail.
+    const auto pending = std::move(accesses);
+    accesses.clear();
+    for (const auto& access : pending) {
+        accessStmt->reset();
+        accessStmt->bind(1, access.second);
+        accessStmt->bind(2, access.first.c_str());
+        accessStmt->run();
+    }
+}
+
+void SQLiteCache::Impl::evict() {
+    if (!schema || db->inTransaction() || db->hasMoved()) {
+        return;
+    }
+
+    try {
+        if (!evictSelectStmt) {
+            // Derived data is evicted first, and styles and sources last, since a style
+            // without its tiles is still more useful than tiles without their style. Pinned
+            // responses are never evicted.
+            const std::string sql = "SELECT `url`, LENGTH(`data`) FROM `http_cache` WHERE `pinned` = 0 ORDER BY "
+                "CASE `kind` WHEN " + std::to_string(Resource::Buckets) + " THEN 0 "
+                            "WHEN " + std::to_string(Resource::Style) + " THEN 2 "
+                            "WHEN " + std::to_string(Resource::Source) + " THEN 2 "
+                            "ELSE 1 END, "
+                "`accessed`, `rowid` LIMIT ?";
+            evictSelectStmt = std::make_unique<Statement>(db->prepare(sql.c_str()));
+            evictDeleteStmt = std::make_unique<Statement>(
+                db->prepare("DELETE FROM `http_cache` WHERE `url` = ?"));
+        }
+
+        // Each step only deletes a few rows, so that requests don't wait long behind eviction.
+        // If the database is still too large afterwards, eviction continues later.
+        std::size_t steps = 0;
+        uint64_t size = usedSize();
+        for (; steps < maxEvictionSteps && size > maximumSize; steps++) {
+            std::vector<std::string> urls;
+            uint64_t bytes = 0;
+            evictSelectStmt->reset();
+            evictSelectStmt->bind(1, int64_t(evictionStepSize));
+            while (bytes < size - maximumSize && evictSelectStmt->run()) {
+                urls.push_back(evictSelectStmt->get<std::string>(0));
+                bytes += evictSelectStmt->get<int64_t>(1);
+            }
+            evictSelectStmt->reset();
+
+            if (urls.empty()) {
+                break;
+            }
+
+            db->exec("BEGIN");
+            for (const auto& url : urls) {
+                evictDeleteStmt->reset();
+                evictDeleteStmt->bind(1, url.c_str());
+                evictDeleteStmt->run();
+            }
+            db->exec("COMMIT");
+            evictedBytes += bytes;
+
+            size = usedSize();
+        }
+
+        if (steps > 0) {
+            db->exec("PRAGMA incremental_vacuum");
+        }
+
+        lastUsedSize = size;
+        writtenBytes = 0;
+        evictionPending = steps == maxEvictionSteps && size > maximumSize;
+        if (flushTimer && evictionPending) {
+            flushTimer->start(batchInterval, 0, [this] { flush(); });
+        }
+
+        if (stats) {
+            stats->size = getSize();
+        }
     } catch (mapbox::sqlite::Exception& ex) {
         Log::Error(Event::Database, ex.code, ex.what());
+        try {
+            if (db->inTransaction()) {
+                db->exec("ROLLBACK");
+            }
+        } catch (mapbox::sqlite::Exception&) {
+        }
+    }
+
+    updateStats();
+}
+
+void SQLiteCache::Impl::deferVacuum() {
+    if (vacuumPending) {
+        // Restarting the timer postpones the vacuum until requests stop for a while.
+        vacuumTimer->start(vacuumIdleInterval, 0, [this] { vacuum(); });
+    }
+}
+
+void SQLiteCache::Impl::vacuum() {
+    // Commits the pending batch, since a vacuum can't run in a transaction.
+    flush();
+
+    if (!vacuumPending || db->inTransaction() || db->hasMoved()) {
+        return;
+    }
+
+    try {
+        db->exec("VACUUM");
+        vacuumPending = false;
+        lastUsedSize = usedSize();
+        if (stats) {
+            stats->size = getSize();
+        }
+    } catch (mapbox::sqlite::Exception& ex) {
+        // Tried again after the next idle period.
+        Log::Warning(Event::Database, ex.code, ex.what());
+    }
+}
+
+void SQLiteCache::setMaximumSize(uint64_t bytes) {
+    thread->invoke(&Impl::setMaximumSize, bytes);
+}
+
+void SQLiteCache::setCompressionLevel(int level) {
+    thread->invoke(&Impl::setCompressionLevel, level);
+}
+
+void SQLiteCache::Impl::setMaximumSize(uint64_t bytes) {
+    maximumSize = bytes;
+    if (db && batchSize == 0) {
+        evict();
+    }
+}
+
+uint64_t SQLiteCache::getSize() const {
+    return stats.size;
+}
+
+uint64_t SQLiteCache::Impl::getSize() {
+    if (!db || !schema) {
+        return 0;
+    }
+    if (!pageSize) {
+        pageSize = pragma("page_size");
+    }
+    return uint64_t(pragma(pageCountStmt, "page_count")) * pageSize;
+}
+
+uint64_t SQLiteCache::getEvictedBytes() const {
+    return stats.evictedBytes;
+}
+
+std::size_t SQLiteCache::getMemoryUsage() const {
+    return stats.memoryUsage;
+}
+
+void SQLiteCache::releaseMemory() {
+    thread->invoke(&Impl::releaseMemory);
+}
+
+void SQLiteCache::Impl::releaseMemory() {
+    if (db) {
+        db->releaseMemory();
+        updateStats();
+    }
+}
+
+void SQLiteCache::Impl::updateStats() {
+    if (stats && db) {
+        stats->memoryUsage = db->getMemoryUsage();
+        stats->evictedBytes = evictedBytes;
     }
 }
 
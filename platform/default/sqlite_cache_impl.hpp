@@ -2,9 +2,16 @@
 #define MBGL_STORAGE_DEFAULT_SQLITE_CACHE_IMPL
 
 #include <mbgl/storage/sqlite_cache.hpp>
+#include <mbgl/util/compression.hpp>
+
+#include <unordered_map>
 
 typedef struct uv_loop_s uv_loop_t;
 
+namespace uv {
+class timer;
+}
+
 namespace mapbox {
 namespace sqlite {
 class Database;
@@ -14,25 +21,96 @@ class Statement;
 
 namespace mbgl {
 
+// Writes are batched into transactions that are committed after maxBatchSize writes, or
+// batchInterval after the first write of the batch, so that a burst of responses doesn't
+// turn into one synced transaction each. Reads on this connection see the pending writes,
+// and since the database is in WAL mode, other connections can read while a batch is open.
+// Without a loop to run the timer on, every write is committed immediately.
+//
+// Hits update the `accessed` time of responses, but only when the next batch is committed.
+// When a commit contains writes that could have grown the database beyond its maximum size,
+// the least recently used responses are evicted in small steps until it is below that size
+// again, and the freed pages are returned to the file system with an incremental vacuum.
 class SQLiteCache::Impl {
 public:
-    Impl(uv_loop_t*, const std::string &path = ":memory:");
+    static const std::size_t maxBatchSize = 64;
+    static const uint64_t batchInterval = 250; // ms
+    static const std::size_t evictionStepSize = 32;
+    static const std::size_t maxEvictionSteps = 8;
+    static const uint64_t vacuumIdleInterval = 5000; // ms
+
+    Impl(uv_loop_t*, const std::string &path = ":memory:", SQLiteCache::Stats* stats = nullptr);
     ~Impl();
 
     std::unique_ptr<Response> get(const Resource&);
     void put(const Resource& resource, std::shared_ptr<const Response> response);
     void refresh(const Resource& resource, int64_t expires);
+    void pin(const Resource& resource);
+    void releaseMemory();
+
+    // Commits the pending batch of writes, if any, and evicts responses if the database is
+    // too large.
+    void flush();
+
+    void setMaximumSize(uint64_t bytes);
+    void setCompressionLevel(int level) { compressor.setLevel(level); }
+    uint64_t getSize();
+    uint64_t getEvictedBytes() const { return evictedBytes; }
 
 private:
     void createDatabase();
     void createSchema();
+    void updateStats();
+
+    void beginWrite();
+    void endWrite();
+    void writeAccesses();
+    void evict();
+    void deferVacuum();
+    void vacuum();
+    int64_t pragma(const char* name);
+    int64_t pragma(std::unique_ptr<::mapbox::sqlite::Statement>&, const char* name);
+    uint64_t usedSize();
 
     const std::string path;
+    SQLiteCache::Stats* const stats;
     std::unique_ptr<::mapbox::sqlite::Database> db;
     std::unique_ptr<::mapbox::sqlite::Statement> getStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> putStmt;
     std::unique_ptr<::mapbox::sqlite::Statement> refreshStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> pinStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> accessStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> evictSelectStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> evictDeleteStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> pageCountStmt;
+    std::unique_ptr<::mapbox::sqlite::Statement> freelistCountStmt;
+    int64_t pageSize = 0;
     bool schema = false;
+
+    const std::unique_ptr<uv::timer> flushTimer;
+    std::size_t batchSize = 0;
+
+    // Databases that were created without incremental vacuum have to be rebuilt once. This
+    // rewrites the whole file, so it waits until there were no reads or writes for a while.
+    const std::unique_ptr<uv::timer> vacuumTimer;
+    bool vacuumPending = false;
+
+    // The accessed times of responses that were hit since the last commit, by URL.
+    std::unordered_map<std::string, int64_t> accesses;
+
+    uint64_t maximumSize;
+    uint64_t evictedBytes = 0;
+
+    // The used size of the database when eviction last ran, and the bytes written since, so
+    // that eviction only runs when the database could be too large. It also continues when
+    // it stopped after maxEvictionSteps.
+    uint64_t lastUsedSize = 0;
+    uint64_t writtenBytes = 0;
+    bool evictionPending = false;
+
+    // Reused for all responses, so that the zlib state isn't allocated for each of them.
+    util::Compressor compressor { util::fastCompression };
+    util::Decompressor decompressor;
 };
 
 
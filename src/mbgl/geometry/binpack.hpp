@@ -3,6 +3,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/rect.hpp>
+#include <algorithm>
 #include <cstdint>
 #include <list>
 
@@ -95,6 +96,53 @@ public:
         free.emplace_back(rect);
     };
 
+    // Rebuilds the free list around the rects that are still in use. release() only merges a
+    // cell with a neighbor of the same size, so after many allocations and releases, the free
+    // space is split into many small cells that can't hold larger rects even though there is
+    // enough room. Rebuilding it yields fewer, larger cells. The used rects must not overlap.
+    template <typename Rects>
+    void repack(T width, T height, const Rects& used) {
+        free.assign(1, Rect<T>{ 0, 0, width, height });
+        for (const Rect<T>& rect : used) {
+            for (auto it = free.begin(); it != free.end();) {
+                const Rect<T> ref = *it;
+                if (rect.x >= ref.x + ref.w || ref.x >= rect.x + rect.w ||
+                    rect.y >= ref.y + ref.h || ref.y >= rect.y + rect.h) {
+                    ++it;
+                    continue;
+                }
+
+                // Split the cell into full-width rows above and below the used rect, and the
+                // parts to its left and right in between.
+                // +------+
+                // |______|  <-- above
+                // |_|##|_|  <-- left, right
+                // |      |  <-- below
+                // +------+
+                it = free.erase(it);
+                const T top = std::max(ref.y, rect.y);
+                const T bottom = std::min(ref.y + ref.h, rect.y + rect.h);
+                if (rect.y > ref.y) free.emplace_front(ref.x, ref.y, ref.w, rect.y - ref.y);
+                if (ref.y + ref.h > rect.y + rect.h) free.emplace_front(ref.x, rect.y + rect.h, ref.w, ref.y + ref.h - (rect.y + rect.h));
+                if (rect.x > ref.x) free.emplace_front(ref.x, top, rect.x - ref.x, bottom - top);
+                if (ref.x + ref.w > rect.x + rect.w) free.emplace_front(rect.x + rect.w, top, ref.x + ref.w - (rect.x + rect.w), bottom - top);
+            }
+        }
+    }
+
+    // How scattered the free space is: 0 when it is a single cell (or there is none), and
+    // close to 1 when the largest cell is only a small part of it.
+    float fragmentation() const {
+        std::size_t total = 0;
+        std::size_t largest = 0;
+        for (const Rect<T>& ref : free) {
+            const std::size_t area = std::size_t(ref.w) * ref.h;
+            total += area;
+            largest = std::max(largest, area);
+        }
+        return total ? 1.0f - float(largest) / total : 0.0f;
+    }
+
 private:
     std::list<Rect<T>> free;
 };
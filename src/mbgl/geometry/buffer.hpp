@@ -7,6 +7,7 @@
 #include <mbgl/map/environment.hpp>
 
 #include <cstdlib>
+#include <cstring>
 #include <cassert>
 #include <stdexcept>
 
@@ -38,6 +39,37 @@ public:
         return pos == 0;
     }
 
+    // Returns the number of bytes of the elements in this buffer, which stays the same
+    // after the buffer was transferred to the GPU.
+    inline size_t bytes() const {
+        return pos;
+    }
+
+    // Returns the elements, e.g. for copying them elsewhere. The elements are gone once
+    // the buffer was transferred to the GPU, unless they are retained after upload.
+    inline const void *data() const {
+        return array;
+    }
+
+    // Appends elements that were copied from a buffer of the same type.
+    void append(const void *data, size_t size) {
+        if (buffer != 0) {
+            throw std::runtime_error("Can't add elements after buffer was bound to GPU");
+        }
+        if (size % itemSize != 0) {
+            throw std::runtime_error("Can't append partial elements");
+        }
+        if (length < pos + size) {
+            while (length < pos + size) length += defaultLength;
+            array = realloc(array, length);
+            if (array == nullptr) {
+                throw std::runtime_error("Buffer reallocation failed");
+            }
+        }
+        std::memcpy(reinterpret_cast<char *>(array) + pos, data, size);
+        pos += size;
+    }
+
     // Transfers this buffer to the GPU and binds the buffer to the GL context.
     void bind() {
         if (buffer) {
@@ -0,0 +1,83 @@
+#ifndef MBGL_GEOMETRY_DIRTY_RECTS
+#define MBGL_GEOMETRY_DIRTY_RECTS
+
+#include <mbgl/util/rect.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// Collects the regions of an atlas that changed since it was last uploaded, so that only those
+// regions need to be sent to the GPU. Rects that are close to each other are coalesced into
+// their bounding box, since a few larger uploads are cheaper than many tiny ones.
+template <typename T>
+class DirtyRects {
+public:
+    // Once there are more rects than this, they are collapsed into their bounding box.
+    static const std::size_t maxRects = 16;
+
+    void add(Rect<T> rect) {
+        if (!rect.hasArea()) {
+            return;
+        }
+
+        // Merging may produce a rect that can absorb others that it didn't touch before, so
+        // keep going until nothing changes.
+        for (auto it = rects.begin(); it != rects.end();) {
+            if (shouldMerge(*it, rect)) {
+                rect = bounds(*it, rect);
+                rects.erase(it);
+                it = rects.begin();
+            } else {
+                ++it;
+            }
+        }
+
+        rects.push_back(rect);
+
+        if (rects.size() > maxRects) {
+            Rect<T> all = rects.front();
+            for (const auto& r : rects) {
+                all = bounds(all, r);
+            }
+            rects.assign(1, all);
+        }
+    }
+
+    inline const std::vector<Rect<T>>& get() const { return rects; }
+    inline bool empty() const { return rects.empty(); }
+    inline void clear() { rects.clear(); }
+
+    // The number of pixels covered by the rects.
+    std::size_t area() const {
+        std::size_t total = 0;
+        for (const auto& r : rects) {
+            total += std::size_t(r.w) * r.h;
+        }
+        return total;
+    }
+
+private:
+    static Rect<T> bounds(const Rect<T>& a, const Rect<T>& b) {
+        const T x = std::min(a.x, b.x);
+        const T y = std::min(a.y, b.y);
+        return Rect<T>(x, y, std::max(a.x + a.w, b.x + b.w) - x, std::max(a.y + a.h, b.y + b.h) - y);
+    }
+
+    // Merges two rects when their bounding box doesn't waste more pixels than the two rects
+    // cover together. This joins overlapping and adjacent rects, as well as rects with a small
+    // gap between them, but keeps rects in distant parts of the atlas separate.
+    static bool shouldMerge(const Rect<T>& a, const Rect<T>& b) {
+        const Rect<T> c = bounds(a, b);
+        const std::size_t covered = std::size_t(a.w) * a.h + std::size_t(b.w) * b.h;
+        return std::size_t(c.w) * c.h <= 2 * covered;
+    }
+
+    std::vector<Rect<T>> rects;
+};
+
+}
+
+#endif
@@ -8,28 +8,51 @@
 
 #include <cassert>
 #include <algorithm>
+#include <vector>
 
 
 using namespace mbgl;
 
-GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_)
+namespace {
+
+// Free space is rebuilt before evicting glyphs when it is more scattered than this.
+const float compactionThreshold = 0.5f;
+
+}
+
+GlyphAtlas::Page::Page(uint16_t width_, uint16_t height_)
+    : bin(width_, height_),
+      data(std::make_unique<uint8_t[]>(width_ * height_)) {
+}
+
+GlyphAtlas::GlyphAtlas(uint16_t width_, uint16_t height_, uint8_t maxPages_)
     : width(width_),
       height(height_),
-      bin(width_, height_),
-      data(std::make_unique<uint8_t[]>(width_ * height_)),
+      maxPages(std::max<uint8_t>(maxPages_, 1)),
+      pages(maxPages),
       dirty(true) {
+    pages.front() = std::make_unique<Page>(width, height);
 }
 
-void GlyphAtlas::addGlyphs(uintptr_t tileUID,
+bool GlyphAtlas::addGlyphs(uintptr_t tileUID,
                            const std::u32string& text,
                            const std::string& stackName,
                            const FontStack& fontStack,
-                           GlyphPositions& face)
+                           GlyphPositions& face,
+                           uint8_t pageIndex)
 {
     std::lock_guard<std::mutex> lock(mtx);
 
+    assert(pageIndex < maxPages);
+    std::unique_ptr<Page>& page = pages[pageIndex];
+    if (!page) {
+        page = std::make_unique<Page>(width, height);
+        dirty = true;
+    }
+
     const std::map<uint32_t, SDFGlyph>& sdfs = fontStack.getSDFs();
 
+    bool fits = true;
     for (uint32_t chr : text)
     {
         auto sdf_it = sdfs.find(chr);
@@ -38,24 +61,38 @@ void GlyphAtlas::addGlyphs(uintptr_t tileUID,
         }
 
         const SDFGlyph& sdf = sdf_it->second;
-        Rect<uint16_t> rect = addGlyph(tileUID, stackName, sdf);
+        Rect<uint16_t> rect = addGlyph(*page, tileUID, stackName, sdf);
+        if (!rect.hasArea() && sdf.bitmap.size()) {
+            // The caller may try again on the next page.
+            if (pageIndex + 1 == maxPages) {
+                Log::Error(Event::OpenGL, "glyph bitmap overflow");
+                overflows++;
+            }
+            fits = false;
+        }
         face.emplace(chr, Glyph{rect, sdf.metrics});
     }
+
+    return fits;
 }
 
-Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
+Rect<uint16_t> GlyphAtlas::addGlyph(Page& page,
+                                    uintptr_t tileUID,
                                     const std::string& stackName,
                                     const SDFGlyph& glyph)
 {
     // Use constant value for now.
     const uint8_t buffer = 3;
 
-    std::map<uint32_t, GlyphValue>& face = index[stackName];
+    std::map<uint32_t, GlyphValue>& face = page.index[stackName];
     std::map<uint32_t, GlyphValue>::iterator it = face.find(glyph.id);
 
     // The glyph is already in this texture.
     if (it != face.end()) {
         GlyphValue& value = it->second;
+        if (value.ids.empty()) {
+            unlinkUnused(page, value);
+        }
         value.ids.insert(tileUID);
         return value.rect;
     }
@@ -79,62 +116,148 @@ Rect<uint16_t> GlyphAtlas::addGlyph(uintptr_t tileUID,
     pack_width += (4 - pack_width % 4);
     pack_height += (4 - pack_height % 4);
 
-    Rect<uint16_t> rect = bin.allocate(pack_width, pack_height);
+    Rect<uint16_t> rect = allocate(page, pack_width, pack_height);
     if (rect.w == 0) {
-        Log::Error(Event::OpenGL, "glyph bitmap overflow");
         return rect;
     }
 
     assert(rect.x + rect.w <= width);
     assert(rect.y + rect.h <= height);
 
-    face.emplace(glyph.id, GlyphValue { rect, tileUID });
+    face.emplace(glyph.id, GlyphValue { rect, tileUID, face, glyph.id });
 
     // Copy the bitmap
+    uint8_t* target = page.data.get();
     const uint8_t* source = reinterpret_cast<const uint8_t*>(glyph.bitmap.data());
     for (uint32_t y = 0; y < buffered_height; y++) {
         uint32_t y1 = width * (rect.y + y + padding) + rect.x + padding;
         uint32_t y2 = buffered_width * y;
         for (uint32_t x = 0; x < buffered_width; x++) {
-            data[y1 + x] = source[y2 + x];
+            target[y1 + x] = source[y2 + x];
         }
     }
 
+    page.dirtyRects.add(rect);
+    page.dirty = true;
     dirty = true;
 
     return rect;
 }
 
+Rect<uint16_t> GlyphAtlas::allocate(Page& page, uint16_t pack_width, uint16_t pack_height) {
+    Rect<uint16_t> rect = page.bin.allocate(pack_width, pack_height);
+    if (rect.hasArea()) {
+        return rect;
+    }
+
+    // There may be enough free space, split into cells that are too small.
+    if (page.bin.fragmentation() > compactionThreshold) {
+        compact(page);
+        rect = page.bin.allocate(pack_width, pack_height);
+        if (rect.hasArea()) {
+            return rect;
+        }
+    }
+
+    // Make room by evicting the glyphs that no tile uses anymore, least recently used first.
+    bool evicted = false;
+    while (evict(page)) {
+        evicted = true;
+        rect = page.bin.allocate(pack_width, pack_height);
+        if (rect.hasArea()) {
+            return rect;
+        }
+    }
+
+    // The cells of the evicted glyphs may not have been merged with their neighbors.
+    if (evicted) {
+        compact(page);
+        rect = page.bin.allocate(pack_width, pack_height);
+    }
+
+    return rect;
+}
+
+bool GlyphAtlas::evict(Page& page) {
+    GlyphValue* oldest = page.unusedFront;
+    if (!oldest) {
+        return false;
+    }
+
+    unlinkUnused(page, *oldest);
+    clear(page, oldest->rect);
+    page.bin.release(oldest->rect);
+    oldest->face.erase(oldest->glyphID);
+    evictions++;
+
+    return true;
+}
+
+void GlyphAtlas::linkUnused(Page& page, GlyphValue& value) {
+    assert(!value.prev && !value.next && page.unusedFront != &value);
+    value.prev = page.unusedBack;
+    if (page.unusedBack) {
+        page.unusedBack->next = &value;
+    } else {
+        page.unusedFront = &value;
+    }
+    page.unusedBack = &value;
+}
+
+void GlyphAtlas::unlinkUnused(Page& page, GlyphValue& value) {
+    if (value.prev) {
+        value.prev->next = value.next;
+    } else {
+        page.unusedFront = value.next;
+    }
+    if (value.next) {
+        value.next->prev = value.prev;
+    } else {
+        page.unusedBack = value.prev;
+    }
+    value.prev = nullptr;
+    value.next = nullptr;
+}
+
+void GlyphAtlas::compact(Page& page) {
+    std::vector<Rect<uint16_t>> used;
+    for (const auto& faces : page.index) {
+        for (const auto& glyph : faces.second) {
+            used.push_back(glyph.second.rect);
+        }
+    }
+
+    page.bin.repack(width, height, used);
+    compactions++;
+}
+
+void GlyphAtlas::clear(Page& page, const Rect<uint16_t>& rect) {
+    // The texture isn't updated, since nothing refers to this region until it is allocated
+    // again, and then all of it is uploaded.
+    uint8_t *target = page.data.get();
+    for (uint32_t y = 0; y < rect.h; y++) {
+        uint32_t y1 = width * (rect.y + y) + rect.x;
+        for (uint32_t x = 0; x < rect.w; x++) {
+            target[y1 + x] = 0;
+        }
+    }
+}
+
 void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
     std::lock_guard<std::mutex> lock(mtx);
 
-    for (auto& faces : index) {
-        std::map<uint32_t, GlyphValue>& face = faces.second;
-        for (auto it = face.begin(); it != face.end(); /* we advance in the body */) {
-            GlyphValue& value = it->second;
-            value.ids.erase(tileUID);
-
-            if (!value.ids.size()) {
-                const Rect<uint16_t>& rect = value.rect;
-
-                // Clear out the bitmap.
-                uint8_t *target = data.get();
-                for (uint32_t y = 0; y < rect.h; y++) {
-                    uint32_t y1 = width * (rect.y + y) + rect.x;
-                    for (uint32_t x = 0; x < rect.w; x++) {
-                        target[y1 + x] = 0;
-                    }
-                }
-
-                bin.release(rect);
+    for (auto& page : pages) {
+        if (!page) {
+            continue;
+        }
 
-                // Make sure to post-increment the iterator: This will return the
-                // current iterator, but will go to the next position before we
-                // erase the element from the map. That way, the iterator stays
-                // valid.
-                face.erase(it++);
-            } else {
-                ++it;
+        // Glyphs that aren't used anymore stay in the atlas until their space is needed.
+        for (auto& faces : page->index) {
+            for (auto& glyph : faces.second) {
+                GlyphValue& value = glyph.second;
+                if (value.ids.erase(tileUID) && value.ids.empty()) {
+                    linkUnused(*page, value);
+                }
             }
         }
     }
@@ -142,49 +265,118 @@ void GlyphAtlas::removeGlyphs(uintptr_t tileUID) {
 
 void GlyphAtlas::upload() {
     if (dirty) {
-        const bool first = !texture;
-        bind();
-
         std::lock_guard<std::mutex> lock(mtx);
 
-        if (first) {
-            MBGL_CHECK_ERROR(glTexImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                GL_ALPHA, // GLint internalformat
-                width, // GLsizei width
-                height, // GLsizei height
-                0, // GLint border
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
-        } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width, // GLsizei width
-                height, // GLsizei height
-                GL_ALPHA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid* data
-            ));
+        for (auto& page : pages) {
+            if (!page || !page->dirty) {
+                continue;
+            }
+
+            const bool first = !page->texture;
+            bind(*page);
+
+            if (first) {
+                MBGL_CHECK_ERROR(glTexImage2D(
+                    GL_TEXTURE_2D, // GLenum target
+                    0, // GLint level
+                    GL_ALPHA, // GLint internalformat
+                    width, // GLsizei width
+                    height, // GLsizei height
+                    0, // GLint border
+                    GL_ALPHA, // GLenum format
+                    GL_UNSIGNED_BYTE, // GLenum type
+                    page->data.get() // const GLvoid* data
+                ));
+            } else {
+                // Glyph rects are aligned to 4 pixels, so every row we upload satisfies the default
+                // unpack alignment. Rects that span the whole width are contiguous in our buffer;
+                // all others are copied into a temporary buffer first.
+                std::vector<uint8_t> region;
+                for (const auto& rect : page->dirtyRects.get()) {
+                    const uint8_t* pixels = page->data.get() + size_t(width) * rect.y + rect.x;
+                    if (rect.w != width) {
+                        region.resize(size_t(rect.w) * rect.h);
+                        for (uint32_t y = 0; y < rect.h; y++) {
+                            std::copy_n(pixels + size_t(width) * y, rect.w, region.data() + size_t(rect.w) * y);
+                        }
+                        pixels = region.data();
+                    }
+
+                    MBGL_CHECK_ERROR(glTexSubImage2D(
+                        GL_TEXTURE_2D, // GLenum target
+                        0, // GLint level
+                        rect.x, // GLint xoffset
+                        rect.y, // GLint yoffset
+                        rect.w, // GLsizei width
+                        rect.h, // GLsizei height
+                        GL_ALPHA, // GLenum format
+                        GL_UNSIGNED_BYTE, // GLenum type
+                        pixels // const GLvoid* data
+                    ));
+                }
+            }
+
+            page->dirtyRects.clear();
+            page->dirty = false;
         }
 
         dirty = false;
 
 #if defined(DEBUG)
-        // platform::showDebugImage("Glyph Atlas", data.get(), width, height);
+        // platform::showDebugImage("Glyph Atlas", pages.front()->data.get(), width, height);
 #endif
     }
 }
 
-void GlyphAtlas::bind() {
-    if (!texture) {
-        MBGL_CHECK_ERROR(glGenTextures(1, &texture));
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+size_t GlyphAtlas::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mtx);
+    const size_t bytes = size_t(width) * height;
+    size_t total = 0;
+    for (const auto& page : pages) {
+        if (page) {
+            total += page->texture ? 2 * bytes : bytes;
+        }
+    }
+    return total;
+}
+
+GlyphAtlasStats GlyphAtlas::getStats() const {
+    std::lock_guard<std::mutex> lock(mtx);
+
+    GlyphAtlasStats stats;
+    for (const auto& page : pages) {
+        if (!page) {
+            continue;
+        }
+
+        stats.pages++;
+        for (const auto& faces : page->index) {
+            for (const auto& glyph : faces.second) {
+                stats.glyphs++;
+                if (glyph.second.ids.empty()) {
+                    stats.unusedGlyphs++;
+                }
+            }
+        }
+        stats.fragmentation = std::max(stats.fragmentation, page->bin.fragmentation());
+    }
+
+    stats.evictions = evictions;
+    stats.compactions = compactions;
+    stats.overflows = overflows;
+    return stats;
+}
+
+void GlyphAtlas::bind(uint8_t pageIndex) {
+    std::lock_guard<std::mutex> lock(mtx);
+    assert(pageIndex < maxPages && pages[pageIndex]);
+    bind(*pages[pageIndex]);
+}
+
+void GlyphAtlas::bind(Page& page) {
+    if (!page.texture) {
+        MBGL_CHECK_ERROR(glGenTextures(1, &page.texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
 #ifndef GL_ES_VERSION_2_0
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0));
 #endif
@@ -193,6 +385,6 @@ void GlyphAtlas::bind() {
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
         MBGL_CHECK_ERROR(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
     } else {
-        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, texture));
+        MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, page.texture));
     }
 };
@@ -2,12 +2,15 @@
 #define MBGL_GEOMETRY_GLYPH_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_rects.hpp>
+#include <mbgl/map/glyph_atlas_stats.hpp>
 #include <mbgl/text/glyph_store.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
 #include <string>
 #include <set>
 #include <map>
+#include <vector>
 #include <mutex>
 #include <atomic>
 
@@ -15,43 +18,87 @@ namespace mbgl {
 
 class GlyphAtlas : public util::noncopyable {
 public:
-    GlyphAtlas(uint16_t width, uint16_t height);
+    // Each page is a separate texture of the given size. Pages after the first one are only
+    // allocated once they are needed.
+    GlyphAtlas(uint16_t width, uint16_t height, uint8_t maxPages = 1);
 
-    void addGlyphs(uintptr_t tileUID,
+    // Adds the glyphs of the text to the given page, and returns whether all of them fit.
+    // Glyphs don't move once they were added, since their positions end up in the vertex
+    // buffers of the tile. They are reference counted by tile, and glyphs that no tile uses
+    // anymore are evicted from the page in least recently used order when it runs out of
+    // space.
+    bool addGlyphs(uintptr_t tileUID,
                    const std::u32string& text,
                    const std::string& stackName,
                    const FontStack&,
-                   GlyphPositions&);
+                   GlyphPositions&,
+                   uint8_t page = 0);
     void removeGlyphs(uintptr_t tileUID);
 
-    // Binds the atlas texture to the GPU, and uploads data if it is out of date.
-    void bind();
+    // Binds the texture of the page to the GPU. Call upload() first.
+    void bind(uint8_t page = 0);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). After the initial upload,
+    // only the regions that changed since the last upload are sent.
     void upload();
 
+    // The size of the atlas data, and of the texture once it was uploaded.
+    size_t getMemoryUsage() const;
+
+    GlyphAtlasStats getStats() const;
+
     const uint16_t width = 0;
     const uint16_t height = 0;
+    const uint8_t maxPages = 1;
 
 private:
     struct GlyphValue {
-        GlyphValue(const Rect<uint16_t>& rect_, uintptr_t id)
-            : rect(rect_), ids({ id }) {}
+        GlyphValue(const Rect<uint16_t>& rect_, uintptr_t id, std::map<uint32_t, GlyphValue>& face_, uint32_t glyphID_)
+            : rect(rect_), ids({ id }), face(face_), glyphID(glyphID_) {}
         Rect<uint16_t> rect;
         std::set<uintptr_t> ids;
+        // Where the glyph is indexed, to remove it when it is evicted.
+        std::map<uint32_t, GlyphValue>& face;
+        const uint32_t glyphID;
+        // Glyphs that no tile uses are linked into the page's list of unused glyphs.
+        GlyphValue* prev = nullptr;
+        GlyphValue* next = nullptr;
+    };
+
+    struct Page {
+        Page(uint16_t width, uint16_t height);
+
+        BinPack<uint16_t> bin;
+        std::map<std::string, std::map<uint32_t, GlyphValue>> index;
+        const std::unique_ptr<uint8_t[]> data;
+        DirtyRects<uint16_t> dirtyRects;
+        bool dirty = true;
+        uint32_t texture = 0;
+        // The unused glyphs, least recently used first.
+        GlyphValue* unusedFront = nullptr;
+        GlyphValue* unusedBack = nullptr;
     };
 
-    Rect<uint16_t> addGlyph(uintptr_t tileID,
+    Rect<uint16_t> addGlyph(Page&,
+                            uintptr_t tileID,
                             const std::string& stackName,
                             const SDFGlyph&);
+    Rect<uint16_t> allocate(Page&, uint16_t width, uint16_t height);
+    bool evict(Page&);
+    void linkUnused(Page&, GlyphValue&);
+    void unlinkUnused(Page&, GlyphValue&);
+    void compact(Page&);
+    void clear(Page&, const Rect<uint16_t>&);
+    void bind(Page&);
 
-    std::mutex mtx;
-    BinPack<uint16_t> bin;
-    std::map<std::string, std::map<uint32_t, GlyphValue>> index;
-    const std::unique_ptr<uint8_t[]> data;
+    mutable std::mutex mtx;
+    // Pages are created on demand; the slots of those that aren't in use yet are empty.
+    std::vector<std::unique_ptr<Page>> pages;
     std::atomic<bool> dirty;
-    uint32_t texture = 0;
+    uint64_t evictions = 0;
+    uint64_t compactions = 0;
+    uint64_t overflows = 0;
 };
 
 };
@@ -13,6 +13,7 @@
 #include <cassert>
 #include <cmath>
 #include <algorithm>
+#include <vector>
 
 
 using namespace mbgl;
@@ -197,6 +198,15 @@ void SpriteAtlas::copy(const Rect<dimension>& dst, const SpritePosition& src, co
             { dstPos.x - borderX, dstPos.y + dstPos.h, dstPos.w + border + borderX, border });
     }
 
+    // Mark the image's rect, including the borders, as changed. Grow it by a pixel in case
+    // scaling by a fractional pixel ratio rounded the borders outwards.
+    const dimension texWidth = dstSize.x;
+    const dimension texHeight = dstSize.y;
+    const dimension x0 = std::max(0, int(std::floor(dst.x * pixelRatio)) - 1);
+    const dimension y0 = std::max(0, int(std::floor(dst.y * pixelRatio)) - 1);
+    const dimension x1 = std::min(int(texWidth), int(std::ceil((dst.x + dst.w) * pixelRatio)) + 1);
+    const dimension y1 = std::min(int(texHeight), int(std::ceil((dst.y + dst.h) * pixelRatio)) + 1);
+    dirtyRects.add({ x0, y0, dimension(x1 - x0), dimension(y1 - y0) });
     dirty = true;
 }
 
@@ -229,6 +239,12 @@ void SpriteAtlas::setSprite(util::ptr<Sprite> sprite_) {
     });
 }
 
+size_t SpriteAtlas::getMemoryUsage() const {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+    const size_t bytes = size_t(width * pixelRatio) * size_t(height * pixelRatio) * sizeof(uint32_t);
+    return (data ? bytes : 0) + (texture && !fullUploadRequired ? bytes : 0);
+}
+
 void SpriteAtlas::upload() {
     if (dirty) {
         bind();
@@ -276,19 +292,35 @@ void SpriteAtlas::bind(bool linear) {
             ));
             fullUploadRequired = false;
         } else {
-            MBGL_CHECK_ERROR(glTexSubImage2D(
-                GL_TEXTURE_2D, // GLenum target
-                0, // GLint level
-                0, // GLint xoffset
-                0, // GLint yoffset
-                width * pixelRatio, // GLsizei width
-                height * pixelRatio, // GLsizei height
-                GL_RGBA, // GLenum format
-                GL_UNSIGNED_BYTE, // GLenum type
-                data.get() // const GLvoid *pixels
-            ));
+            // The texture has the same size as our buffer, so rects that span the whole width
+            // are contiguous; all others are copied into a temporary buffer first.
+            const dimension texWidth = width * pixelRatio;
+            std::vector<uint32_t> region;
+            for (const auto& rect : dirtyRects.get()) {
+                const uint32_t* pixels = data.get() + size_t(texWidth) * rect.y + rect.x;
+                if (rect.w != texWidth) {
+                    region.resize(size_t(rect.w) * rect.h);
+                    for (uint32_t y = 0; y < rect.h; y++) {
+                        std::copy_n(pixels + size_t(texWidth) * y, rect.w, region.data() + size_t(rect.w) * y);
+                    }
+                    pixels = region.data();
+                }
+
+                MBGL_CHECK_ERROR(glTexSubImage2D(
+                    GL_TEXTURE_2D, // GLenum target
+                    0, // GLint level
+                    rect.x, // GLint xoffset
+                    rect.y, // GLint yoffset
+                    rect.w, // GLsizei width
+                    rect.h, // GLsizei height
+                    GL_RGBA, // GLenum format
+                    GL_UNSIGNED_BYTE, // GLenum type
+                    pixels // const GLvoid *pixels
+                ));
+            }
         }
 
+        dirtyRects.clear();
         dirty = false;
 
 #ifndef GL_ES_VERSION_2_0
@@ -2,6 +2,7 @@
 #define MBGL_GEOMETRY_SPRITE_ATLAS
 
 #include <mbgl/geometry/binpack.hpp>
+#include <mbgl/geometry/dirty_rects.hpp>
 
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/ptr.hpp>
@@ -54,9 +55,14 @@ public:
     void bind(bool linear = false);
 
     // Uploads the texture to the GPU to be available when we need it. This is a lazy operation;
-    // the texture is only bound when the data is out of date (=dirty).
+    // the texture is only bound when the data is out of date (=dirty). Unless the whole texture
+    // has to be uploaded, only the images that were copied since the last upload are sent.
     void upload();
 
+    // The size of the atlas data once it was allocated, and of the texture once it
+    // was uploaded.
+    size_t getMemoryUsage() const;
+
     inline float getWidth() const { return width; }
     inline float getHeight() const { return height; }
     inline float getTextureWidth() const { return width * pixelRatio; }
@@ -71,13 +77,14 @@ private:
     Rect<SpriteAtlas::dimension> allocateImage(size_t width, size_t height);
     void copy(const Rect<dimension>& dst, const SpritePosition& src, const bool wrap);
 
-    std::recursive_mutex mtx;
+    mutable std::recursive_mutex mtx;
     float pixelRatio = 1.0f;
     BinPack<dimension> bin;
     util::ptr<Sprite> sprite;
     std::map<std::string, Rect<dimension>> images;
     std::set<std::string> uninitialized;
     std::unique_ptr<uint32_t[]> data;
+    DirtyRects<dimension> dirtyRects; // In texture pixels.
     std::atomic<bool> dirty;
     bool fullUploadRequired = true;
     uint32_t texture = 0;
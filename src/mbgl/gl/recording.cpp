@@ -0,0 +1,493 @@
+#include <mbgl/gl/recording.hpp>
+#include <mbgl/platform/gl.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+
+namespace mbgl {
+namespace gl {
+namespace recording {
+
+namespace {
+
+std::mutex mutex;
+std::ostream* output = nullptr;
+
+// Writes a call with its arguments, followed by an array of values, e.g. those of a uniform.
+void write(const char* name, std::initializer_list<double> args, const GLfloat* values = nullptr,
+           std::size_t count = 0) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!output) {
+        return;
+    }
+
+    *output << name;
+    for (const double arg : args) {
+        *output << ' ' << arg;
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        *output << ' ' << values[i];
+    }
+    *output << '\n';
+}
+
+}
+
+void start(std::ostream& stream) {
+    std::lock_guard<std::mutex> lock(mutex);
+    output = &stream;
+
+    // Enough digits to tell apart all floats and all 32 bit integers.
+    output->precision(10);
+}
+
+void stop() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (output) {
+        output->flush();
+    }
+    output = nullptr;
+}
+
+bool isRecording() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return output != nullptr;
+}
+
+void frame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (output) {
+        *output << "frame\n";
+    }
+}
+
+#if defined(MBGL_GL_RECORDING)
+
+namespace {
+
+// Names of programs, shaders, buffers and textures, and locations of uniforms and attributes.
+std::atomic<GLuint> nextName { 1 };
+std::atomic<GLint> nextLocation { 0 };
+
+std::size_t textureBytes(GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid* pixels) {
+    if (!pixels) {
+        // Only allocates the texture.
+        return 0;
+    }
+
+    std::size_t components = 4;
+    switch (format) {
+        case GL_ALPHA: components = 1; break;
+        case GL_LUMINANCE: components = 1; break;
+        case GL_LUMINANCE_ALPHA: components = 2; break;
+        case GL_RGB: components = 3; break;
+        default: break;
+    }
+    return std::size_t(width) * height * components * (type == GL_UNSIGNED_BYTE ? 1 : 4);
+}
+
+}
+
+void ActiveTexture(GLenum texture) {
+    write("glActiveTexture", { double(texture) });
+}
+
+void AttachShader(GLuint program, GLuint shader) {
+    write("glAttachShader", { double(program), double(shader) });
+}
+
+void BindBuffer(GLenum target, GLuint buffer) {
+    write("glBindBuffer", { double(target), double(buffer) });
+}
+
+void BindTexture(GLenum target, GLuint texture) {
+    write("glBindTexture", { double(target), double(texture) });
+}
+
+void BlendFunc(GLenum sfactor, GLenum dfactor) {
+    write("glBlendFunc", { double(sfactor), double(dfactor) });
+}
+
+void BufferData(GLenum target, GLsizeiptr size, const GLvoid*, GLenum) {
+    write("glBufferData", { double(target), double(size) });
+}
+
+void Clear(GLbitfield mask) {
+    write("glClear", { double(mask) });
+}
+
+void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    write("glClearColor", { red, green, blue, alpha });
+}
+
+void ClearDepth(double depth) {
+    write("glClearDepth", { depth });
+}
+
+void ClearStencil(GLint s) {
+    write("glClearStencil", { double(s) });
+}
+
+void ColorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha) {
+    write("glColorMask", { double(red), double(green), double(blue), double(alpha) });
+}
+
+void CompileShader(GLuint shader) {
+    write("glCompileShader", { double(shader) });
+}
+
+GLuint CreateProgram() {
+    const GLuint program = nextName++;
+    write("glCreateProgram", { double(program) });
+    return program;
+}
+
+GLuint CreateShader(GLenum type) {
+    const GLuint shader = nextName++;
+    write("glCreateShader", { double(type), double(shader) });
+    return shader;
+}
+
+void DeleteBuffers(GLsizei n, const GLuint*) {
+    write("glDeleteBuffers", { double(n) });
+}
+
+void DeleteProgram(GLuint program) {
+    write("glDeleteProgram", { double(program) });
+}
+
+void DeleteShader(GLuint shader) {
+    write("glDeleteShader", { double(shader) });
+}
+
+void DeleteTextures(GLsizei n, const GLuint*) {
+    write("glDeleteTextures", { double(n) });
+}
+
+void DepthFunc(GLenum func) {
+    write("glDepthFunc", { double(func) });
+}
+
+void DepthMask(GLboolean flag) {
+    write("glDepthMask", { double(flag) });
+}
+
+void DepthRange(double zNear, double zFar) {
+    write("glDepthRange", { zNear, zFar });
+}
+
+void DetachShader(GLuint program, GLuint shader) {
+    write("glDetachShader", { double(program), double(shader) });
+}
+
+void Disable(GLenum cap) {
+    write("glDisable", { double(cap) });
+}
+
+void DrawArrays(GLenum mode, GLint, GLsizei count) {
+    write("glDrawArrays", { double(mode), double(count) });
+}
+
+void DrawElements(GLenum mode, GLsizei count, GLenum, const GLvoid*) {
+    write("glDrawElements", { double(mode), double(count) });
+}
+
+void Enable(GLenum cap) {
+    write("glEnable", { double(cap) });
+}
+
+void EnableVertexAttribArray(GLuint index) {
+    write("glEnableVertexAttribArray", { double(index) });
+}
+
+void Finish() {
+    write("glFinish", {});
+}
+
+void GenBuffers(GLsizei n, GLuint* buffers) {
+    for (GLsizei i = 0; i < n; i++) {
+        buffers[i] = nextName++;
+    }
+    write("glGenBuffers", { double(n) });
+}
+
+void GenTextures(GLsizei n, GLuint* textures) {
+    for (GLsizei i = 0; i < n; i++) {
+        textures[i] = nextName++;
+    }
+    write("glGenTextures", { double(n) });
+}
+
+GLint GetAttribLocation(GLuint program, const GLchar*) {
+    write("glGetAttribLocation", { double(program) });
+    return nextLocation++;
+}
+
+GLenum GetError() {
+    // Not recorded, since debug builds check for errors after every call.
+    return GL_NO_ERROR;
+}
+
+void GetProgramInfoLog(GLuint program, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    write("glGetProgramInfoLog", { double(program) });
+    if (length) *length = 0;
+    if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void GetProgramiv(GLuint program, GLenum pname, GLint* params) {
+    write("glGetProgramiv", { double(program), double(pname) });
+    *params = (pname == GL_LINK_STATUS || pname == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+void GetShaderInfoLog(GLuint shader, GLsizei bufSize, GLsizei* length, GLchar* infoLog) {
+    write("glGetShaderInfoLog", { double(shader) });
+    if (length) *length = 0;
+    if (bufSize > 0) infoLog[0] = '\0';
+}
+
+void GetShaderiv(GLuint shader, GLenum pname, GLint* params) {
+    write("glGetShaderiv", { double(shader), double(pname) });
+    *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+const GLubyte* GetString(GLenum name) {
+    // Without extensions, mbgl doesn't use vertex array objects.
+    write("glGetString", { double(name) });
+    return nullptr;
+}
+
+GLint GetUniformLocation(GLuint program, const GLchar*) {
+    write("glGetUniformLocation", { double(program) });
+    return nextLocation++;
+}
+
+void LineWidth(GLfloat width) {
+    write("glLineWidth", { width });
+}
+
+void LinkProgram(GLuint program) {
+    write("glLinkProgram", { double(program) });
+}
+
+void PointSize(GLfloat size) {
+    write("glPointSize", { size });
+}
+
+void ShaderSource(GLuint shader, GLsizei count, const GLchar* const*, const GLint*) {
+    write("glShaderSource", { double(shader), double(count) });
+}
+
+void StencilFunc(GLenum func, GLint ref, GLuint mask) {
+    write("glStencilFunc", { double(func), double(ref), double(mask) });
+}
+
+void StencilMask(GLuint mask) {
+    write("glStencilMask", { double(mask) });
+}
+
+void StencilOp(GLenum fail, GLenum zfail, GLenum zpass) {
+    write("glStencilOp", { double(fail), double(zfail), double(zpass) });
+}
+
+void TexImage2D(GLenum target, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum format,
+                GLenum type, const GLvoid* pixels) {
+    write("glTexImage2D", { double(target), double(width), double(height),
+                            double(textureBytes(width, height, format, type, pixels)) });
+}
+
+void TexParameteri(GLenum target, GLenum pname, GLint param) {
+    write("glTexParameteri", { double(target), double(pname), double(param) });
+}
+
+void TexSubImage2D(GLenum target, GLint, GLint, GLint, GLsizei width, GLsizei height, GLenum format,
+                   GLenum type, const GLvoid* pixels) {
+    write("glTexSubImage2D", { double(target), double(width), double(height),
+                               double(textureBytes(width, height, format, type, pixels)) });
+}
+
+void Uniform1f(GLint location, GLfloat v0) {
+    write("glUniform1f", { double(location), v0 });
+}
+
+void Uniform1i(GLint location, GLint v0) {
+    write("glUniform1i", { double(location), double(v0) });
+}
+
+void Uniform2fv(GLint location, GLsizei count, const GLfloat* value) {
+    write("glUniform2fv", { double(location) }, value, count * 2);
+}
+
+void Uniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+    write("glUniform3fv", { double(location) }, value, count * 3);
+}
+
+void Uniform4fv(GLint location, GLsizei count, const GLfloat* value) {
+    write("glUniform4fv", { double(location) }, value, count * 4);
+}
+
+void UniformMatrix2fv(GLint location, GLsizei count, GLboolean, const GLfloat* value) {
+    write("glUniformMatrix2fv", { double(location) }, value, count * 4);
+}
+
+void UniformMatrix3fv(GLint location, GLsizei count, GLboolean, const GLfloat* value) {
+    write("glUniformMatrix3fv", { double(location) }, value, count * 9);
+}
+
+void UniformMatrix4fv(GLint location, GLsizei count, GLboolean, const GLfloat* value) {
+    write("glUniformMatrix4fv", { double(location) }, value, count * 16);
+}
+
+void UseProgram(GLuint program) {
+    write("glUseProgram", { double(program) });
+}
+
+void ValidateProgram(GLuint program) {
+    write("glValidateProgram", { double(program) });
+}
+
+void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride,
+                         const GLvoid* pointer) {
+    write("glVertexAttribPointer", { double(index), double(size), double(type), double(normalized),
+                                     double(stride), double(reinterpret_cast<std::uintptr_t>(pointer)) });
+}
+
+void Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    write("glViewport", { double(x), double(y), double(width), double(height) });
+}
+
+#endif
+
+namespace {
+
+// The GL state that a recording has set so far, by the object or the part of the state
+// that a call changes, e.g. "bind buffer 34962" or "cap 2929".
+class Model {
+public:
+    // Sets a value, and returns whether it was set already.
+    bool set(const std::string& key, std::vector<double> value) {
+        auto it = values.find(key);
+        if (it != values.end() && it->second == value) {
+            return true;
+        }
+        values[key] = std::move(value);
+        return false;
+    }
+
+    double get(const std::string& key) const {
+        auto it = values.find(key);
+        return it != values.end() && !it->second.empty() ? it->second.front() : 0;
+    }
+
+private:
+    std::map<std::string, std::vector<double>> values;
+};
+
+std::string key(const char* prefix, double a, double b = 0) {
+    return std::string(prefix) + ' ' + std::to_string(int64_t(a)) + ' ' + std::to_string(int64_t(b));
+}
+
+bool isFixedFunctionState(const std::string& name) {
+    static const std::initializer_list<const char*> names {
+        "glBlendFunc", "glClearColor", "glClearDepth", "glClearStencil", "glColorMask",
+        "glDepthFunc", "glDepthMask", "glDepthRange", "glLineWidth", "glPointSize",
+        "glStencilFunc", "glStencilMask", "glStencilOp", "glViewport"
+    };
+    for (const auto stateName : names) {
+        if (name == stateName) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}
+
+std::vector<Summary> summarize(std::istream& stream) {
+    std::vector<Summary> frames(1);
+    Model model;
+
+    std::string line;
+    std::vector<double> args;
+    while (std::getline(stream, line)) {
+        std::istringstream tokens(line);
+        std::string name;
+        if (!(tokens >> name)) {
+            continue;
+        }
+
+        if (name == "frame") {
+            frames.emplace_back();
+            continue;
+        }
+
+        args.clear();
+        double arg;
+        while (tokens >> arg) {
+            args.push_back(arg);
+        }
+        const auto at = [&](std::size_t i) { return i < args.size() ? args[i] : 0; };
+        const auto rest = [&](std::size_t i) {
+            return std::vector<double>(args.begin() + std::min(i, args.size()), args.end());
+        };
+
+        Summary& summary = frames.back();
+        summary.calls++;
+
+        const auto bind = [&](const std::string& target, std::vector<double> value) {
+            summary.binds++;
+            if (model.set(target, std::move(value))) {
+                summary.redundantBinds++;
+            }
+        };
+        const auto change = [&](const std::string& target, std::vector<double> value) {
+            summary.stateChanges++;
+            if (model.set(target, std::move(value))) {
+                summary.redundantStateChanges++;
+            }
+        };
+
+        if (name == "glDrawElements" || name == "glDrawArrays") {
+            summary.drawCalls++;
+            summary.vertices += at(1);
+        } else if (name == "glBufferData" || name == "glTexImage2D" || name == "glTexSubImage2D") {
+            summary.uploads++;
+            summary.uploadBytes += args.empty() ? 0 : args.back();
+        } else if (name == "glUseProgram") {
+            bind("program", rest(0));
+        } else if (name == "glActiveTexture") {
+            bind("unit", rest(0));
+        } else if (name == "glBindBuffer") {
+            bind(key("bind buffer", at(0)), rest(1));
+        } else if (name == "glBindTexture") {
+            bind(key("bind texture", model.get("unit"), at(0)), rest(1));
+        } else if (name == "glEnable" || name == "glDisable") {
+            change(key("cap", at(0)), { name == "glEnable" ? 1.0 : 0.0 });
+        } else if (name.compare(0, 9, "glUniform") == 0) {
+            change(key("uniform", model.get("program"), at(0)), rest(1));
+        } else if (name == "glVertexAttribPointer") {
+            // Attribute pointers refer to the buffer that was bound when they were set.
+            auto value = rest(1);
+            value.push_back(model.get(key("bind buffer", GL_ARRAY_BUFFER)));
+            change(key("attrib", at(0)), std::move(value));
+        } else if (name == "glEnableVertexAttribArray") {
+            change(key("attrib array", at(0)), { 1 });
+        } else if (name == "glTexParameteri") {
+            const double texture = model.get(key("bind texture", model.get("unit"), at(0)));
+            change(key("texture parameter", texture, at(1)), rest(2));
+        } else if (isFixedFunctionState(name)) {
+            change(name, args);
+        }
+    }
+
+    return frames;
+}
+
+}
+}
+}
@@ -0,0 +1,56 @@
+#ifndef MBGL_GL_RECORDER
+#define MBGL_GL_RECORDER
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+namespace mbgl {
+namespace gl {
+namespace recording {
+
+// Builds with MBGL_GL_RECORDING write every GL call to the given stream until stop() is
+// called, one call per line: the name of the function, followed by those of its arguments
+// that matter for profiling, e.g. the target and name of a bind, the values of a state change
+// or a uniform, the byte size of an upload and the vertex count of a draw call. The painter
+// starts each frame with a line that only contains "frame".
+//
+// Other builds call the driver directly, so the stream only receives the frame markers.
+void start(std::ostream&);
+void stop();
+bool isRecording();
+
+// Marks the beginning of a frame in the stream.
+void frame();
+
+// The cost of a part of a recording.
+struct Summary {
+    std::size_t calls = 0;
+
+    std::size_t drawCalls = 0;
+    std::size_t vertices = 0;
+
+    // Changes of fixed-function state, uniforms and vertex attributes. A change is redundant
+    // if it sets the value that was already set.
+    std::size_t stateChanges = 0;
+    std::size_t redundantStateChanges = 0;
+
+    // Binds of programs, buffers and textures, and changes of the active texture unit.
+    std::size_t binds = 0;
+    std::size_t redundantBinds = 0;
+
+    // Buffer and texture uploads, and the bytes they transferred.
+    std::size_t uploads = 0;
+    std::size_t uploadBytes = 0;
+};
+
+// Replays a recording against a model of the GL state, and summarizes each of its frames. The
+// first summary covers the calls before the first frame, e.g. shader compilation.
+std::vector<Summary> summarize(std::istream&);
+
+}
+}
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include <mbgl/map/compressed_tile_cache.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/worker.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace mbgl {
+
+CompressedTileCache::CompressedTileCache(size_t maxBytes_) : maxBytes(maxBytes_) {}
+
+CompressedTileCache::~CompressedTileCache() = default;
+
+void CompressedTileCache::setWorker(Worker* worker_) {
+    if (worker != worker_) {
+        pending.clear();
+        worker = worker_;
+    }
+}
+
+void CompressedTileCache::setMaxBytes(size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    trim(maxBytes);
+}
+
+void CompressedTileCache::add(uint64_t key, const std::string& data) {
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        erase(it);
+    }
+    pending.erase(key);
+
+    if (!maxBytes || data.empty()) {
+        return;
+    }
+
+    if (!worker) {
+        insert(key, compressor.compress(data));
+        return;
+    }
+
+    // Compressing takes long enough to drop frames when several tiles are evicted or
+    // prefetched at once, so it doesn't run on the map thread. It only runs once there
+    // are no tiles left to parse.
+    auto job = std::make_unique<Pending>();
+    job->data = data;
+    Pending& ref = *job;
+    job->request = worker->send([this, &ref] {
+        std::lock_guard<std::mutex> lock(compressorMutex);
+        ref.compressed = compressor.compress(ref.data);
+    }, [this, key] {
+        finish(key);
+    }, std::numeric_limits<double>::max());
+    pending.emplace(key, std::move(job));
+}
+
+void CompressedTileCache::finish(uint64_t key) {
+    auto it = pending.find(key);
+    if (it == pending.end()) {
+        return;
+    }
+
+    // This is called from the after callback of the request, which is destroyed along with
+    // the pending entry, so nothing may be used from the callback past this point.
+    std::string compressed = std::move(it->second->compressed);
+    pending.erase(it);
+    insert(key, std::move(compressed));
+}
+
+void CompressedTileCache::insert(uint64_t key, std::string compressed) {
+    if (compressed.size() > maxBytes) {
+        return;
+    }
+
+    stats.bytes += compressed.size();
+    orderedKeys.push_back(key);
+    tiles.emplace(key, Entry { std::move(compressed), std::prev(orderedKeys.end()) });
+    stats.tiles = tiles.size();
+
+    trim(maxBytes);
+    stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+}
+
+mapbox::util::optional<std::string> CompressedTileCache::get(uint64_t key) {
+    // Data that is still being compressed is returned as is.
+    auto job = pending.find(key);
+    if (job != pending.end()) {
+        stats.hits++;
+        std::string data = std::move(job->second->data);
+        pending.erase(job);
+        return std::move(data);
+    }
+
+    auto it = tiles.find(key);
+    if (it == tiles.end()) {
+        stats.misses++;
+        return {};
+    }
+
+    stats.hits++;
+    std::string data = decompressor.decompress(it->second.data);
+    erase(it);
+    return std::move(data);
+}
+
+void CompressedTileCache::clear() {
+    pending.clear();
+    orderedKeys.clear();
+    tiles.clear();
+    stats.tiles = 0;
+    stats.bytes = 0;
+}
+
+void CompressedTileCache::trim(size_t bytes) {
+    while (!orderedKeys.empty() && stats.bytes > bytes) {
+        erase(tiles.find(orderedKeys.front()));
+    }
+}
+
+void CompressedTileCache::erase(std::unordered_map<uint64_t, Entry>::iterator it) {
+    stats.bytes -= it->second.data.size();
+    orderedKeys.erase(it->second.position);
+    tiles.erase(it);
+    stats.tiles = tiles.size();
+}
+
+}
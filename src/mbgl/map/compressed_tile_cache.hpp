@@ -0,0 +1,88 @@
+#ifndef MBGL_MAP_COMPRESSED_TILE_CACHE
+#define MBGL_MAP_COMPRESSED_TILE_CACHE
+
+#include <mbgl/map/tile_cache_stats.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/optional.hpp>
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace mbgl {
+
+class Worker;
+class WorkRequest;
+
+// Keeps the compressed raw data of the most recently evicted tiles within a byte budget,
+// so that tiles which come back into view can be parsed again without being loaded from
+// the file source.
+class CompressedTileCache {
+public:
+    CompressedTileCache(size_t maxBytes_);
+    ~CompressedTileCache();
+
+    // A budget of 0 disables the cache.
+    void setMaxBytes(size_t);
+    size_t getMaxBytes() const { return maxBytes; }
+
+    // Data is compressed on the worker pool when one is set, and added to the cache once
+    // it is compressed. Without one, it is compressed right away on the calling thread.
+    // Changing the worker pool cancels compression that is still pending.
+    void setWorker(Worker*);
+
+    void add(uint64_t key, const std::string& data);
+
+    // Returns the decompressed data, and removes it from the cache.
+    mapbox::util::optional<std::string> get(uint64_t key);
+
+    void clear();
+
+    // Evicts the least recently added data until at most the given number of bytes is
+    // left, without changing the budget.
+    void trim(size_t bytes);
+
+    const TileCacheStats& getStats() const { return stats; }
+
+private:
+    struct Entry {
+        std::string data;
+        std::list<uint64_t>::iterator position;
+    };
+
+    // Data that is being compressed on the worker pool.
+    struct Pending {
+        std::string data;
+        std::string compressed;
+        std::unique_ptr<WorkRequest> request;
+    };
+
+    void insert(uint64_t key, std::string compressed);
+    void finish(uint64_t key);
+    void erase(std::unordered_map<uint64_t, Entry>::iterator);
+
+    std::unordered_map<uint64_t, Entry> tiles;
+
+    // Least recently added keys first.
+    std::list<uint64_t> orderedKeys;
+
+    size_t maxBytes;
+    TileCacheStats stats;
+
+    // Tiles are added while the map is rendering, so they are compressed with the fast level.
+    // Work on the pool runs in parallel, so it takes turns with the compressor.
+    util::Compressor compressor { util::fastCompression };
+    std::mutex compressorMutex;
+    util::Decompressor decompressor;
+
+    Worker* worker = nullptr;
+
+    // Declared last, so that pending work is canceled before the compressor goes away.
+    std::unordered_map<uint64_t, std::unique_ptr<Pending>> pending;
+};
+
+}
+
+#endif
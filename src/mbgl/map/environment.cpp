@@ -129,6 +129,19 @@ void Environment::cancelRequest(Request* req) {
     fileSource.cancel(req);
 }
 
+void Environment::setRequestPriority(Request* req, double priority) {
+    assert(currentlyOn(ThreadType::Map));
+    fileSource.setPriority(req, priority);
+}
+
+void Environment::store(const Resource& resource, std::shared_ptr<const Response> response) {
+    fileSource.store(resource, std::move(response));
+}
+
+bool Environment::storesDerivedData() const {
+    return fileSource.storesDerivedData();
+}
+
 // #############################################################################################
 
 #pragma mark - OpenGL cleanup
@@ -4,6 +4,16 @@
 
 namespace mbgl {
 
+void GeometryTileFeature::readGeometries(GeometryBuffer& buffer) const {
+    buffer.clear();
+    for (const auto& line : getGeometries()) {
+        buffer.beginLine();
+        for (const auto& coordinate : line) {
+            buffer.add(coordinate);
+        }
+    }
+}
+
 mapbox::util::optional<Value> GeometryTileFeatureExtractor::getValue(const std::string& key) const {
     if (key == "$type") {
         return Value(uint64_t(feature.getType()));
@@ -8,6 +8,7 @@
 #include <mbgl/util/vec.hpp>
 #include <mbgl/util/noncopyable.hpp>
 
+#include <cassert>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -23,17 +24,120 @@ enum class FeatureType : uint8_t {
 
 typedef std::vector<std::vector<Coordinate>> GeometryCollection;
 
+// A view of a single line or ring in a GeometryBuffer. It is invalidated when
+// the buffer is modified.
+class GeometryLine {
+public:
+    GeometryLine(const Coordinate* begin_, const Coordinate* end_)
+        : first(begin_), last(end_) {}
+
+    const Coordinate* begin() const { return first; }
+    const Coordinate* end() const { return last; }
+    std::size_t size() const { return last - first; }
+    bool empty() const { return first == last; }
+
+    const Coordinate& operator[](std::size_t i) const { return first[i]; }
+    const Coordinate& front() const { return *first; }
+    const Coordinate& back() const { return *(last - 1); }
+
+private:
+    const Coordinate* first;
+    const Coordinate* last;
+};
+
+// Stores the geometries of a feature in a single coordinate array, along with
+// the offsets at which each line or ring starts. Clearing the buffer retains
+// its memory, so a buffer that is reused for all features of a tile only
+// allocates when a feature has more coordinates than the ones before.
+class GeometryBuffer : private util::noncopyable {
+public:
+    void clear() {
+        coordinates.clear();
+        offsets.clear();
+    }
+
+    // Starts a new line or ring. Subsequent coordinates are added to it.
+    void beginLine() {
+        offsets.push_back(coordinates.size());
+    }
+
+    void add(const Coordinate& coordinate) {
+        assert(!offsets.empty());
+        coordinates.push_back(coordinate);
+    }
+
+    // The number of lines or rings.
+    std::size_t size() const { return offsets.size(); }
+    bool empty() const { return offsets.empty(); }
+
+    GeometryLine operator[](std::size_t i) const {
+        const Coordinate* data = coordinates.data();
+        return { data + offsets[i], data + (i + 1 < offsets.size() ? offsets[i + 1] : coordinates.size()) };
+    }
+
+    GeometryLine back() const {
+        return operator[](offsets.size() - 1);
+    }
+
+private:
+    std::vector<Coordinate> coordinates;
+    std::vector<std::size_t> offsets;
+};
+
+// The properties of a feature as pairs of key index and value, for features of layers
+// that have key indices. The properties are decoded once per feature, and then shared
+// by all filters that are evaluated against the feature. The values are owned by the
+// layer.
+class GeometryTileProperties : private util::noncopyable {
+public:
+    void clear() {
+        entries.clear();
+    }
+
+    void add(uint32_t key, const Value& value) {
+        entries.emplace_back(key, &value);
+    }
+
+    // Features have few properties, so a linear scan beats hashing.
+    const Value* get(uint32_t key) const {
+        for (const auto& entry : entries) {
+            if (entry.first == key) {
+                return entry.second;
+            }
+        }
+        return nullptr;
+    }
+
+private:
+    std::vector<std::pair<uint32_t, const Value*>> entries;
+};
+
 class GeometryTileFeature : private util::noncopyable {
 public:
     virtual FeatureType getType() const = 0;
     virtual mapbox::util::optional<Value> getValue(const std::string& key) const = 0;
     virtual GeometryCollection getGeometries() const = 0;
+
+    // Replaces the contents of the buffer with the geometries of this feature.
+    virtual void readGeometries(GeometryBuffer&) const;
+
+    // Replaces the contents of the properties with the properties of this feature. Only
+    // implemented by features of layers that have key indices.
+    virtual void readProperties(GeometryTileProperties&) const {}
 };
 
 class GeometryTileLayer : private util::noncopyable {
 public:
     virtual std::size_t featureCount() const = 0;
     virtual util::ptr<const GeometryTileFeature> getFeature(std::size_t) const = 0;
+
+    // Layers that store their property keys in a table can resolve a key to its index
+    // once, so that filters look up the properties of each feature by index instead of
+    // by name. Other layers return false.
+    virtual bool hasKeyIndices() const { return false; }
+
+    // Returns the index of the key, or nothing if no feature of this layer has the key.
+    virtual mapbox::util::optional<uint32_t> getKeyIndex(const std::string&) const { return {}; }
 };
 
 class GeometryTile : private util::noncopyable {
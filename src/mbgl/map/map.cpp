@@ -335,6 +335,42 @@ void Map::setSourceTileCacheSize(size_t size) {
     context->invoke(&MapContext::setSourceTileCacheSize, size);
 }
 
+void Map::setSourceTileCacheBudget(size_t bytes) {
+    context->invoke(&MapContext::setSourceTileCacheBudget, bytes);
+}
+
+TileCacheStats Map::getSourceTileCacheStats() const {
+    return context->invokeSync<TileCacheStats>(&MapContext::getSourceTileCacheStats);
+}
+
+void Map::setSourceCompressedTileCacheBudget(size_t bytes) {
+    context->invoke(&MapContext::setSourceCompressedTileCacheBudget, bytes);
+}
+
+TileCacheStats Map::getSourceCompressedTileCacheStats() const {
+    return context->invokeSync<TileCacheStats>(&MapContext::getSourceCompressedTileCacheStats);
+}
+
+void Map::setTilePrefetchBudget(size_t requests, size_t bytes) {
+    context->invoke(&MapContext::setTilePrefetchBudget, requests, bytes);
+}
+
+void Map::setMemoryBudget(size_t bytes) {
+    context->invoke(&MapContext::setMemoryBudget, bytes);
+}
+
+MemoryStats Map::getMemoryStats() const {
+    return context->invokeSync<MemoryStats>(&MapContext::getMemoryStats);
+}
+
+RenderStats Map::getRenderStats() const {
+    return context->invokeSync<RenderStats>(&MapContext::getRenderStats);
+}
+
+GlyphAtlasStats Map::getGlyphAtlasStats() const {
+    return context->invokeSync<GlyphAtlasStats>(&MapContext::getGlyphAtlasStats);
+}
+
 void Map::onLowMemory() {
     context->invoke(&MapContext::onLowMemory);
 }
@@ -12,6 +12,7 @@
 #include <mbgl/storage/response.hpp>
 
 #include <mbgl/style/style.hpp>
+#include <mbgl/geometry/glyph_atlas.hpp>
 
 #include <mbgl/util/uv_detail.hpp>
 #include <mbgl/util/worker.hpp>
@@ -20,10 +21,11 @@
 
 namespace mbgl {
 
-MapContext::MapContext(uv_loop_t* loop, View& view_, FileSource& fileSource, MapData& data_)
+MapContext::MapContext(uv_loop_t* loop, View& view_, FileSource& fileSource_, MapData& data_)
     : view(view_),
       data(data_),
-      env(fileSource),
+      fileSource(fileSource_),
+      env(fileSource_),
       envScope(env, ThreadType::Map, "Map"),
       updated(static_cast<UpdateType>(Update::Nothing)),
       asyncUpdate(std::make_unique<uv::async>(loop, [this] { update(); })),
@@ -111,6 +113,14 @@ void MapContext::loadStyleJSON(const std::string& json, const std::string& base)
     style->setDefaultTransitionDuration(data.getDefaultTransitionDuration());
     style->setObserver(this);
 
+    for (const auto &source : style->sources) {
+        source->setCacheSize(sourceCacheSize);
+        source->setCacheBudget(sourceCacheBudget);
+        source->setCompressedCacheBudget(sourceCompressedCacheBudget);
+        source->setPrefetchBudget(prefetchRequests, prefetchBytes);
+    }
+
+    memoryChanged = true;
     triggerUpdate(Update::Zoom);
 }
 
@@ -118,6 +128,17 @@ void MapContext::updateTiles() {
     assert(Environment::currentlyOn(ThreadType::Map));
 
     style->update(data, transformState, *texturePool);
+
+    // Pans are extrapolated this far ahead, and the predicted path is sampled at a few states
+    // in between, so that tiles that are only passed are prefetched as well.
+    const Duration prefetchLookahead = std::chrono::milliseconds(500);
+    const std::size_t prefetchSteps = 4;
+    style->prefetch(data.transform.predictedPath(prefetchLookahead, prefetchSteps, Clock::now()));
+
+    if (memoryChanged) {
+        memoryBudget.enforce(*style, *texturePool, fileSource);
+        memoryChanged = false;
+    }
 }
 
 void MapContext::updateAnnotationTiles(const std::vector<TileID>& ids) {
@@ -240,17 +261,96 @@ void MapContext::setSourceTileCacheSize(size_t size) {
     }
 }
 
-void MapContext::onLowMemory() {
+void MapContext::setSourceTileCacheBudget(size_t bytes) {
     assert(Environment::currentlyOn(ThreadType::Map));
+    if (bytes != sourceCacheBudget) {
+        sourceCacheBudget = bytes;
+        if (!style) return;
+        for (const auto &source : style->sources) {
+            source->setCacheBudget(sourceCacheBudget);
+        }
+        view.invalidate([this] { render(); });
+    }
+}
+
+void MapContext::setSourceCompressedTileCacheBudget(size_t bytes) {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    if (bytes != sourceCompressedCacheBudget) {
+        sourceCompressedCacheBudget = bytes;
+        if (!style) return;
+        for (const auto &source : style->sources) {
+            source->setCompressedCacheBudget(sourceCompressedCacheBudget);
+        }
+    }
+}
+
+void MapContext::setTilePrefetchBudget(size_t requests, size_t bytes) {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    prefetchRequests = requests;
+    prefetchBytes = bytes;
     if (!style) return;
     for (const auto &source : style->sources) {
-        source->onLowMemory();
+        source->setPrefetchBudget(prefetchRequests, prefetchBytes);
+    }
+}
+
+TileCacheStats MapContext::getSourceTileCacheStats() const {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    return sumSourceStats(&Source::getCacheStats);
+}
+
+TileCacheStats MapContext::getSourceCompressedTileCacheStats() const {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    return sumSourceStats(&Source::getCompressedCacheStats);
+}
+
+TileCacheStats MapContext::sumSourceStats(const TileCacheStats& (Source::*getStats)() const) const {
+    TileCacheStats total;
+    if (!style) return total;
+    for (const auto &source : style->sources) {
+        const TileCacheStats& stats = ((*source).*getStats)();
+        total.tiles += stats.tiles;
+        total.bytes += stats.bytes;
+        total.peakBytes += stats.peakBytes;
+        total.hits += stats.hits;
+        total.misses += stats.misses;
     }
+    return total;
+}
+
+void MapContext::setMemoryBudget(size_t bytes) {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    memoryBudget.setBudget(bytes);
+    memoryChanged = true;
+    triggerUpdate();
+}
+
+MemoryStats MapContext::getMemoryStats() {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    if (!style) return memoryBudget.getStats();
+    return memoryBudget.measure(*style, *texturePool, fileSource);
+}
+
+RenderStats MapContext::getRenderStats() const {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    return painter ? painter->getStats() : RenderStats();
+}
+
+GlyphAtlasStats MapContext::getGlyphAtlasStats() const {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    return style ? style->glyphAtlas->getStats() : GlyphAtlasStats();
+}
+
+void MapContext::onLowMemory() {
+    assert(Environment::currentlyOn(ThreadType::Map));
+    if (!style) return;
+    memoryBudget.release(*style, *texturePool, fileSource);
     view.invalidate([this] { render(); });
 }
 
 void MapContext::onTileDataChanged() {
     assert(Environment::currentlyOn(ThreadType::Map));
+    memoryChanged = true;
     triggerUpdate();
 }
 
@@ -5,8 +5,13 @@
 #include <mbgl/map/update.hpp>
 #include <mbgl/map/environment.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/map/tile_cache_stats.hpp>
+#include <mbgl/map/memory_budget.hpp>
+#include <mbgl/map/render_stats.hpp>
+#include <mbgl/map/glyph_atlas_stats.hpp>
 #include <mbgl/style/style.hpp>
 #include <mbgl/util/ptr.hpp>
+#include <mbgl/util/constants.hpp>
 
 #include <vector>
 
@@ -52,8 +57,20 @@ public:
     void updateAnnotationTiles(const std::vector<TileID>&);
 
     void setSourceTileCacheSize(size_t size);
+    void setSourceTileCacheBudget(size_t bytes);
+    void setSourceCompressedTileCacheBudget(size_t bytes);
+    TileCacheStats getSourceTileCacheStats() const;
+    TileCacheStats getSourceCompressedTileCacheStats() const;
+
+    void setTilePrefetchBudget(size_t requests, size_t bytes);
+
+    void setMemoryBudget(size_t bytes);
+    MemoryStats getMemoryStats();
     void onLowMemory();
 
+    RenderStats getRenderStats() const;
+    GlyphAtlasStats getGlyphAtlasStats() const;
+
     void cleanup();
 
     // Style::Observer implementation.
@@ -69,8 +86,11 @@ private:
     // Loads the actual JSON object an creates a new Style object.
     void loadStyleJSON(const std::string& json, const std::string& base);
 
+    TileCacheStats sumSourceStats(const TileCacheStats& (Source::*)() const) const;
+
     View& view;
     MapData& data;
+    FileSource& fileSource;
 
     Environment env;
     EnvironmentScope envScope;
@@ -86,7 +106,16 @@ private:
     std::string styleJSON;
 
     StillImageCallback callback;
-    size_t sourceCacheSize;
+    size_t sourceCacheSize = 0;
+    size_t sourceCacheBudget = util::tileCacheBytes;
+    size_t sourceCompressedCacheBudget = util::compressedTileCacheBytes;
+    size_t prefetchRequests = util::prefetchRequests;
+    size_t prefetchBytes = util::prefetchBytes;
+
+    // Memory usage only changes when tiles are loaded or removed, so the budget is
+    // enforced on the first update after that rather than on every frame.
+    MemoryBudget memoryBudget { util::memoryBudget };
+    bool memoryChanged = true;
     TransformState transformState;
 };
 
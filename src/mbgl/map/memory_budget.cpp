@@ -0,0 +1,82 @@
+#include <mbgl/map/memory_budget.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/geometry/glyph_atlas.hpp>
+#include <mbgl/geometry/sprite_atlas.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/util/texture_pool.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mbgl {
+
+void MemoryBudget::setBudget(std::size_t budget_) {
+    budget = budget_;
+}
+
+const MemoryStats& MemoryBudget::enforce(Style& style, TexturePool& texturePool, FileSource& fileSource) {
+    measure(style, texturePool, fileSource);
+    stats.pressure = MemoryPressure::Normal;
+
+    if (!budget || stats.total() <= budget) {
+        return stats;
+    }
+
+    const std::size_t excess = stats.total() - budget;
+    if (excess <= stats.tileCaches) {
+        stats.pressure = MemoryPressure::Moderate;
+        trimTileCaches(style, excess);
+    } else {
+        stats.pressure = MemoryPressure::Critical;
+        releaseCaches(style, texturePool, fileSource);
+    }
+
+    measure(style, texturePool, fileSource);
+    return stats;
+}
+
+const MemoryStats& MemoryBudget::release(Style& style, TexturePool& texturePool, FileSource& fileSource) {
+    releaseCaches(style, texturePool, fileSource);
+
+    measure(style, texturePool, fileSource);
+    stats.pressure = MemoryPressure::Critical;
+    return stats;
+}
+
+const MemoryStats& MemoryBudget::measure(Style& style, TexturePool& texturePool, FileSource& fileSource) {
+    stats.tiles = 0;
+    stats.tileCaches = 0;
+    for (const auto& source : style.sources) {
+        stats.tiles += source->getMemoryUsage();
+        stats.tileCaches += source->getCacheStats().bytes + source->getCompressedCacheStats().bytes;
+    }
+
+    stats.glyphAtlas = style.glyphAtlas->getMemoryUsage();
+    stats.spriteAtlas = style.spriteAtlas->getMemoryUsage();
+    stats.texturePool = texturePool.getMemoryUsage();
+    stats.fileCache = fileSource.getMemoryUsage();
+    stats.budget = budget;
+    return stats;
+}
+
+void MemoryBudget::trimTileCaches(Style& style, std::size_t excess) {
+    // Each source gives up a share of the excess proportional to the size of its cache,
+    // so that a single busy source doesn't lose all of its cached tiles.
+    const double fraction = double(excess) / stats.tileCaches;
+    for (const auto& source : style.sources) {
+        const std::size_t bytes = source->getCacheStats().bytes + source->getCompressedCacheStats().bytes;
+        const auto trimmed = static_cast<std::size_t>(std::ceil(bytes * fraction));
+        source->trimCache(bytes - std::min(bytes, trimmed));
+    }
+}
+
+void MemoryBudget::releaseCaches(Style& style, TexturePool& texturePool, FileSource& fileSource) {
+    for (const auto& source : style.sources) {
+        source->clearCache();
+    }
+    texturePool.clearTextureIDs();
+    fileSource.releaseMemory();
+}
+
+}
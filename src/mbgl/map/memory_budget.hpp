@@ -0,0 +1,51 @@
+#ifndef MBGL_MAP_MEMORY_BUDGET
+#define MBGL_MAP_MEMORY_BUDGET
+
+#include <mbgl/map/memory_stats.hpp>
+#include <mbgl/util/noncopyable.hpp>
+
+#include <cstddef>
+
+namespace mbgl {
+
+class Style;
+class TexturePool;
+class FileSource;
+
+// Accounts for the memory held by a map: tiles in use and cached, the glyph and sprite
+// atlases, the texture pool and the file cache. When the total exceeds the budget,
+// evicts in increasing levels of MemoryPressure until it fits again. Only caches are
+// evicted; memory that is needed to render the current view is measured, but kept.
+class MemoryBudget : private util::noncopyable {
+public:
+    MemoryBudget(std::size_t budget_) : budget(budget_) {}
+
+    // A budget of 0 means that memory usage is measured, but not limited.
+    void setBudget(std::size_t);
+    std::size_t getBudget() const { return budget; }
+
+    // Measures the memory usage and evicts as little as possible to get back within
+    // the budget.
+    const MemoryStats& enforce(Style&, TexturePool&, FileSource&);
+
+    // Evicts at the critical level regardless of the budget, e.g. when the system is
+    // low on memory.
+    const MemoryStats& release(Style&, TexturePool&, FileSource&);
+
+    // Measures the memory usage without evicting anything. The pressure is the one
+    // reached by the last eviction.
+    const MemoryStats& measure(Style&, TexturePool&, FileSource&);
+
+    const MemoryStats& getStats() const { return stats; }
+
+private:
+    void trimTileCaches(Style&, std::size_t excess);
+    void releaseCaches(Style&, TexturePool&, FileSource&);
+
+    std::size_t budget;
+    MemoryStats stats;
+};
+
+}
+
+#endif
@@ -29,3 +29,7 @@ void RasterTileData::parse() {
 Bucket* RasterTileData::getBucket(StyleLayer const&) {
     return &bucket;
 }
+
+size_t RasterTileData::getMemoryUsage() const {
+    return TileData::getMemoryUsage() + bucket.getMemoryUsage();
+}
@@ -21,6 +21,7 @@ public:
 
     void parse() override;
     Bucket* getBucket(StyleLayer const &layer_desc) override;
+    size_t getMemoryUsage() const override;
 
 protected:
     StyleLayoutRaster layout;
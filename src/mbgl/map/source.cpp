@@ -116,12 +116,13 @@ std::string SourceInfo::tileURL(const TileID& id, float pixelRatio) const {
     return result;
 }
 
-Source::Source() {}
+Source::Source() : cache(util::tileCacheBytes) {}
 
 Source::~Source() {
     if (req) {
         Environment::Get().cancelRequest(req);
     }
+    cancelPrefetching();
 }
 
 bool Source::isLoaded() const {
@@ -224,7 +225,7 @@ TileData::State Source::hasTile(const TileID& id) {
     return TileData::State::invalid;
 }
 
-bool Source::handlePartialTile(const TileID& id, Worker& worker) {
+bool Source::handlePartialTile(const TileID& id, Worker& worker, double priority) {
     const TileID normalized_id = id.normalized();
 
     auto it = tile_data.find(normalized_id);
@@ -247,7 +248,7 @@ bool Source::handlePartialTile(const TileID& id, Worker& worker) {
         }
     };
 
-    return data->reparse(worker, callback);
+    return data->reparse(worker, priority, callback);
 }
 
 TileData::State Source::addTile(MapData& data,
@@ -288,7 +289,12 @@ TileData::State Source::addTile(MapData& data,
         new_tile.data = cache.get(normalized_id.to_uint64());
     }
 
-    if (!new_tile.data) {
+    const double priority = getTilePriority(id, transformState);
+
+    if (new_tile.data) {
+        // The tile may have been hidden until now.
+        new_tile.data->setPriority(priority);
+    } else {
         auto callback = std::bind(&Source::tileLoadingCompleteCallback, this, normalized_id, transformState, data.getCollisionDebug());
 
         // If we don't find working tile data, we're just going to load it.
@@ -297,17 +303,24 @@ TileData::State Source::addTile(MapData& data,
                 std::make_shared<VectorTileData>(normalized_id, style, glyphAtlas,
                                                  glyphStore, spriteAtlas, sprite, info,
                                                  transformState.getAngle(), data.getCollisionDebug());
-            new_tile.data->request(style.workers, transformState.getPixelRatio(), callback);
+
+            // Tiles that were evicted recently may only need to be parsed again.
+            auto cached = cache.getData(normalized_id.to_uint64());
+            if (cached) {
+                new_tile.data->load(style.workers, std::move(cached.get()), false, priority, callback);
+            } else {
+                new_tile.data->request(style.workers, transformState.getPixelRatio(), priority, callback);
+            }
         } else if (info.type == SourceType::Raster) {
             new_tile.data = std::make_shared<RasterTileData>(normalized_id, texturePool, info);
             new_tile.data->request(
-                style.workers, transformState.getPixelRatio(), callback);
+                style.workers, transformState.getPixelRatio(), priority, callback);
         } else if (info.type == SourceType::Annotations) {
             new_tile.data = std::make_shared<LiveTileData>(normalized_id, data.annotationManager,
                                                            style, glyphAtlas,
                                                            glyphStore, spriteAtlas, sprite, info,
                                                            transformState.getAngle(), data.getCollisionDebug());
-            new_tile.data->reparse(style.workers, callback);
+            new_tile.data->reparse(style.workers, priority, callback);
         } else {
             throw std::runtime_error("source type not implemented");
         }
@@ -352,6 +365,23 @@ std::forward_list<TileID> Source::coveringTiles(const TransformState& state) con
     return covering_tiles;
 }
 
+/**
+ * Compute the parsing priority of a tile. Lower values are parsed first.
+ *
+ * @param id The tile ID that we should compute the priority for.
+ * @param state The transform state the tile is going to be rendered with.
+ * @param visible Whether the tile is one of the tiles covering the viewport.
+ *
+ * @return double The distance from the tile center to the viewport center, in
+ *         tiles, plus the distance from the ideal zoom level. Tiles that aren't
+ *         visible are ordered after all visible tiles.
+ */
+double Source::getTilePriority(const TileID& id, const TransformState& state, bool visible) const {
+    const vec2<double> center = state.cornersToBox(id.sourceZ).center;
+    return std::fabs(id.x + 0.5 - center.x) + std::fabs(id.y + 0.5 - center.y) +
+           std::fabs(getZoom(state) - id.z) + (visible ? 0 : util::hiddenTilePriority);
+}
+
 /**
  * Recursively find children of the given tile that are already loaded.
  *
@@ -431,11 +461,12 @@ bool Source::update(MapData& data,
     // Add existing child/parent tiles if the actual tile is not yet loaded
     for (const auto& id : required) {
         TileData::State state = hasTile(id);
+        const double priority = getTilePriority(id, transformState);
 
         switch (state) {
         case TileData::State::partial:
             if (shouldReparsePartialTiles) {
-                if (!handlePartialTile(id, style.workers)) {
+                if (!handlePartialTile(id, style.workers, priority)) {
                     allTilesUpdated = false;
                 }
             }
@@ -444,6 +475,12 @@ bool Source::update(MapData& data,
             state = addTile(data, transformState, style, glyphAtlas, glyphStore,
                             spriteAtlas, sprite, texturePool, id);
             break;
+        case TileData::State::loading:
+        case TileData::State::loaded:
+            // The viewport moved since parsing was scheduled, so tiles that are
+            // now closer to the center should be parsed first.
+            tiles.find(id)->second->data->setPriority(priority);
+            break;
         default:
             break;
         }
@@ -464,12 +501,15 @@ bool Source::update(MapData& data,
         }
     }
 
-    if (info.type != SourceType::Raster && cache.getSize() == 0) {
-        size_t conservativeCacheSize = ((float)transformState.getWidth()  / util::tileSize) *
-                                       ((float)transformState.getHeight() / util::tileSize) *
-                                       (data.transform.getMaxZoom() - data.transform.getMinZoom() + 1) *
-                                       0.5;
-        cache.setSize(conservativeCacheSize);
+    // Fallback tiles may still have work pending, e.g. partial tiles that are waiting to be
+    // parsed again. That work shouldn't hold up the tiles that are actually visible.
+    for (const auto& id : retain) {
+        if (std::find(required.begin(), required.end(), id) == required.end()) {
+            auto it = tiles.find(id);
+            if (it != tiles.end() && it->second->data) {
+                it->second->data->setPriority(getTilePriority(id, transformState, false));
+            }
+        }
     }
 
     auto& tileCache = cache;
@@ -478,7 +518,7 @@ bool Source::update(MapData& data,
     // Remove tiles that we definitely don't need, i.e. tiles that are not on
     // the required list.
     std::set<TileID> retain_data;
-    util::erase_if(tiles, [&retain, &retain_data, &tileCache, &type](std::pair<const TileID, std::unique_ptr<Tile>> &pair) {
+    util::erase_if(tiles, [&](std::pair<const TileID, std::unique_ptr<Tile>> &pair) {
         Tile &tile = *pair.second;
         bool obsolete = std::find(retain.begin(), retain.end(), tile.id) == retain.end();
         if (!obsolete) {
@@ -488,6 +528,7 @@ bool Source::update(MapData& data,
             // they never get updated if the go out from the viewport and the pending
             // resources arrive.
             tileCache.add(tile.id.normalized().to_uint64(), tile.data);
+            tile.data->setPriority(getTilePriority(tile.id, transformState, false));
         }
         return obsolete;
     });
@@ -530,6 +571,94 @@ void Source::invalidateTiles(const std::vector<TileID>& ids) {
     updateTilePtrs();
 }
 
+void Source::prefetch(const std::vector<TransformState>& path) {
+    if (path.empty() || !maxPrefetchRequests) {
+        cancelPrefetching();
+        prefetched.clear();
+        prefetchedBytes = 0;
+        return;
+    }
+
+    if (!loaded || (info.type != SourceType::Vector && info.type != SourceType::Raster)) {
+        return;
+    }
+
+    // The tiles that are missing along the path, in the order the map is expected to reach them.
+    std::vector<TileID> missing;
+    std::set<TileID> wanted;
+    for (const auto& state : path) {
+        for (const auto& id : coveringTiles(state)) {
+            const TileID normalized_id = id.normalized();
+            if (wanted.count(normalized_id) || prefetched.count(normalized_id) ||
+                cache.has(normalized_id.to_uint64())) {
+                continue;
+            }
+            auto it = tile_data.find(normalized_id);
+            if (it != tile_data.end() && !it->second.expired()) {
+                continue;
+            }
+            wanted.insert(normalized_id);
+            missing.push_back(normalized_id);
+        }
+    }
+
+    // Tiles that left the path, or that are in use by now, aren't prefetched anymore.
+    for (auto it = prefetching.begin(); it != prefetching.end();) {
+        if (wanted.count(it->first)) {
+            ++it;
+        } else {
+            Environment::Get().cancelRequest(it->second);
+            it = prefetching.erase(it);
+        }
+    }
+
+    const float pixelRatio = path.front().getPixelRatio();
+    for (std::size_t i = 0; i < missing.size(); i++) {
+        if (prefetching.size() >= maxPrefetchRequests || prefetchedBytes >= maxPrefetchBytes) {
+            break;
+        }
+
+        const TileID id = missing[i];
+        if (prefetching.count(id)) {
+            continue;
+        }
+
+        Request* request = Environment::Get().request({ Resource::Kind::Tile, info.tileURL(id, pixelRatio) },
+                                                      [this, id](const Response& res) {
+            prefetching.erase(id);
+            prefetched.insert(id);
+
+            if (res.status != Response::Successful) {
+                return;
+            }
+            prefetchedBytes += res.data.size();
+
+            // The tile may have become visible while it was prefetched, in which case it
+            // received the same response.
+            auto it = tile_data.find(id);
+            if (info.type == SourceType::Vector && (it == tile_data.end() || it->second.expired())) {
+                cache.addData(id.to_uint64(), res.data);
+            }
+        });
+
+        // Prefetching is ordered after all visible and hidden tiles.
+        Environment::Get().setRequestPriority(request, util::prefetchTilePriority + i);
+        prefetching.emplace(id, request);
+    }
+}
+
+void Source::setPrefetchBudget(size_t requests, size_t bytes) {
+    maxPrefetchRequests = requests;
+    maxPrefetchBytes = bytes;
+}
+
+void Source::cancelPrefetching() {
+    for (const auto& pair : prefetching) {
+        Environment::Get().cancelRequest(pair.second);
+    }
+    prefetching.clear();
+}
+
 void Source::updateTilePtrs() {
     tilePtrs.clear();
     for (const auto& pair : tiles) {
@@ -541,10 +670,46 @@ void Source::setCacheSize(size_t size) {
     cache.setSize(size);
 }
 
-void Source::onLowMemory() {
+void Source::setCacheBudget(size_t bytes) {
+    cache.setMaxBytes(bytes);
+}
+
+void Source::setCompressedCacheBudget(size_t bytes) {
+    cache.setMaxCompressedBytes(bytes);
+}
+
+void Source::setCacheWorker(Worker* worker) {
+    cache.setWorker(worker);
+}
+
+const TileCacheStats& Source::getCacheStats() const {
+    return cache.getStats();
+}
+
+const TileCacheStats& Source::getCompressedCacheStats() const {
+    return cache.getCompressedStats();
+}
+
+void Source::trimCache(size_t bytes) {
+    cache.trim(bytes);
+}
+
+void Source::clearCache() {
     cache.clear();
 }
 
+size_t Source::getMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& pair : tile_data) {
+        const auto data = pair.second.lock();
+        // Tiles that are still being parsed are modified by the workers.
+        if (data && data->getState() == TileData::State::parsed) {
+            bytes += data->getMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 void Source::setObserver(Observer* observer) {
     observer_ = observer;
 }
@@ -17,6 +17,8 @@
 #include <forward_list>
 #include <iosfwd>
 #include <map>
+#include <set>
+#include <vector>
 
 namespace mbgl {
 
@@ -88,6 +90,15 @@ public:
 
     void invalidateTiles(const std::vector<TileID>&);
 
+    // Requests the tiles along the predicted path of the map ahead of time, after all the
+    // tiles that are visible. Prefetched vector tiles are kept in the compressed tier of the
+    // tile cache, while other tiles are only loaded into the cache of the file source. An
+    // empty path means that the map came to rest, which cancels all prefetching.
+    void prefetch(const std::vector<TransformState>& path);
+    // Limits the prefetch requests in flight, and the bytes that are prefetched until the
+    // map comes to rest. 0 requests disable prefetching.
+    void setPrefetchBudget(size_t requests, size_t bytes);
+
     void updateMatrices(const mat4 &projMatrix, const TransformState &transform);
     void drawClippingMasks(Painter &painter);
     void finishRender(Painter &painter);
@@ -96,7 +107,18 @@ public:
     const std::vector<Tile*>& getTiles() const;
 
     void setCacheSize(size_t);
-    void onLowMemory();
+    void setCacheBudget(size_t bytes);
+    void setCompressedCacheBudget(size_t bytes);
+    // The worker pool that the data of evicted and prefetched tiles is compressed on.
+    void setCacheWorker(Worker*);
+    const TileCacheStats& getCacheStats() const;
+    const TileCacheStats& getCompressedCacheStats() const;
+    void trimCache(size_t bytes);
+    void clearCache();
+
+    // The estimated memory footprint of the parsed tiles that are in use. Cached tiles
+    // are accounted for in the cache stats.
+    size_t getMemoryUsage() const;
 
     void setObserver(Observer* observer);
 
@@ -111,11 +133,12 @@ private:
     void emitTileLoaded(bool isNewTile);
     void emitTileLoadingFailed(const std::string& message);
 
-    bool handlePartialTile(const TileID &id, Worker &worker);
+    bool handlePartialTile(const TileID &id, Worker &worker, double priority);
     bool findLoadedChildren(const TileID& id, int32_t maxCoveringZoom, std::forward_list<TileID>& retain);
     bool findLoadedParent(const TileID& id, int32_t minCoveringZoom, std::forward_list<TileID>& retain);
     int32_t coveringZoomLevel(const TransformState&) const;
     std::forward_list<TileID> coveringTiles(const TransformState&) const;
+    double getTilePriority(const TileID&, const TransformState&, bool visible = true) const;
 
     TileData::State addTile(MapData&,
                             const TransformState&,
@@ -129,6 +152,7 @@ private:
 
     TileData::State hasTile(const TileID& id);
     void updateTilePtrs();
+    void cancelPrefetching();
 
     double getZoom(const TransformState &state) const;
 
@@ -144,6 +168,14 @@ private:
 
     Request* req = nullptr;
     Observer* observer_ = nullptr;
+
+    // The requests of tiles that are being prefetched, and the tiles that were prefetched
+    // since the map started moving.
+    std::map<TileID, Request*> prefetching;
+    std::set<TileID> prefetched;
+    size_t prefetchedBytes = 0;
+    size_t maxPrefetchRequests = util::prefetchRequests;
+    size_t maxPrefetchBytes = util::prefetchBytes;
 };
 
 }
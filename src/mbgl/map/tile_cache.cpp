@@ -1,52 +1,50 @@
 #include <mbgl/map/tile_cache.hpp>
 
+#include <algorithm>
 #include <cassert>
 
 namespace mbgl {
 
-void TileCache::setSize(size_t size_) {
-    size = size_;
-
-    while (orderedKeys.size() > size) {
-        auto key = orderedKeys.front();
-        orderedKeys.pop_front();
-        tiles.erase(key);
-    }
-
-    assert(orderedKeys.size() <= size);
+void TileCache::setSize(size_t maxTiles_) {
+    maxTiles = maxTiles_;
+    evict();
+}
 
-    tiles.reserve(size);
+void TileCache::setMaxBytes(size_t maxBytes_) {
+    maxBytes = maxBytes_;
+    evict();
 }
 
 void TileCache::add(uint64_t key, std::shared_ptr<TileData> data) {
-
-    // insert new or query existing data
-    if (tiles.emplace(key, data).second) {
-        // remove existing data key
-        orderedKeys.remove(key);
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // Refresh the existing data, which becomes the most recently used.
+        erase(it);
     }
 
-    // (re-)insert data key as newest
+    // Tiles are immutable once they are cached, so their size doesn't change.
+    const size_t bytes = data->getMemoryUsage();
     orderedKeys.push_back(key);
+    tiles.emplace(key, Entry { std::move(data), std::prev(orderedKeys.end()), bytes });
 
-    // purge oldest key/data if necessary
-    if (orderedKeys.size() > size) {
-        get(orderedKeys.front());
-    }
+    stats.tiles = tiles.size();
+    stats.bytes += bytes;
 
-    assert(orderedKeys.size() <= size);
+    evict();
+    stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
 };
 
 std::shared_ptr<TileData> TileCache::get(uint64_t key) {
-
     std::shared_ptr<TileData> data;
 
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        data = it->second;
-        tiles.erase(it);
-        orderedKeys.remove(key);
+        data = it->second.data;
+        erase(it);
         assert(data->isReady());
+        stats.hits++;
+    } else {
+        stats.misses++;
     }
 
     return data;
@@ -59,6 +57,37 @@ bool TileCache::has(uint64_t key) {
 void TileCache::clear() {
     orderedKeys.clear();
     tiles.clear();
+    stats.tiles = 0;
+    stats.bytes = 0;
+    compressed.clear();
+}
+
+void TileCache::trim(size_t bytes) {
+    // Evicted tiles move to the compressed tier, where they take up less room, so the
+    // compressed tier only needs to be trimmed once there are no tiles left to evict.
+    while (!orderedKeys.empty() && stats.bytes + compressed.getStats().bytes > bytes) {
+        evictFront();
+    }
+    compressed.trim(bytes - std::min(bytes, stats.bytes));
+}
+
+void TileCache::erase(std::unordered_map<uint64_t, Entry>::iterator it) {
+    stats.bytes -= it->second.bytes;
+    orderedKeys.erase(it->second.position);
+    tiles.erase(it);
+    stats.tiles = tiles.size();
+}
+
+void TileCache::evict() {
+    while (!orderedKeys.empty() && (stats.bytes > maxBytes || (maxTiles && orderedKeys.size() > maxTiles))) {
+        evictFront();
+    }
+}
+
+void TileCache::evictFront() {
+    auto it = tiles.find(orderedKeys.front());
+    compressed.add(it->first, it->second.data->getData());
+    erase(it);
 }
 
 };
@@ -2,27 +2,78 @@
 #define MBGL_MAP_TILE_CACHE
 
 #include <mbgl/map/tile_data.hpp>
+#include <mbgl/map/tile_cache_stats.hpp>
+#include <mbgl/map/compressed_tile_cache.hpp>
+#include <mbgl/util/constants.hpp>
 
 #include <list>
 #include <unordered_map>
 
 namespace mbgl {
 
+// Keeps the most recently used tiles within a byte budget, and optionally a maximum
+// number of tiles. The memory footprint of a tile is measured when it is added.
+//
+// Evicted tiles move to a second tier which only keeps their compressed raw data, so
+// that they don't have to be loaded again, but only parsed, when they come back.
 class TileCache {
 public:
-    TileCache(size_t size_ = 0) : size(size_) {}
+    TileCache(size_t maxBytes_, size_t maxTiles_ = 0)
+        : maxBytes(maxBytes_), maxTiles(maxTiles_) {}
+
+    // A maximum number of tiles of 0 means that only the byte budget applies.
+    void setSize(size_t maxTiles);
+    size_t getSize() const { return maxTiles; };
+
+    void setMaxBytes(size_t);
+    size_t getMaxBytes() const { return maxBytes; }
+
+    // A budget of 0 disables the compressed tier.
+    void setMaxCompressedBytes(size_t bytes) { compressed.setMaxBytes(bytes); }
+    size_t getMaxCompressedBytes() const { return compressed.getMaxBytes(); }
+
+    // The worker pool that the data of evicted tiles is compressed on.
+    void setWorker(Worker* worker) { compressed.setWorker(worker); }
 
-    void setSize(size_t);
-    size_t getSize() const { return size; };
     void add(uint64_t key, std::shared_ptr<TileData> data);
     std::shared_ptr<TileData> get(uint64_t key);
     bool has(uint64_t key);
     void clear();
+
+    // Returns the raw data of a tile that was evicted, if the compressed tier still has it.
+    mapbox::util::optional<std::string> getData(uint64_t key) { return compressed.get(key); }
+
+    // Keeps the raw data of a tile that was loaded before it is needed in the compressed tier.
+    void addData(uint64_t key, const std::string& data) { compressed.add(key, data); }
+
+    // Evicts the least recently used tiles until at most the given number of bytes is
+    // left in both tiers, without changing the budgets.
+    void trim(size_t bytes);
+
+    const TileCacheStats& getStats() const { return stats; }
+    const TileCacheStats& getCompressedStats() const { return compressed.getStats(); }
+
 private:
-    std::unordered_map<uint64_t, std::shared_ptr<TileData>> tiles;
+    struct Entry {
+        std::shared_ptr<TileData> data;
+        std::list<uint64_t>::iterator position;
+        size_t bytes;
+    };
+
+    void erase(std::unordered_map<uint64_t, Entry>::iterator);
+    void evict();
+    void evictFront();
+
+    std::unordered_map<uint64_t, Entry> tiles;
+
+    // Least recently used keys first.
     std::list<uint64_t> orderedKeys;
 
-    size_t size;
+    size_t maxBytes;
+    size_t maxTiles;
+    TileCacheStats stats;
+
+    CompressedTileCache compressed { util::compressedTileCacheBytes };
 };
 
 };
@@ -39,9 +39,11 @@ void TileData::setState(const State& state_) {
 
 void TileData::request(Worker& worker,
                        float pixelRatio,
+                       double priority_,
                        const std::function<void()>& callback) {
     std::string url = source.tileURL(id, pixelRatio);
     state = State::loading;
+    priority = priority_;
 
     req = env.request({ Resource::Kind::Tile, url }, [url, callback, &worker, this](const Response &res) {
         req = nullptr;
@@ -54,12 +56,17 @@ void TileData::request(Worker& worker,
             return;
         }
 
-        state = State::loaded;
-        data = res.data;
-
-        // Schedule tile parsing in another thread
-        reparse(worker, callback);
+        load(worker, res.data, res.downloaded, priority, callback);
     });
+    env.setRequestPriority(req, priority);
+}
+
+void TileData::load(Worker& worker, std::string data_, bool, double priority_, const std::function<void()>& callback) {
+    state = State::loaded;
+    data = std::move(data_);
+
+    // Schedule tile parsing in another thread
+    reparse(worker, priority_, callback);
 }
 
 void TileData::cancel() {
@@ -81,15 +88,31 @@ void TileData::endParsing() {
     parsing.clear(std::memory_order_release);
 }
 
-bool TileData::reparse(Worker& worker, std::function<void()> callback) {
+bool TileData::reparse(Worker& worker, double priority_, std::function<void()> callback) {
+    priority = priority_;
+
     if (!mayStartParsing()) {
         return false;
     }
 
-    workRequest = worker.send([this] { parse(); endParsing(); }, callback);
+    workRequest = worker.send([this] { parse(); endParsing(); }, callback, priority);
     return true;
 }
 
+void TileData::setPriority(double priority_) {
+    if (req && priority_ != priority) {
+        env.setRequestPriority(req, priority_);
+    }
+    priority = priority_;
+    if (workRequest) {
+        workRequest->setPriority(priority);
+    }
+}
+
+size_t TileData::getMemoryUsage() const {
+    return sizeof(*this) + data.size();
+}
+
 void TileData::setError(const std::string& message) {
     error = message;
     setState(State::obsolete);
@@ -78,13 +78,29 @@ public:
     TileData(const TileID&, const SourceInfo&);
     ~TileData();
 
-    void request(Worker&, float pixelRatio, const std::function<void()>& callback);
+    // Request the tile data and schedule parsing on a worker thread once it
+    // arrives. Requests and parsing work with a lower priority value are started
+    // first (see "setPriority()").
+    void request(Worker&, float pixelRatio, double priority, const std::function<void()>& callback);
+
+    // Schedule parsing of tile data that is already available, e.g. because it was
+    // cached, instead of requesting it. `fetched` is true if the data was just downloaded,
+    // in which case nothing derived from it can be cached yet.
+    virtual void load(Worker&, std::string data, bool fetched, double priority, const std::function<void()>& callback);
 
     // Schedule a tile reparse on a worker thread and call the callback on
     // completion. It will return true if the work was schedule or false it was
     // not, which can occur if the tile is already being parsed by another
     // worker (see "mayStartParsing()").
-    bool reparse(Worker&, std::function<void ()> callback);
+    bool reparse(Worker&, double priority, std::function<void ()> callback);
+
+    // Updates the priority of the pending request, and of pending and future
+    // parsing work for this tile, e.g. when the tile moved closer to the
+    // viewport center.
+    void setPriority(double priority);
+    inline double getPriority() const {
+        return priority;
+    }
 
     void cancel();
     const std::string toString() const;
@@ -122,6 +138,13 @@ public:
 
     virtual void redoPlacement(float, bool) {}
 
+    // Returns an estimate of the memory used by this tile.
+    virtual size_t getMemoryUsage() const;
+
+    // The raw data of the tile once it was loaded, or an empty string for tiles that are
+    // not loaded from a file source.
+    const std::string& getData() const { return data; }
+
     const TileID id;
     const std::string name;
     std::atomic_flag parsing = ATOMIC_FLAG_INIT;
@@ -142,6 +165,7 @@ protected:
     std::string data;
 
     std::unique_ptr<WorkRequest> workRequest;
+    double priority = 0;
 
 private:
     std::atomic<State> state;
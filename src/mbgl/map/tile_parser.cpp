@@ -2,15 +2,23 @@
 #include <mbgl/map/vector_tile_data.hpp>
 #include <mbgl/platform/log.hpp>
 #include <mbgl/style/style_layer.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/map/source.hpp>
 #include <mbgl/map/sprite.hpp>
 #include <mbgl/renderer/fill_bucket.hpp>
 #include <mbgl/renderer/line_bucket.hpp>
 #include <mbgl/renderer/symbol_bucket.hpp>
+#include <mbgl/util/binary.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/worker.hpp>
 #include <mbgl/style/style.hpp>
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
 #include <locale>
+#include <set>
+#include <unordered_map>
 
 namespace mbgl {
 
@@ -42,32 +50,128 @@ bool TileParser::obsolete() const {
 }
 
 void TileParser::parse() {
-    for (const auto& layer_desc : style.layers) {
-        // Cancel early when parsing.
-        if (obsolete()) {
-            return;
-        }
+    // Fill and line buckets don't depend on each other, so all of them that use the same
+    // source layer are created in a single pass over its features. All other buckets are
+    // created afterwards in style order, because that order determines text collisions.
+    SourceLayers sourceLayers;
+    std::vector<const StyleLayer*> orderedLayers;
+
+    // Whether this parse creates all fill and line buckets of the style, which is the case
+    // unless a partial tile is parsed again. Only then are they cached, since any bucket that
+    // is missing from the cached ones is taken to have no data.
+    bool allGeometryBuckets = true;
 
+    for (const auto& layer_desc : style.layers) {
         if (layer_desc->isBackground()) {
             // background is a special, fake bucket
             continue;
         }
 
-        if (layer_desc->bucket) {
-            // This is a singular layer. Check if this bucket already exists. If not,
-            // parse this bucket.
-            if (tile.getBucket(*layer_desc)) {
-                continue;
+        if (!layer_desc->bucket) {
+            Log::Warning(Event::ParseTile, "layer '%s' does not have buckets", layer_desc->id.c_str());
+            continue;
+        }
+
+        // This is a singular layer. Check if this bucket already exists. If not,
+        // parse this bucket.
+        const StyleBucket& bucketDesc = *layer_desc->bucket;
+        if (tile.getBucket(*layer_desc)) {
+            if (bucketDesc.type == StyleLayerType::Fill || bucketDesc.type == StyleLayerType::Line) {
+                allGeometryBuckets = false;
             }
+            continue;
+        }
+
+        if (bucketDesc.type != StyleLayerType::Fill && bucketDesc.type != StyleLayerType::Line) {
+            orderedLayers.push_back(layer_desc.get());
+            continue;
+        }
+
+        if (!isVisible(bucketDesc)) {
+            continue;
+        }
 
-            std::unique_ptr<Bucket> bucket = createBucket(*layer_desc->bucket);
-            if (bucket) {
-                // Bucket creation might fail because the data tile may not
-                // contain any data that falls into this bucket.
-                tile.setBucket(*layer_desc, std::move(bucket));
+        auto it = std::find_if(sourceLayers.begin(), sourceLayers.end(), [&](const auto& sourceLayer) {
+            return sourceLayer.first == bucketDesc.source_layer;
+        });
+        if (it == sourceLayers.end()) {
+            it = sourceLayers.emplace(sourceLayers.end(), bucketDesc.source_layer, std::vector<const StyleLayer*>());
+        }
+
+        // Style layers may share a bucket, which only needs to be created once.
+        auto& layers = it->second;
+        if (std::none_of(layers.begin(), layers.end(), [&](const StyleLayer* layer) {
+                return layer->bucket->name == bucketDesc.name;
+            })) {
+            layers.push_back(layer_desc.get());
+        }
+    }
+
+    // The fill and line buckets may have been cached when the same data was parsed with
+    // the same style before, in which case their geometries only need to be copied.
+    if (!sourceLayers.empty() && !(allGeometryBuckets && restoreGeometryBuckets(sourceLayers))) {
+        // The buckets of different source layers don't share any state, so they are created
+        // by parallel tasks on the worker pool, each of which takes source layers until none
+        // are left. Only the symbol buckets below need to be created in order.
+        Worker& workers = tile.style.workers;
+        const std::size_t taskCount = std::min(sourceLayers.size(), workers.size());
+        std::vector<std::unique_ptr<VectorTileData::BucketBuffers>> buffers;
+        std::vector<std::unique_ptr<GeometryTask>> tasks;
+        for (std::size_t i = 0; i < taskCount; i++) {
+            buffers.emplace_back(std::make_unique<VectorTileData::BucketBuffers>());
+            tasks.emplace_back(std::make_unique<GeometryTask>(*buffers.back()));
+        }
+
+        // The buckets that were created refer to the buffers, so they are handed to the
+        // tile even if parsing was canceled or failed.
+        const auto addBucketBuffers = [&] {
+            for (auto& taskBuffers : buffers) {
+                tile.addBucketBuffers(std::move(taskBuffers));
             }
-        } else {
-            Log::Warning(Event::ParseTile, "layer '%s' does not have buckets", layer_desc->id.c_str());
+        };
+
+        std::atomic<std::size_t> next { 0 };
+        try {
+            workers.parallel(taskCount, [&](std::size_t task) {
+                for (std::size_t i = next++; i < sourceLayers.size(); i = next++) {
+                    // Cancel early when parsing.
+                    if (obsolete()) {
+                        return;
+                    }
+
+                    const auto& sourceLayer = sourceLayers[i];
+                    auto layer = geometryTile.getLayer(sourceLayer.first);
+                    if (layer) {
+                        createGeometryBuckets(*tasks[task], *layer, sourceLayer.second);
+                    } else if (debug::tileParseWarnings) {
+                        // The layer specified in the bucket does not exist. Do nothing.
+                        Log::Warning(Event::ParseTile, "layer '%s' does not exist in tile %d/%d/%d",
+                                sourceLayer.first.c_str(), tile.id.z, tile.id.x, tile.id.y);
+                    }
+                }
+            }, tile.getPriority());
+        } catch (...) {
+            addBucketBuffers();
+            throw;
+        }
+        addBucketBuffers();
+
+        if (allGeometryBuckets && !obsolete() && !tile.bucketsURL.empty()) {
+            serializeGeometryBuckets(sourceLayers, tasks);
+        }
+    }
+
+    for (const StyleLayer* layer_desc : orderedLayers) {
+        // Cancel early when parsing.
+        if (obsolete()) {
+            return;
+        }
+
+        std::unique_ptr<Bucket> bucket = createBucket(*layer_desc->bucket);
+        if (bucket) {
+            // Bucket creation might fail because the data tile may not
+            // contain any data that falls into this bucket.
+            tile.setBucket(*layer_desc, std::move(bucket));
         }
     }
 }
@@ -104,19 +208,20 @@ void applyLayoutProperty(PropertyKey key, const ClassProperties &classProperties
     }
 }
 
-std::unique_ptr<Bucket> TileParser::createBucket(const StyleBucket &bucketDesc) {
+bool TileParser::isVisible(const StyleBucket& bucketDesc) const {
     // Skip this bucket if we are to not render this
-    if (tile.id.z < std::floor(bucketDesc.min_zoom) && std::floor(bucketDesc.min_zoom) < tile.source.max_zoom) return nullptr;
-    if (tile.id.z >= std::ceil(bucketDesc.max_zoom)) return nullptr;
-    if (bucketDesc.visibility == mbgl::VisibilityType::None) return nullptr;
+    if (tile.id.z < std::floor(bucketDesc.min_zoom) && std::floor(bucketDesc.min_zoom) < tile.source.max_zoom) return false;
+    if (tile.id.z >= std::ceil(bucketDesc.max_zoom)) return false;
+    if (bucketDesc.visibility == mbgl::VisibilityType::None) return false;
+    return true;
+}
+
+std::unique_ptr<Bucket> TileParser::createBucket(const StyleBucket &bucketDesc) {
+    if (!isVisible(bucketDesc)) return nullptr;
 
     auto layer = geometryTile.getLayer(bucketDesc.source_layer);
     if (layer) {
-        if (bucketDesc.type == StyleLayerType::Fill) {
-            return createFillBucket(*layer, bucketDesc);
-        } else if (bucketDesc.type == StyleLayerType::Line) {
-            return createLineBucket(*layer, bucketDesc);
-        } else if (bucketDesc.type == StyleLayerType::Symbol) {
+        if (bucketDesc.type == StyleLayerType::Symbol) {
             return createSymbolBucket(*layer, bucketDesc);
         } else if (bucketDesc.type == StyleLayerType::Raster) {
             return nullptr;
@@ -135,46 +240,275 @@ std::unique_ptr<Bucket> TileParser::createBucket(const StyleBucket &bucketDesc)
     return nullptr;
 }
 
-template <class Bucket>
-void TileParser::addBucketGeometries(Bucket& bucket, const GeometryTileLayer& layer, const FilterExpression &filter) {
-    for (std::size_t i = 0; i < layer.featureCount(); i++) {
+struct TileParser::GeometryTask {
+    GeometryTask(VectorTileData::BucketBuffers& buffers_)
+        : buffers(buffers_) {}
+
+    VectorTileData::BucketBuffers& buffers;
+
+    // The buckets that were created with the buffers, serialized.
+    std::string serializedBuckets;
+    uint32_t bucketCount = 0;
+
+    // Reused for decoding the properties and geometries of all features of the task.
+    GeometryTileProperties properties;
+    GeometryBuffer geometryBuffer;
+
+    // Geometries of features that are added to more than one bucket of a source layer.
+    std::vector<std::unique_ptr<GeometryBuffer>> sharedGeometries;
+};
+
+void TileParser::createGeometryBuckets(GeometryTask& task,
+                                       const GeometryTileLayer& layer,
+                                       const std::vector<const StyleLayer*>& layers) {
+    struct Target {
+        const StyleLayer& layer;
+        const CompiledFilter filter;
+        std::vector<std::size_t> features;
+    };
+
+    std::vector<Target> targets;
+    for (const StyleLayer* layer_desc : layers) {
+        targets.push_back({ *layer_desc, CompiledFilter(layer_desc->bucket->filter, layer), {} });
+    }
+
+    // Decode the properties of every feature once, and match them against all filters.
+    const std::size_t featureCount = layer.featureCount();
+    std::vector<uint32_t> matches(featureCount, 0);
+
+    for (std::size_t i = 0; i < featureCount; i++) {
+        if (obsolete())
+            return;
+
         auto feature = layer.getFeature(i);
+        feature->readProperties(task.properties);
+        for (auto& target : targets) {
+            if (target.filter.evaluate(*feature, task.properties)) {
+                target.features.push_back(i);
+                matches[i]++;
+            }
+        }
+    }
 
+    // Buckets allocate their vertices from buffers that are shared by all buckets of the
+    // task, and require them to be contiguous, so buckets are filled one after another.
+    // Features that go into more than one bucket are decoded once up front, and kept
+    // until all buckets are filled. The others are decoded when they are added.
+    const std::size_t unshared = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> shared(featureCount, unshared);
+    std::size_t sharedCount = 0;
+
+    for (std::size_t i = 0; i < featureCount; i++) {
+        if (matches[i] > 1) {
+            if (task.sharedGeometries.size() == sharedCount) {
+                task.sharedGeometries.emplace_back(std::make_unique<GeometryBuffer>());
+            }
+            layer.getFeature(i)->readGeometries(*task.sharedGeometries[sharedCount]);
+            shared[i] = sharedCount++;
+        }
+    }
+
+    auto geometries = [&](std::size_t i) -> const GeometryBuffer& {
+        if (shared[i] != unshared) {
+            return *task.sharedGeometries[shared[i]];
+        }
+        layer.getFeature(i)->readGeometries(task.geometryBuffer);
+        return task.geometryBuffer;
+    };
+
+    // Buckets are only serialized if the file source can store them.
+    const bool serialize = !tile.bucketsURL.empty();
+
+    for (const auto& target : targets) {
         if (obsolete())
             return;
 
-        GeometryTileFeatureExtractor extractor(*feature);
-        if (!evaluate(filter, extractor))
-            continue;
+        const StyleBucket& bucketDesc = *target.layer.bucket;
+        std::unique_ptr<Bucket> bucket;
+        util::BinaryWriter writer(task.serializedBuckets);
+
+        // Bucket creation might fail because the data tile may not
+        // contain any data that falls into this bucket.
+        if (bucketDesc.type == StyleLayerType::Fill) {
+            auto fillBucket = createFillBucket(task, bucketDesc);
+            addBucketGeometries(*fillBucket, target.features, geometries);
+            if (fillBucket->hasData()) {
+                if (serialize) {
+                    writer.writeString(bucketDesc.name);
+                    fillBucket->serialize(writer);
+                }
+                bucket = std::move(fillBucket);
+            }
+        } else {
+            auto lineBucket = createLineBucket(task, bucketDesc);
+            addBucketGeometries(*lineBucket, target.features, geometries);
+            if (lineBucket->hasData()) {
+                if (serialize) {
+                    writer.writeString(bucketDesc.name);
+                    lineBucket->serialize(writer);
+                }
+                bucket = std::move(lineBucket);
+            }
+        }
 
-        bucket->addGeometry(feature->getGeometries());
+        if (bucket) {
+            task.bucketCount++;
+            tile.setBucket(target.layer, std::move(bucket));
+        }
     }
 }
 
-std::unique_ptr<Bucket> TileParser::createFillBucket(const GeometryTileLayer& layer,
-                                                     const StyleBucket& bucket_desc) {
-    auto bucket = std::make_unique<FillBucket>(tile.fillVertexBuffer,
-                                                tile.triangleElementsBuffer,
-                                                tile.lineElementsBuffer);
-    addBucketGeometries(bucket, layer, bucket_desc.filter);
-    return bucket->hasData() ? std::move(bucket) : nullptr;
+template <class Bucket, class Geometries>
+void TileParser::addBucketGeometries(Bucket& bucket, const std::vector<std::size_t>& features,
+                                     const Geometries& geometries) {
+    for (std::size_t i : features) {
+        if (obsolete())
+            return;
+
+        bucket.addGeometry(geometries(i));
+    }
 }
 
-std::unique_ptr<Bucket> TileParser::createLineBucket(const GeometryTileLayer& layer,
-                                                     const StyleBucket& bucket_desc) {
-    auto bucket = std::make_unique<LineBucket>(tile.lineVertexBuffer,
-                                                tile.triangleElementsBuffer);
+std::unique_ptr<FillBucket> TileParser::createFillBucket(GeometryTask& task, const StyleBucket&) {
+    return std::make_unique<FillBucket>(task.buffers.fillVertexBuffer,
+                                        task.buffers.triangleElementsBuffer,
+                                        task.buffers.lineElementsBuffer);
+}
 
+std::unique_ptr<LineBucket> TileParser::createLineBucket(GeometryTask& task, const StyleBucket& bucket_desc) {
+    auto bucket = std::make_unique<LineBucket>(task.buffers.lineVertexBuffer,
+                                                task.buffers.triangleElementsBuffer);
+    applyLineLayout(*bucket, bucket_desc);
+    return bucket;
+}
+
+void TileParser::applyLineLayout(LineBucket& bucket, const StyleBucket& bucket_desc) const {
     const float z = tile.id.z;
-    auto& layout = bucket->layout;
+    auto& layout = bucket.layout;
 
     applyLayoutProperty(PropertyKey::LineCap, bucket_desc.layout, layout.cap, z);
     applyLayoutProperty(PropertyKey::LineJoin, bucket_desc.layout, layout.join, z);
     applyLayoutProperty(PropertyKey::LineMiterLimit, bucket_desc.layout, layout.miter_limit, z);
     applyLayoutProperty(PropertyKey::LineRoundLimit, bucket_desc.layout, layout.round_limit, z);
+}
 
-    addBucketGeometries(bucket, layer, bucket_desc.filter);
-    return bucket->hasData() ? std::move(bucket) : nullptr;
+// Serialized fill and line buckets start with this, followed by a hash of the tile data
+// they were created from, and the names of all buckets that were created, including those
+// without data. Change it whenever the format or the contents of the buckets change.
+static const uint32_t serializedBucketsVersion = 0x4d424202;
+
+namespace {
+
+std::set<std::string> bucketNames(const std::vector<std::pair<std::string, std::vector<const StyleLayer*>>>& sourceLayers) {
+    std::set<std::string> names;
+    for (const auto& sourceLayer : sourceLayers) {
+        for (const StyleLayer* layer : sourceLayer.second) {
+            names.insert(layer->bucket->name);
+        }
+    }
+    return names;
+}
+
+}
+
+void TileParser::serializeGeometryBuckets(const SourceLayers& sourceLayers,
+                                          const std::vector<std::unique_ptr<GeometryTask>>& tasks) {
+    util::BinaryWriter writer(serializedBuckets);
+    writer.write<uint32_t>(serializedBucketsVersion);
+    writer.write<uint64_t>(util::hash(tile.getData()));
+
+    const std::set<std::string> names = bucketNames(sourceLayers);
+    writer.write<uint32_t>(names.size());
+    for (const auto& name : names) {
+        writer.writeString(name);
+    }
+
+    writer.write<uint32_t>(tasks.size());
+    for (const auto& task : tasks) {
+        task->buffers.serialize(writer);
+        writer.write<uint32_t>(task->bucketCount);
+        writer.write(task->serializedBuckets.data(), task->serializedBuckets.size());
+    }
+}
+
+bool TileParser::restoreGeometryBuckets(const SourceLayers& sourceLayers) {
+    const std::string& cached = tile.cachedBuckets;
+    if (cached.empty()) {
+        return false;
+    }
+
+    std::unordered_map<std::string, const StyleLayer*> layers;
+    for (const auto& sourceLayer : sourceLayers) {
+        for (const StyleLayer* layer : sourceLayer.second) {
+            layers.emplace(layer->bucket->name, layer);
+        }
+    }
+
+    // Nothing is added to the tile until all buckets were read, so that the tile can still
+    // be parsed from scratch if the cached buckets turn out to be unusable.
+    std::vector<std::unique_ptr<VectorTileData::BucketBuffers>> buffers;
+    std::vector<std::pair<const StyleLayer*, std::unique_ptr<Bucket>>> buckets;
+
+    try {
+        util::BinaryReader reader(cached);
+        if (reader.read<uint32_t>() != serializedBucketsVersion ||
+            reader.read<uint64_t>() != util::hash(tile.getData())) {
+            return false;
+        }
+
+        // The cached buckets must cover the same buckets as this parse, since those that
+        // weren't cached are taken to have no data.
+        std::set<std::string> names;
+        for (auto nameCount = reader.read<uint32_t>(); nameCount > 0; nameCount--) {
+            names.insert(reader.readString());
+        }
+        if (names != bucketNames(sourceLayers)) {
+            return false;
+        }
+
+        for (auto taskCount = reader.read<uint32_t>(); taskCount > 0; taskCount--) {
+            buffers.emplace_back(std::make_unique<VectorTileData::BucketBuffers>());
+            auto& taskBuffers = *buffers.back();
+            taskBuffers.restore(reader);
+
+            for (auto bucketCount = reader.read<uint32_t>(); bucketCount > 0; bucketCount--) {
+                const auto it = layers.find(reader.readString());
+                if (it == layers.end()) {
+                    return false;
+                }
+
+                const StyleLayer& layer = *it->second;
+                if (layer.bucket->type == StyleLayerType::Fill) {
+                    buckets.emplace_back(&layer, std::make_unique<FillBucket>(taskBuffers.fillVertexBuffer,
+                                                                              taskBuffers.triangleElementsBuffer,
+                                                                              taskBuffers.lineElementsBuffer,
+                                                                              reader));
+                } else {
+                    auto bucket = std::make_unique<LineBucket>(taskBuffers.lineVertexBuffer,
+                                                               taskBuffers.triangleElementsBuffer,
+                                                               reader);
+                    applyLineLayout(*bucket, *layer.bucket);
+                    buckets.emplace_back(&layer, std::move(bucket));
+                }
+            }
+        }
+
+        if (!reader.atEnd()) {
+            return false;
+        }
+    } catch (const std::runtime_error& ex) {
+        Log::Warning(Event::ParseTile, "cached buckets of tile %d/%d/%d are invalid: %s",
+                tile.id.z, tile.id.x, tile.id.y, ex.what());
+        return false;
+    }
+
+    for (auto& taskBuffers : buffers) {
+        tile.addBucketBuffers(std::move(taskBuffers));
+    }
+    for (auto& bucket : buckets) {
+        tile.setBucket(*bucket.first, std::move(bucket.second));
+    }
+    return true;
 }
 
 std::unique_ptr<Bucket> TileParser::createSymbolBucket(const GeometryTileLayer& layer,
@@ -12,18 +12,23 @@
 
 #include <cstdint>
 #include <iosfwd>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace mbgl {
 
 class Bucket;
+class FillBucket;
 class FontStack;
 class GlyphAtlas;
 class GlyphStore;
+class LineBucket;
 class SpriteAtlas;
 class Sprite;
 class Style;
 class StyleBucket;
+class StyleLayer;
 class StyleLayoutFill;
 class StyleLayoutRaster;
 class StyleLayoutLine;
@@ -47,16 +52,38 @@ public:
         return partialParse;
     }
 
+    // The fill and line buckets that this parse created, serialized for caching. Empty if
+    // they were restored from the tile's cached buckets instead, if none were created, or
+    // if only some of them were created because a partial tile was parsed again.
+    inline const std::string& getSerializedBuckets() const {
+        return serializedBuckets;
+    }
+
 private:
     bool obsolete() const;
 
+    // The state of one of the tasks that create fill and line buckets in parallel.
+    struct GeometryTask;
+
+    // Source layer names, and the fill and line style layers that use them.
+    using SourceLayers = std::vector<std::pair<std::string, std::vector<const StyleLayer*>>>;
+
+    bool restoreGeometryBuckets(const SourceLayers&);
+    void serializeGeometryBuckets(const SourceLayers&, const std::vector<std::unique_ptr<GeometryTask>>&);
+    void applyLineLayout(LineBucket&, const StyleBucket&) const;
+
+    bool isVisible(const StyleBucket&) const;
     std::unique_ptr<Bucket> createBucket(const StyleBucket&);
-    std::unique_ptr<Bucket> createFillBucket(const GeometryTileLayer&, const StyleBucket&);
-    std::unique_ptr<Bucket> createLineBucket(const GeometryTileLayer&, const StyleBucket&);
+    std::unique_ptr<FillBucket> createFillBucket(GeometryTask&, const StyleBucket&);
+    std::unique_ptr<LineBucket> createLineBucket(GeometryTask&, const StyleBucket&);
     std::unique_ptr<Bucket> createSymbolBucket(const GeometryTileLayer&, const StyleBucket&);
 
-    template <class Bucket>
-    void addBucketGeometries(Bucket&, const GeometryTileLayer&, const FilterExpression&);
+    // Creates the fill and line buckets of the given style layers, which all use the
+    // given source layer, in a single pass over its features.
+    void createGeometryBuckets(GeometryTask&, const GeometryTileLayer&, const std::vector<const StyleLayer*>&);
+
+    template <class Bucket, class Geometries>
+    void addBucketGeometries(Bucket&, const std::vector<std::size_t>& features, const Geometries&);
 
     const GeometryTile& geometryTile;
     VectorTileData& tile;
@@ -69,6 +96,7 @@ private:
     util::ptr<Sprite> sprite;
 
     bool partialParse;
+    std::string serializedBuckets;
 };
 
 }
@@ -11,6 +11,9 @@
 
 using namespace mbgl;
 
+// Pans that are further apart than this are separate gestures, and don't add up to a velocity.
+static const Duration panVelocityTimeout = std::chrono::milliseconds(100);
+
 /** Converts the given angle (in radians) to be numerically close to the anchor angle, allowing it to be interpolated properly without sudden jumps. */
 static double _normalizeAngle(double angle, double anchorAngle)
 {
@@ -69,7 +72,17 @@ void Transform::moveBy(const double dx, const double dy, const Duration duration
     _moveBy(dx, dy, duration);
 }
 
-void Transform::_moveBy(const double dx, const double dy, const Duration duration) {
+void Transform::panBy(const double dx, const double dy, const TimePoint now) {
+    if (std::isnan(dx) || std::isnan(dy)) {
+        return;
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    _moveBy(dx, dy, Duration::zero(), now);
+}
+
+void Transform::_moveBy(const double dx, const double dy, const Duration duration, const TimePoint now) {
     // This is only called internally, so we don't need a lock here.
 
     view.notifyMapChange(duration != Duration::zero() ?
@@ -82,6 +95,7 @@ void Transform::_moveBy(const double dx, const double dy, const Duration duratio
     constrain(final.scale, final.y);
 
     if (duration == Duration::zero()) {
+        updatePanVelocity(final.x - current.x, final.y - current.y, now);
         current.x = final.x;
         current.y = final.y;
     } else {
@@ -414,6 +428,25 @@ double Transform::getAngle() const {
 }
 
 
+void Transform::updatePanVelocity(const double dx, const double dy, const TimePoint now) {
+    // This is only called internally, so we don't need a lock here.
+
+    const double seconds = isPanning(now) ? std::chrono::duration<double>(now - lastPan).count() : 0;
+    if (seconds > 0) {
+        // Gestures report movements at irregular intervals, so the velocity is smoothed.
+        panVelocity = panVelocity * 0.5 + vec2<double>(dx, dy) * (0.5 / seconds);
+    } else {
+        panVelocity = { 0, 0 };
+    }
+    lastPan = now;
+}
+
+bool Transform::isPanning(const TimePoint now) const {
+    // This is only called internally, so we don't need a lock here.
+
+    return lastPan != TimePoint::min() && now - lastPan < panVelocityTimeout;
+}
+
 #pragma mark - Transition
 
 void Transform::startTransition(std::function<Update(double)> frame,
@@ -483,3 +516,42 @@ const TransformState Transform::finalState() const {
 
     return final;
 }
+
+std::vector<TransformState> Transform::predictedPath(const Duration lookahead, const std::size_t steps,
+                                                     const TimePoint now) const {
+    std::lock_guard<std::recursive_mutex> lock(mtx);
+
+    double scale = current.scale;
+    double x = current.x;
+    double y = current.y;
+
+    if (transitionFrameFn) {
+        scale = final.scale;
+        x = final.x;
+        y = final.y;
+    } else if (isPanning(now)) {
+        const double seconds = std::chrono::duration<double>(lookahead).count();
+        x += panVelocity.x * seconds;
+        y += panVelocity.y * seconds;
+        constrain(scale, y);
+    }
+
+    if (scale == current.scale && x == current.x && y == current.y) {
+        return {};
+    }
+
+    // Transitions interpolate linearly as well, but eased. Rotations aren't predicted.
+    std::vector<TransformState> path;
+    for (std::size_t i = 1; i <= steps; i++) {
+        const double t = double(i) / steps;
+        TransformState state = current;
+        state.scale = util::interpolate(current.scale, scale, t);
+        state.x = util::interpolate(current.x, x, t);
+        state.y = util::interpolate(current.y, y, t);
+        const double s = state.scale * util::tileSize;
+        state.Bc = s / 360;
+        state.Cc = s / util::M2PI;
+        path.push_back(state);
+    }
+    return path;
+}
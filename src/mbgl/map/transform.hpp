@@ -12,6 +12,7 @@
 #include <cmath>
 #include <forward_list>
 #include <mutex>
+#include <vector>
 
 namespace mbgl {
 
@@ -29,6 +30,9 @@ public:
 
     // Position
     void moveBy(double dx, double dy, Duration = Duration::zero());
+    // Moves the map without a transition at the given time, e.g. that of the gesture event
+    // that caused the pan. moveBy() without a duration pans at the current time.
+    void panBy(double dx, double dy, TimePoint);
     void setLatLng(LatLng latLng, Duration = Duration::zero());
     void setLatLngZoom(LatLng latLng, double zoom, Duration = Duration::zero());
     inline const LatLng getLatLng() const { return current.getLatLng(); }
@@ -60,16 +64,25 @@ public:
     const TransformState currentState() const;
     const TransformState finalState() const;
 
+    // The states the map is expected to pass through, ending with the state it is expected
+    // to come to: the destination of the active transition, or where the velocity of recent
+    // pans carries the map within the lookahead time. Empty if the map isn't moving at the
+    // given time.
+    std::vector<TransformState> predictedPath(Duration lookahead, std::size_t steps, TimePoint now) const;
+
 private:
     // Functions prefixed with underscores will *not* perform any locks. It is the caller's
     // responsibility to lock this object.
-    void _moveBy(double dx, double dy, Duration = Duration::zero());
+    void _moveBy(double dx, double dy, Duration = Duration::zero(), TimePoint = Clock::now());
     void _setScale(double scale, double cx, double cy, Duration = Duration::zero());
     void _setScaleXY(double new_scale, double xn, double yn, Duration = Duration::zero());
     void _setAngle(double angle, Duration = Duration::zero());
 
     void constrain(double& scale, double& y) const;
 
+    void updatePanVelocity(double dx, double dy, TimePoint);
+    bool isPanning(TimePoint) const;
+
     View &view;
 
     mutable std::recursive_mutex mtx;
@@ -94,6 +107,11 @@ private:
     Duration transitionDuration;
     std::function<Update(TimePoint)> transitionFrameFn;
     std::function<void()> transitionFinishFn;
+
+    // The smoothed velocity of pans without a transition, e.g. by gestures, in pixels per
+    // second, and the time of the last one.
+    vec2<double> panVelocity { 0, 0 };
+    TimePoint lastPan = TimePoint::min();
 };
 
 }
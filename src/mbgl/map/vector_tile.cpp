@@ -35,11 +35,11 @@ VectorTileFeature::VectorTileFeature(pbf feature_pbf, const VectorTileLayer& lay
         if (feature_pbf.tag == 1) { // id
             id = feature_pbf.varint<uint64_t>();
         } else if (feature_pbf.tag == 2) { // tags
-            tags_pbf = feature_pbf.message();
+            tags = feature_pbf.packed<uint32_t>();
         } else if (feature_pbf.tag == 3) { // type
             type = (FeatureType)feature_pbf.varint();
         } else if (feature_pbf.tag == 4) { // geometry
-            geometry_pbf = feature_pbf.message();
+            geometry = feature_pbf.packed<uint32_t>();
         } else {
             feature_pbf.skip();
         }
@@ -52,19 +52,19 @@ mapbox::util::optional<Value> VectorTileFeature::getValue(const std::string& key
         return mapbox::util::optional<Value>();
     }
 
-    pbf tags = tags_pbf;
-    while (tags) {
-        uint32_t tag_key = tags.varint();
+    const auto end = tags.end();
+    for (auto it = tags.begin(); it != end; ++it) {
+        uint32_t tag_key = *it;
 
         if (layer.keys.size() <= tag_key) {
             throw std::runtime_error("feature referenced out of range key");
         }
 
-        if (!tags) {
+        if (++it == end) {
             throw std::runtime_error("uneven number of feature tag ids");
         }
 
-        uint32_t tag_val = tags.varint();
+        uint32_t tag_val = *it;
         if (layer.values.size() <= tag_val) {
             throw std::runtime_error("feature referenced out of range value");
         }
@@ -77,21 +77,58 @@ mapbox::util::optional<Value> VectorTileFeature::getValue(const std::string& key
     return mapbox::util::optional<Value>();
 }
 
+void VectorTileFeature::readProperties(GeometryTileProperties& properties) const {
+    properties.clear();
+
+    const auto end = tags.end();
+    for (auto it = tags.begin(); it != end; ++it) {
+        uint32_t tag_key = *it;
+
+        if (layer.keys.size() <= tag_key) {
+            throw std::runtime_error("feature referenced out of range key");
+        }
+
+        if (++it == end) {
+            throw std::runtime_error("uneven number of feature tag ids");
+        }
+
+        uint32_t tag_val = *it;
+        if (layer.values.size() <= tag_val) {
+            throw std::runtime_error("feature referenced out of range value");
+        }
+
+        properties.add(tag_key, layer.values[tag_val]);
+    }
+}
+
 GeometryCollection VectorTileFeature::getGeometries() const {
-    pbf data(geometry_pbf);
+    GeometryBuffer buffer;
+    readGeometries(buffer);
+
+    GeometryCollection lines;
+    lines.reserve(buffer.size());
+    for (std::size_t i = 0; i < buffer.size(); i++) {
+        const GeometryLine line = buffer[i];
+        lines.emplace_back(line.begin(), line.end());
+    }
+
+    return lines;
+}
+
+void VectorTileFeature::readGeometries(GeometryBuffer& buffer) const {
+    const auto end = geometry.end();
+    auto it = geometry.begin();
     uint8_t cmd = 1;
     uint32_t length = 0;
     int32_t x = 0;
     int32_t y = 0;
 
-    GeometryCollection lines;
+    buffer.clear();
+    buffer.beginLine();
 
-    lines.emplace_back();
-    std::vector<Coordinate>* line = &lines.back();
-
-    while (data.data < data.end) {
+    while (it != end) {
         if (length == 0) {
-            uint32_t cmd_length = data.varint();
+            uint32_t cmd_length = *it++;
             cmd = cmd_length & 0x7;
             length = cmd_length >> 3;
         }
@@ -99,27 +136,32 @@ GeometryCollection VectorTileFeature::getGeometries() const {
         --length;
 
         if (cmd == 1 || cmd == 2) {
-            x += data.svarint();
-            y += data.svarint();
+            if (it == end) {
+                throw std::runtime_error("missing geometry coordinates");
+            }
+            x += static_cast<int32_t>(pbf::zigzag(*it++));
+            if (it == end) {
+                throw std::runtime_error("missing geometry coordinates");
+            }
+            y += static_cast<int32_t>(pbf::zigzag(*it++));
 
-            if (cmd == 1 && !line->empty()) { // moveTo
-                lines.emplace_back();
-                line = &lines.back();
+            if (cmd == 1 && !buffer.back().empty()) { // moveTo
+                buffer.beginLine();
             }
 
-            line->emplace_back(x, y);
+            buffer.add(Coordinate(x, y));
 
         } else if (cmd == 7) { // closePolygon
-            if (!line->empty()) {
-                line->push_back((*line)[0]);
+            const GeometryLine line = buffer.back();
+            if (!line.empty()) {
+                const Coordinate first = line.front();
+                buffer.add(first);
             }
 
         } else {
             throw std::runtime_error("unknown command");
         }
     }
-
-    return lines;
 }
 
 VectorTile::VectorTile(pbf tile_pbf) {
@@ -141,26 +183,67 @@ util::ptr<GeometryTileLayer> VectorTile::getLayer(const std::string& name) const
     return nullptr;
 }
 
-VectorTileLayer::VectorTileLayer(pbf layer_pbf) {
-    while (layer_pbf.next()) {
-        if (layer_pbf.tag == 1) { // name
-            name = layer_pbf.string();
-        } else if (layer_pbf.tag == 2) { // feature
-            features.push_back(layer_pbf.message());
-        } else if (layer_pbf.tag == 3) { // keys
-            keys.emplace(layer_pbf.string(), keys.size());
-        } else if (layer_pbf.tag == 4) { // values
-            values.emplace_back(std::move(parseValue(layer_pbf.message())));
-        } else if (layer_pbf.tag == 5) { // extent
-            extent = layer_pbf.varint();
+VectorTileLayer::VectorTileLayer(pbf layer_pbf_)
+    : layer_pbf(layer_pbf_) {
+    while (layer_pbf_.next()) {
+        if (layer_pbf_.tag == 1) { // name
+            name = layer_pbf_.string();
+        } else if (layer_pbf_.tag == 5) { // extent
+            extent = layer_pbf_.varint();
         } else {
-            layer_pbf.skip();
+            layer_pbf_.skip();
         }
     }
 }
 
+void VectorTileLayer::decode() const {
+    std::call_once(decoded, [this] {
+        // If decoding throws, the flag isn't set and the next call starts over, so the
+        // members are only replaced once the whole layer was decoded.
+        std::deque<VectorTileFeature> features_;
+        std::unordered_map<std::string, uint32_t> keys_;
+        std::vector<Value> values_;
+
+        pbf data = layer_pbf;
+        while (data.next()) {
+            if (data.tag == 2) { // feature
+                features_.emplace_back(data.message(), *this);
+            } else if (data.tag == 3) { // keys
+                keys_.emplace(data.string(), keys_.size());
+            } else if (data.tag == 4) { // values
+                values_.emplace_back(std::move(parseValue(data.message())));
+            } else {
+                data.skip();
+            }
+        }
+
+        features.swap(features_);
+        keys.swap(keys_);
+        values.swap(values_);
+    });
+}
+
+std::size_t VectorTileLayer::featureCount() const {
+    decode();
+    return features.size();
+}
+
 util::ptr<const GeometryTileFeature> VectorTileLayer::getFeature(std::size_t i) const {
-    return std::make_shared<VectorTileFeature>(features.at(i), *this);
+    decode();
+
+    // Features are owned by the layer, so we're sharing ownership of the layer
+    // instead of allocating a new object for every access.
+    return util::ptr<const GeometryTileFeature>(shared_from_this(), &features.at(i));
+}
+
+mapbox::util::optional<uint32_t> VectorTileLayer::getKeyIndex(const std::string& key) const {
+    decode();
+
+    auto it = keys.find(key);
+    if (it == keys.end()) {
+        return {};
+    }
+    return it->second;
 }
 
 }
@@ -4,12 +4,17 @@
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/util/pbf.hpp>
 
-#include <map>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace mbgl {
 
 class VectorTileLayer;
 
+// A view into a feature message of the tile data. The feature doesn't own any
+// data, so the buffer passed to VectorTile must outlive it.
 class VectorTileFeature : public GeometryTileFeature {
 public:
     VectorTileFeature(pbf, const VectorTileLayer&);
@@ -17,31 +22,44 @@ public:
     FeatureType getType() const override { return type; }
     mapbox::util::optional<Value> getValue(const std::string&) const override;
     GeometryCollection getGeometries() const override;
+    void readGeometries(GeometryBuffer&) const override;
+    void readProperties(GeometryTileProperties&) const override;
 
 private:
     const VectorTileLayer& layer;
     uint64_t id = 0;
     FeatureType type = FeatureType::Unknown;
-    pbf tags_pbf;
-    pbf geometry_pbf;
+    pbf_varints<uint32_t> tags;
+    pbf_varints<uint32_t> geometry;
 };
 
-class VectorTileLayer : public GeometryTileLayer {
+// Only the layer header is decoded on construction. Keys, values and features
+// are decoded on first access, so that layers that are not used by the style
+// are never decoded.
+class VectorTileLayer : public GeometryTileLayer,
+                        public std::enable_shared_from_this<VectorTileLayer> {
 public:
     VectorTileLayer(pbf);
 
-    std::size_t featureCount() const override { return features.size(); }
+    std::size_t featureCount() const override;
     util::ptr<const GeometryTileFeature> getFeature(std::size_t) const override;
+    bool hasKeyIndices() const override { return true; }
+    mapbox::util::optional<uint32_t> getKeyIndex(const std::string&) const override;
 
 private:
     friend class VectorTile;
     friend class VectorTileFeature;
 
+    void decode() const;
+
+    const pbf layer_pbf;
     std::string name;
     uint32_t extent = 4096;
-    std::map<std::string, uint32_t> keys;
-    std::vector<Value> values;
-    std::vector<pbf> features;
+
+    mutable std::once_flag decoded;
+    mutable std::unordered_map<std::string, uint32_t> keys;
+    mutable std::vector<Value> values;
+    mutable std::deque<VectorTileFeature> features;
 };
 
 class VectorTile : public GeometryTile {
@@ -51,7 +69,7 @@ public:
     util::ptr<GeometryTileLayer> getLayer(const std::string&) const override;
 
 private:
-    std::map<std::string, util::ptr<GeometryTileLayer>> layers;
+    std::unordered_map<std::string, util::ptr<GeometryTileLayer>> layers;
 };
 
 }
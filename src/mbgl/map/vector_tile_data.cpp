@@ -3,14 +3,20 @@
 #include <mbgl/style/style_layer.hpp>
 #include <mbgl/style/style_bucket.hpp>
 #include <mbgl/map/source.hpp>
+#include <mbgl/map/environment.hpp>
 #include <mbgl/geometry/glyph_atlas.hpp>
 #include <mbgl/platform/log.hpp>
+#include <mbgl/storage/response.hpp>
 #include <mbgl/text/collision_tile.hpp>
+#include <mbgl/util/binary.hpp>
 #include <mbgl/util/pbf.hpp>
 #include <mbgl/util/worker.hpp>
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/style/style.hpp>
 
+#include <limits>
+#include <sstream>
+
 using namespace mbgl;
 
 VectorTileData::VectorTileData(const TileID& id_,
@@ -40,6 +46,42 @@ VectorTileData::~VectorTileData() {
     glyphAtlas.removeGlyphs(reinterpret_cast<uintptr_t>(this));
 }
 
+void VectorTileData::load(Worker& worker, std::string data_, bool fetched, double priority_, const std::function<void()>& callback) {
+    setState(State::loading);
+    priority = priority_;
+
+    if (!env.storesDerivedData()) {
+        // Buckets can neither be stored nor found.
+        bucketsURL.clear();
+        TileData::load(worker, std::move(data_), fetched, priority, callback);
+        return;
+    }
+
+    // Buckets depend on the zoom level of overscaled tiles and on the layout of the fill and
+    // line layers of the style, but the tile URL only covers the zoom level of the data.
+    std::stringstream url;
+    url << source.tileURL(id, 1) << "#buckets/" << int(id.z) << "/" << std::hex << style.geometryHash;
+    bucketsURL = url.str();
+
+    if (fetched) {
+        // The buckets of data that was just downloaded can't be cached yet.
+        TileData::load(worker, std::move(data_), fetched, priority, callback);
+        return;
+    }
+
+    // Parsing is only deferred until the lookup finishes, which never hits the network.
+    auto tileData = std::make_shared<std::string>(std::move(data_));
+    req = env.request({ Resource::Kind::Buckets, bucketsURL }, [tileData, fetched, callback, &worker, this](const Response& res) {
+        req = nullptr;
+
+        if (res.status == Response::Successful) {
+            cachedBuckets = res.data;
+        }
+
+        TileData::load(worker, std::move(*tileData), fetched, priority, callback);
+    });
+}
+
 void VectorTileData::parse() {
     if (getState() != State::loaded && getState() != State::partial) {
         return;
@@ -53,11 +95,20 @@ void VectorTileData::parse() {
         const VectorTile* vt = &vectorTile;
         TileParser parser(*vt, *this, style, glyphAtlas, glyphStore, spriteAtlas, sprite);
         parser.parse();
+        std::string().swap(cachedBuckets);
 
         if (getState() == State::obsolete) {
             return;
         }
 
+        if (!bucketsURL.empty() && !parser.getSerializedBuckets().empty()) {
+            auto response = std::make_shared<Response>();
+            response->status = Response::Successful;
+            response->expires = std::numeric_limits<int64_t>::max();
+            response->data = parser.getSerializedBuckets();
+            env.store({ Resource::Kind::Buckets, bucketsURL }, response);
+        }
+
         if (parser.isPartialParse()) {
             setState(State::partial);
         } else {
@@ -86,6 +137,53 @@ Bucket* VectorTileData::getBucket(StyleLayer const& layer) {
     return it->second.get();
 }
 
+size_t VectorTileData::getMemoryUsage() const {
+    size_t bytes = TileData::getMemoryUsage();
+
+    std::lock_guard<std::mutex> lock(bucketsMutex);
+    for (const auto& buffers : bucketBuffers) {
+        bytes += buffers->fillVertexBuffer.bytes() +
+                 buffers->lineVertexBuffer.bytes() +
+                 buffers->triangleElementsBuffer.bytes() +
+                 buffers->lineElementsBuffer.bytes();
+    }
+
+    for (const auto& bucket : buckets) {
+        bytes += bucket.second->getMemoryUsage();
+    }
+
+    return bytes;
+}
+
+void VectorTileData::addBucketBuffers(std::unique_ptr<BucketBuffers> buffers) {
+    std::lock_guard<std::mutex> lock(bucketsMutex);
+    bucketBuffers.emplace_back(std::move(buffers));
+}
+
+void VectorTileData::BucketBuffers::serialize(util::BinaryWriter& writer) const {
+    const auto write = [&](const void* bufferData, size_t size) {
+        writer.write<uint32_t>(size);
+        writer.write(reinterpret_cast<const char*>(bufferData), size);
+    };
+
+    write(fillVertexBuffer.data(), fillVertexBuffer.bytes());
+    write(lineVertexBuffer.data(), lineVertexBuffer.bytes());
+    write(triangleElementsBuffer.data(), triangleElementsBuffer.bytes());
+    write(lineElementsBuffer.data(), lineElementsBuffer.bytes());
+}
+
+void VectorTileData::BucketBuffers::restore(util::BinaryReader& reader) {
+    const auto read = [&](auto& buffer) {
+        const uint32_t size = reader.read<uint32_t>();
+        buffer.append(reader.read(size), size);
+    };
+
+    read(fillVertexBuffer);
+    read(lineVertexBuffer);
+    read(triangleElementsBuffer);
+    read(lineElementsBuffer);
+}
+
 size_t VectorTileData::countBuckets() const {
     std::lock_guard<std::mutex> lock(bucketsMutex);
 
@@ -128,7 +226,7 @@ void VectorTileData::redoPlacement(float angle, bool collisionDebug) {
         currentCollisionDebug = collisionDebug;
 
         auto callback = std::bind(&VectorTileData::endRedoPlacement, this);
-        workRequest = style.workers.send([this, angle, collisionDebug] { workerRedoPlacement(angle, collisionDebug); }, callback);
+        workRequest = style.workers.send([this, angle, collisionDebug] { workerRedoPlacement(angle, collisionDebug); }, callback, priority);
 
     }
 }
@@ -13,9 +13,15 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace mbgl {
 
+namespace util {
+class BinaryReader;
+class BinaryWriter;
+}
+
 class Bucket;
 class CollisionTile;
 class Painter;
@@ -43,9 +49,11 @@ public:
                    bool collisionDebug_);
     ~VectorTileData();
 
+    void load(Worker&, std::string data, bool fetched, double priority, const std::function<void()>& callback) override;
     void parse() override;
     void redoPlacement(float angle, bool collisionDebug) override;
     virtual Bucket* getBucket(StyleLayer const &layer_desc) override;
+    size_t getMemoryUsage() const override;
 
     size_t countBuckets() const;
     void setBucket(StyleLayer const &layer_desc, std::unique_ptr<Bucket> bucket);
@@ -56,15 +64,27 @@ public:
         return collision.get();
     }
 
+    // Holds the actual geometries of fill and line buckets.
+    struct BucketBuffers {
+        FillVertexBuffer fillVertexBuffer;
+        LineVertexBuffer lineVertexBuffer;
+
+        TriangleElementsBuffer triangleElementsBuffer;
+        LineElementsBuffer lineElementsBuffer;
+
+        void serialize(util::BinaryWriter&) const;
+        void restore(util::BinaryReader&);
+    };
+
+    // Takes ownership of buffers that parsing finished writing to.
+    void addBucketBuffers(std::unique_ptr<BucketBuffers>);
+
 protected:
     void redoPlacement();
 
-    // Holds the actual geometries in this tile.
-    FillVertexBuffer fillVertexBuffer;
-    LineVertexBuffer lineVertexBuffer;
-
-    TriangleElementsBuffer triangleElementsBuffer;
-    LineElementsBuffer lineElementsBuffer;
+    // Fill and line buckets are created in parallel, and each of the parallel tasks adds
+    // geometries to its own set of buffers. Guarded by bucketsMutex.
+    std::vector<std::unique_ptr<BucketBuffers>> bucketBuffers;
 
     GlyphAtlas& glyphAtlas;
     GlyphStore& glyphStore;
@@ -72,6 +92,13 @@ protected:
     util::ptr<Sprite> sprite;
     Style& style;
 
+    // The fill and line buckets of a previous parse of the same data with the same style,
+    // serialized by TileParser. They are looked up in the file source before the tile is
+    // parsed, and stored in it afterwards if they weren't found. The URL is empty if the
+    // file source can't store them.
+    std::string bucketsURL;
+    std::string cachedBuckets;
+
 private:
     // Contains all the Bucket objects for the tile. Buckets are render
     // objects and they get added to this std::map<> by the workers doing
@@ -1,4 +1,5 @@
 #include <mbgl/platform/gl.hpp>
+#include <mbgl/util/uv_detail.hpp>
 
 #include <mutex>
 
@@ -32,6 +33,36 @@ void InitializeExtensions(glProc (*getProcAddress)(const char *)) {
     });
 }
 
+namespace {
+
+uv::tls<CallCounter>& currentCallCounter() {
+    static uv::tls<CallCounter> counter;
+    return counter;
+}
+
+}
+
+CallCounter::CallCounter() : previous(currentCallCounter().get()) {
+    currentCallCounter().set(this);
+}
+
+CallCounter::~CallCounter() {
+    currentCallCounter().set(previous);
+}
+
+#if defined(MBGL_GL_CALL_COUNTING)
+CallScope::CallScope()
+    : counter(currentCallCounter().get()),
+      calls(counter ? counter->calls : 0) {
+}
+
+CallScope::~CallScope() {
+    if (counter && counter->calls == calls) {
+        counter->calls++;
+    }
+}
+#endif
+
 void checkError(const char *cmd, const char *file, int line) {
     const GLenum err = glGetError();
     if (err != GL_NO_ERROR) {
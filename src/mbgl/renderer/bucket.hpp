@@ -5,6 +5,8 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/util/mat4.hpp>
 
+#include <cstddef>
+
 namespace mbgl {
 
 class Painter;
@@ -30,6 +32,10 @@ public:
     virtual void placeFeatures() {}
     virtual void swapRenderData() {}
 
+    // Returns an estimate of the memory owned by this bucket. Buffers that are shared
+    // between buckets are accounted for by the tile that owns them.
+    virtual size_t getMemoryUsage() const { return 0; }
+
 protected:
     bool uploaded = false;
 
@@ -9,6 +9,7 @@
 #include <mbgl/shader/outline_shader.hpp>
 #include <mbgl/platform/gl.hpp>
 #include <mbgl/platform/log.hpp>
+#include <mbgl/util/binary.hpp>
 
 #include <cassert>
 
@@ -57,6 +58,44 @@ FillBucket::FillBucket(FillVertexBuffer &vertexBuffer_,
     assert(tesselator);
 }
 
+FillBucket::FillBucket(FillVertexBuffer &vertexBuffer_,
+                       TriangleElementsBuffer &triangleElementsBuffer_,
+                       LineElementsBuffer &lineElementsBuffer_,
+                       util::BinaryReader &reader)
+    : allocator(nullptr),
+      tesselator(nullptr),
+      vertexBuffer(vertexBuffer_),
+      triangleElementsBuffer(triangleElementsBuffer_),
+      lineElementsBuffer(lineElementsBuffer_),
+      vertex_start(reader.read<uint32_t>()),
+      triangle_elements_start(reader.read<uint32_t>()),
+      line_elements_start(reader.read<uint32_t>()) {
+    for (auto count = reader.read<uint32_t>(); count > 0; count--) {
+        const auto vertex_length = reader.read<uint32_t>();
+        triangleGroups.emplace_back(std::make_unique<TriangleGroup>(vertex_length, reader.read<uint32_t>()));
+    }
+    for (auto count = reader.read<uint32_t>(); count > 0; count--) {
+        const auto vertex_length = reader.read<uint32_t>();
+        lineGroups.emplace_back(std::make_unique<LineGroup>(vertex_length, reader.read<uint32_t>()));
+    }
+}
+
+void FillBucket::serialize(util::BinaryWriter &writer) const {
+    writer.write<uint32_t>(vertex_start);
+    writer.write<uint32_t>(triangle_elements_start);
+    writer.write<uint32_t>(line_elements_start);
+    writer.write<uint32_t>(triangleGroups.size());
+    for (const auto& group : triangleGroups) {
+        writer.write<uint32_t>(group->vertex_length);
+        writer.write<uint32_t>(group->elements_length);
+    }
+    writer.write<uint32_t>(lineGroups.size());
+    for (const auto& group : lineGroups) {
+        writer.write<uint32_t>(group->vertex_length);
+        writer.write<uint32_t>(group->elements_length);
+    }
+}
+
 FillBucket::~FillBucket() {
     if (tesselator) {
         tessDeleteTess(tesselator);
@@ -66,9 +105,9 @@ FillBucket::~FillBucket() {
     }
 }
 
-void FillBucket::addGeometry(const GeometryCollection& geometryCollection) {
-    for (auto& line_ : geometryCollection) {
-        for (auto& v : line_) {
+void FillBucket::addGeometry(const GeometryBuffer& geometries) {
+    for (std::size_t i = 0; i < geometries.size(); i++) {
+        for (auto& v : geometries[i]) {
             line.emplace_back(v.x, v.y);
         }
         if (line.size()) {
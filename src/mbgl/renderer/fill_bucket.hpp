@@ -15,6 +15,12 @@ namespace mbgl {
 
 class FillVertexBuffer;
 class OutlineShader;
+
+namespace util {
+class BinaryReader;
+class BinaryWriter;
+}
+
 class PlainShader;
 class PatternShader;
 
@@ -31,15 +37,25 @@ public:
     FillBucket(FillVertexBuffer &vertexBuffer,
                TriangleElementsBuffer &triangleElementsBuffer,
                LineElementsBuffer &lineElementsBuffer);
+
+    // Restores a bucket that was serialized with serialize(). The buffers must contain
+    // a copy of the ones the bucket was created with.
+    FillBucket(FillVertexBuffer &vertexBuffer,
+               TriangleElementsBuffer &triangleElementsBuffer,
+               LineElementsBuffer &lineElementsBuffer,
+               util::BinaryReader &reader);
     ~FillBucket() override;
 
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const;
 
-    void addGeometry(const GeometryCollection&);
+    void addGeometry(const GeometryBuffer&);
     void tessellate();
 
+    // Writes where the bucket's geometries are located in its buffers.
+    void serialize(util::BinaryWriter&) const;
+
     void drawElements(PlainShader& shader);
     void drawElements(PatternShader& shader);
     void drawVertices(OutlineShader& shader);
@@ -8,6 +8,7 @@
 #include <mbgl/shader/linesdf_shader.hpp>
 #include <mbgl/shader/linepattern_shader.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/binary.hpp>
 #include <mbgl/platform/gl.hpp>
 
 #ifndef BUFFER_OFFSET
@@ -25,17 +26,40 @@ LineBucket::LineBucket(LineVertexBuffer& vertexBuffer_,
       vertex_start(vertexBuffer_.index()),
       triangle_elements_start(triangleElementsBuffer_.index()){};
 
+LineBucket::LineBucket(LineVertexBuffer& vertexBuffer_,
+                       TriangleElementsBuffer& triangleElementsBuffer_,
+                       util::BinaryReader& reader)
+    : vertexBuffer(vertexBuffer_),
+      triangleElementsBuffer(triangleElementsBuffer_),
+      vertex_start(reader.read<uint32_t>()),
+      triangle_elements_start(reader.read<uint32_t>()) {
+    for (auto count = reader.read<uint32_t>(); count > 0; count--) {
+        const auto vertex_length = reader.read<uint32_t>();
+        triangleGroups.emplace_back(std::make_unique<TriangleGroup>(vertex_length, reader.read<uint32_t>()));
+    }
+}
+
+void LineBucket::serialize(util::BinaryWriter& writer) const {
+    writer.write<uint32_t>(vertex_start);
+    writer.write<uint32_t>(triangle_elements_start);
+    writer.write<uint32_t>(triangleGroups.size());
+    for (const auto& group : triangleGroups) {
+        writer.write<uint32_t>(group->vertex_length);
+        writer.write<uint32_t>(group->elements_length);
+    }
+}
+
 LineBucket::~LineBucket() {
     // Do not remove. header file only contains forward definitions to unique pointers.
 }
 
-void LineBucket::addGeometry(const GeometryCollection& geometryCollection) {
-    for (auto& line : geometryCollection) {
-        addGeometry(line);
+void LineBucket::addGeometry(const GeometryBuffer& geometries) {
+    for (std::size_t i = 0; i < geometries.size(); i++) {
+        addGeometry(geometries[i]);
     }
 }
 
-void LineBucket::addGeometry(const std::vector<Coordinate>& vertices) {
+void LineBucket::addGeometry(const GeometryLine& vertices) {
     const auto len = [&vertices] {
         auto l = vertices.size();
         // If the line has duplicate vertices at the end, adjust length to remove them.
@@ -21,19 +21,32 @@ class LineShader;
 class LineSDFShader;
 class LinepatternShader;
 
+namespace util {
+class BinaryReader;
+class BinaryWriter;
+}
+
 class LineBucket : public Bucket {
     using TriangleGroup = ElementGroup<3>;
 
 public:
     LineBucket(LineVertexBuffer &vertexBuffer, TriangleElementsBuffer &triangleElementsBuffer);
+
+    // Restores a bucket that was serialized with serialize(). The buffers must contain
+    // a copy of the ones the bucket was created with. The layout is not serialized.
+    LineBucket(LineVertexBuffer &vertexBuffer, TriangleElementsBuffer &triangleElementsBuffer,
+               util::BinaryReader &reader);
     ~LineBucket() override;
 
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const;
 
-    void addGeometry(const GeometryCollection&);
-    void addGeometry(const std::vector<Coordinate>& line);
+    void addGeometry(const GeometryBuffer&);
+    void addGeometry(const GeometryLine& line);
+
+    // Writes where the bucket's geometries are located in its buffers.
+    void serialize(util::BinaryWriter&) const;
 
     void drawLines(LineShader& shader);
     void drawLineSDF(LineSDFShader& shader);
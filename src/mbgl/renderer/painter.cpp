@@ -5,6 +5,7 @@
 
 #include <mbgl/platform/log.hpp>
 #include <mbgl/gl/debugging.hpp>
+#include <mbgl/gl/recording.hpp>
 
 #include <mbgl/style/style.hpp>
 #include <mbgl/style/style_layer.hpp>
@@ -37,6 +38,7 @@
 #include <cassert>
 #include <algorithm>
 #include <iostream>
+#include <iterator>
 
 using namespace mbgl;
 
@@ -169,6 +171,10 @@ void Painter::prepareTile(const Tile& tile) {
 void Painter::render(const Style& style, TransformState state_, TimePoint time) {
     state = state_;
 
+    gl::CallCounter counter;
+    stats = {};
+    gl::recording::frame();
+
     glyphAtlas = style.glyphAtlas.get();
     spriteAtlas = style.spriteAtlas.get();
     lineAtlas = style.lineAtlas.get();
@@ -266,6 +272,8 @@ void Painter::render(const Style& style, TransformState state_, TimePoint time)
         MBGL_CHECK_ERROR(glBindTexture(GL_TEXTURE_2D, 0));
         MBGL_CHECK_ERROR(VertexArrayObject::Unbind());
     }
+
+    stats.glCalls = counter.calls;
 }
 
 template <class Iterator>
@@ -287,12 +295,37 @@ void Painter::renderPass(RenderPass pass_,
     for (; it != end; ++it, i += increment) {
         const auto& item = *it;
         if (item.bucket && item.tile) {
-            if (item.hasRenderPass(pass)) {
-                const gl::debugging::group group(item.layer.id + " - " + std::string(item.tile->id));
-                setStrata(i * strataThickness);
-                prepareTile(*item.tile);
-                item.bucket->render(*this, item.layer, item.tile->id, item.tile->matrix);
+            if (!item.hasRenderPass(pass)) {
+                continue;
             }
+
+            // The items of a layer are adjacent. Fill layers draw up to three shaders per tile, so
+            // all of their tiles are drawn as one batch, at the strata of the first one.
+            if (item.layer.type == StyleLayerType::Fill) {
+                const std::size_t first = i;
+                batch.clear();
+                batch.push_back(&item);
+                while (std::next(it) != end && &std::next(it)->layer == &item.layer) {
+                    ++it;
+                    i += increment;
+                    batch.push_back(&*it);
+                }
+
+                if (batch.size() > 1) {
+                    const gl::debugging::group group(item.layer.id);
+                    setStrata(first * strataThickness);
+                    renderFill(item.layer, batch);
+                    stats.tileLayers += batch.size();
+                    stats.batchedLayers++;
+                    continue;
+                }
+            }
+
+            const gl::debugging::group group(item.layer.id + " - " + std::string(item.tile->id));
+            setStrata(i * strataThickness);
+            prepareTile(*item.tile);
+            item.bucket->render(*this, item.layer, item.tile->id, item.tile->matrix);
+            stats.tileLayers++;
         } else {
             const gl::debugging::group group("background");
             setStrata(i * strataThickness);
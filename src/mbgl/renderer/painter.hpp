@@ -2,6 +2,7 @@
 #define MBGL_RENDERER_PAINTER
 
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/map/render_stats.hpp>
 
 #include <mbgl/renderer/frame_history.hpp>
 #include <mbgl/renderer/bucket.hpp>
@@ -103,6 +104,11 @@ public:
 
     void renderDebugText(DebugBucket& bucket, const mat4 &matrix);
     void renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix);
+    // Renders the fill buckets of a layer in several tiles. The outline, the fill and the
+    // antialiasing fringe are drawn in all tiles before the next one, so that their shaders
+    // are bound once per batch instead of once per tile. The tiles are clipped to themselves
+    // by the stencil buffer, so the order across tiles doesn't matter.
+    void renderFill(const StyleLayer &layer_desc, const std::vector<const RenderItem*>& items);
     void renderLine(LineBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix);
     void renderSymbol(SymbolBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix);
     void renderRaster(RasterBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix);
@@ -137,6 +143,8 @@ public:
 
     bool needsAnimation() const;
 
+    const RenderStats& getStats() const { return stats; }
+
 private:
     void setupShaders();
     mat4 translatedMatrix(const mat4& matrix, const std::array<float, 2> &translation, const TileID &id, TranslateAnchorType anchor);
@@ -152,6 +160,9 @@ private:
 
     void prepareTile(const Tile& tile);
 
+    enum class FillPhase : uint8_t { Outline, Fill, Fringe };
+    void renderFill(FillPhase, FillBucket&, const StyleLayer&, const TileID&, const mat4&);
+
     template <typename BucketProperties, typename StyleProperties>
     void renderSDF(SymbolBucket &bucket,
                    const TileID &id,
@@ -201,6 +212,11 @@ private:
     RenderPass pass = RenderPass::Opaque;
     const float strata_epsilon = 1.0f / (1 << 16);
 
+    RenderStats stats;
+
+    // The items of the layer that is currently being batched. Kept to reuse its memory.
+    std::vector<const RenderItem*> batch;
+
 public:
     FrameHistory frameHistory;
 
@@ -4,6 +4,7 @@
 #include <mbgl/style/style_layer.hpp>
 #include <mbgl/style/style_layout.hpp>
 #include <mbgl/map/sprite.hpp>
+#include <mbgl/map/tile.hpp>
 #include <mbgl/map/tile_id.hpp>
 #include <mbgl/geometry/sprite_atlas.hpp>
 #include <mbgl/shader/outline_shader.hpp>
@@ -14,6 +15,21 @@
 using namespace mbgl;
 
 void Painter::renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix) {
+    renderFill(FillPhase::Outline, bucket, layer_desc, id, matrix);
+    renderFill(FillPhase::Fill, bucket, layer_desc, id, matrix);
+    renderFill(FillPhase::Fringe, bucket, layer_desc, id, matrix);
+}
+
+void Painter::renderFill(const StyleLayer &layer_desc, const std::vector<const RenderItem*>& items) {
+    for (const auto phase : { FillPhase::Outline, FillPhase::Fill, FillPhase::Fringe }) {
+        for (const auto item : items) {
+            prepareTile(*item->tile);
+            renderFill(phase, static_cast<FillBucket&>(*item->bucket), layer_desc, item->tile->id, item->tile->matrix);
+        }
+    }
+}
+
+void Painter::renderFill(FillPhase phase, FillBucket& bucket, const StyleLayer &layer_desc, const TileID& id, const mat4 &matrix) {
     const FillProperties &properties = layer_desc.getProperties<FillProperties>();
     mat4 vtxMatrix = translatedMatrix(matrix, properties.translate, id, properties.translateAnchor);
 
@@ -43,7 +59,7 @@ void Painter::renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const
 
     // Because we're drawing top-to-bottom, and we update the stencil mask
     // befrom, we have to draw the outline first (!)
-    if (outline && pass == RenderPass::Translucent) {
+    if (phase == FillPhase::Outline && outline && pass == RenderPass::Translucent) {
         useProgram(outlineShader->program);
         outlineShader->u_matrix = vtxMatrix;
         lineWidth(2.0f); // This is always fixed and does not depend on the pixelRatio!
@@ -59,7 +75,7 @@ void Painter::renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const
         bucket.drawVertices(*outlineShader);
     }
 
-    if (pattern) {
+    if (phase == FillPhase::Fill && pattern) {
         // Image fill.
         if (pass == RenderPass::Translucent) {
 
@@ -99,7 +115,7 @@ void Painter::renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const
             bucket.drawElements(*patternShader);
         }
     }
-    else {
+    else if (phase == FillPhase::Fill) {
         // No image fill.
         if ((fill_color[3] >= 1.0f) == (pass == RenderPass::Opaque)) {
             // Only draw the fill when it's either opaque and we're drawing opaque
@@ -119,7 +135,7 @@ void Painter::renderFill(FillBucket& bucket, const StyleLayer &layer_desc, const
 
     // Because we're drawing top-to-bottom, and we update the stencil mask
     // below, we have to draw the outline first (!)
-    if (fringeline && pass == RenderPass::Translucent) {
+    if (phase == FillPhase::Fringe && fringeline && pass == RenderPass::Translucent) {
         useProgram(outlineShader->program);
         outlineShader->u_matrix = vtxMatrix;
         lineWidth(2.0f); // This is always fixed and does not depend on the pixelRatio!
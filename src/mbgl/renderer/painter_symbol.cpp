@@ -207,7 +207,7 @@ void Painter::renderSymbol(SymbolBucket &bucket, const StyleLayer &layer_desc, c
     }
 
     if (bucket.hasTextData()) {
-        glyphAtlas->bind();
+        glyphAtlas->bind(bucket.glyphPage);
 
         renderSDF(bucket,
                   id,
@@ -41,3 +41,8 @@ void RasterBucket::drawRaster(RasterShader& shader, StaticVertexBuffer &vertices
 bool RasterBucket::hasData() const {
     return raster.isLoaded();
 }
+
+size_t RasterBucket::getMemoryUsage() const {
+    // Decoded pixels are RGBA, both before and after they are uploaded as a texture.
+    return size_t(raster.width) * raster.height * 4;
+}
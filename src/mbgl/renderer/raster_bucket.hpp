@@ -19,6 +19,7 @@ public:
     void upload() override;
     void render(Painter&, const StyleLayer&, const TileID&, const mat4&) override;
     bool hasData() const;
+    size_t getMemoryUsage() const override;
 
     bool setImage(const std::string &data);
 
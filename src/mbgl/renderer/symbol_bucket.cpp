@@ -1,6 +1,7 @@
 #include <mbgl/renderer/symbol_bucket.hpp>
 #include <mbgl/map/geometry_tile.hpp>
 #include <mbgl/style/style_layout.hpp>
+#include <mbgl/style/compiled_filter.hpp>
 #include <mbgl/geometry/text_buffer.hpp>
 #include <mbgl/geometry/icon_buffer.hpp>
 #include <mbgl/geometry/glyph_atlas.hpp>
@@ -92,6 +93,27 @@ bool SymbolBucket::hasIconData() const { return renderData && !renderData->icon.
 
 bool SymbolBucket::hasCollisionBoxData() const { return renderData && !renderData->collisionBox.groups.empty(); }
 
+size_t SymbolBucket::getMemoryUsage() const {
+    size_t bytes = sizeof(*this);
+
+    // The features are kept for placing them again when the map is rotated.
+    for (const auto& feature : features) {
+        bytes += sizeof(feature) + feature.label.size() * sizeof(char32_t) + feature.sprite.size();
+        for (const auto& line : feature.geometry) {
+            bytes += line.size() * sizeof(Coordinate);
+        }
+    }
+
+    // Data that is still being placed on a worker thread isn't counted until it is swapped in.
+    if (renderData) {
+        bytes += renderData->text.vertices.bytes() + renderData->text.triangles.bytes() +
+                 renderData->icon.vertices.bytes() + renderData->icon.triangles.bytes() +
+                 renderData->collisionBox.vertices.bytes();
+    }
+
+    return bytes;
+}
+
 bool SymbolBucket::needsDependencies(const GeometryTileLayer& layer,
                                      const FilterExpression& filter,
                                      GlyphStore& glyphStore,
@@ -106,11 +128,17 @@ bool SymbolBucket::needsDependencies(const GeometryTileLayer& layer,
     // Determine and load glyph ranges
     std::set<GlyphRange> ranges;
 
+    const CompiledFilter compiledFilter(filter, layer);
+
+    // Reused for decoding the properties and geometries of all features in the layer.
+    GeometryTileProperties properties;
+    GeometryBuffer geometries;
+
     for (std::size_t i = 0; i < layer.featureCount(); i++) {
         auto feature = layer.getFeature(i);
 
-        GeometryTileFeatureExtractor extractor(*feature);
-        if (!evaluate(filter, extractor))
+        feature->readProperties(properties);
+        if (!compiledFilter.evaluate(*feature, properties))
             continue;
 
         SymbolFeature ft;
@@ -147,12 +175,11 @@ bool SymbolBucket::needsDependencies(const GeometryTileLayer& layer,
 
             auto &multiline = ft.geometry;
 
-            GeometryCollection geometryCollection = feature->getGeometries();
-            for (auto& line : geometryCollection) {
-                multiline.emplace_back();
-                for (auto& point : line) {
-                    multiline.back().emplace_back(point.x, point.y);
-                }
+            feature->readGeometries(geometries);
+            multiline.reserve(geometries.size());
+            for (std::size_t j = 0; j < geometries.size(); j++) {
+                const GeometryLine line = geometries[j];
+                multiline.emplace_back(line.begin(), line.end());
             }
 
             features.push_back(std::move(ft));
@@ -222,12 +249,34 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
 
     auto fontStack = glyphStore.getFontStack(layout.text.font);
 
+    // Add the glyphs we need for all labels to the glyph atlas. Text is drawn from a single
+    // page, so when they don't all fit on one page, try the next one. The glyphs that did fit
+    // on the previous page stay there until the tile is removed.
+    GlyphPositions face;
+    std::u32string glyphs;
+    {
+        std::set<char32_t> chars;
+        for (const auto& feature : features) {
+            if (feature.geometry.size()) {
+                chars.insert(feature.label.begin(), feature.label.end());
+            }
+        }
+        glyphs.assign(chars.begin(), chars.end());
+    }
+
+    if (!glyphs.empty()) {
+        while (!glyphAtlas.addGlyphs(tileUID, glyphs, layout.text.font, **fontStack, face, glyphPage) &&
+               glyphPage + 1 < glyphAtlas.maxPages) {
+            face.clear();
+            glyphPage++;
+        }
+    }
+
     for (const auto& feature : features) {
         if (!feature.geometry.size()) continue;
 
         Shaping shapedText;
         PositionedIcon shapedIcon;
-        GlyphPositions face;
 
         // if feature has text, shape the text
         if (feature.label.length()) {
@@ -241,11 +290,6 @@ void SymbolBucket::addFeatures(uintptr_t tileUID,
                 /* justify */ justify,
                 /* spacing: ems */ layout.text.letter_spacing * 24,
                 /* translate */ vec2<float>(layout.text.offset[0], layout.text.offset[1]));
-
-            // Add the glyphs we need for this label to the glyph atlas.
-            if (shapedText) {
-                glyphAtlas.addGlyphs(tileUID, feature.label, layout.text.font, **fontStack, face);
-            }
         }
 
         // if feature has icon, get sprite atlas position
@@ -73,6 +73,7 @@ public:
     bool hasTextData() const;
     bool hasIconData() const;
     bool hasCollisionBoxData() const;
+    size_t getMemoryUsage() const override;
 
     void addFeatures(uintptr_t tileUID,
                      SpriteAtlas&,
@@ -108,6 +109,8 @@ private:
 public:
     StyleLayoutSymbol layout;
     bool sdfIcons = false;
+    // The page of the glyph atlas that holds the glyphs of all labels.
+    uint8_t glyphPage = 0;
 
 private:
     CollisionTile &collision;
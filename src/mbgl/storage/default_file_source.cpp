@@ -2,6 +2,7 @@
 #include <mbgl/storage/request.hpp>
 #include <mbgl/storage/asset_context.hpp>
 #include <mbgl/storage/http_context.hpp>
+#include <mbgl/storage/mbtiles_context.hpp>
 
 #include <mbgl/storage/response.hpp>
 #include <mbgl/platform/platform.hpp>
@@ -27,8 +28,26 @@ namespace algo = boost::algorithm;
 
 namespace mbgl {
 
-DefaultFileSource::DefaultFileSource(FileCache* cache, const std::string& root)
-    : thread(std::make_unique<util::Thread<Impl>>("FileSource", util::ThreadPriority::Low, cache, root)) {
+namespace {
+
+bool isTile(const DefaultFileRequest& request) {
+    return request.resource.kind == Resource::Kind::Tile;
+}
+
+// Tiles can't be rendered without the style, the TileJSON, the glyphs and the sprite, so these
+// are started before any tile. Otherwise, lower priority values are started first.
+bool startsBefore(const DefaultFileRequest& a, const DefaultFileRequest& b) {
+    if (isTile(a) != isTile(b)) {
+        return isTile(b);
+    }
+    return a.priority < b.priority;
+}
+
+}
+
+DefaultFileSource::DefaultFileSource(FileCache* cache_, const std::string& root)
+    : cache(cache_),
+      thread(std::make_unique<util::Thread<Impl>>("FileSource", util::ThreadPriority::Low, cache, root)) {
 }
 
 DefaultFileSource::~DefaultFileSource() {
@@ -69,6 +88,46 @@ void DefaultFileSource::cancel(Request *req) {
     thread->invoke(&Impl::cancel, req);
 }
 
+void DefaultFileSource::setPriority(Request* req, double priority) {
+    // The request may be gone by the time the file source thread gets to this, so it is
+    // identified by its resource.
+    thread->invoke(&Impl::setPriority, req->resource, priority);
+}
+
+void DefaultFileSource::setMaxConnections(std::size_t perHost, std::size_t total) {
+    thread->invoke(&Impl::setMaxConnections, perHost, total);
+}
+
+void DefaultFileSource::setMaxActiveRequests(std::size_t requests, std::size_t tileRequests) {
+    thread->invoke(&Impl::setMaxActiveRequests, requests, tileRequests);
+}
+
+void DefaultFileSource::store(const Resource& resource, std::shared_ptr<const Response> response) {
+    if (cache) {
+        cache->put(resource, std::move(response), FileCache::Hint::Full);
+    }
+}
+
+bool DefaultFileSource::storesDerivedData() const {
+    return cache != nullptr;
+}
+
+void DefaultFileSource::pin(const Resource& resource) {
+    if (cache) {
+        cache->pin(resource);
+    }
+}
+
+std::size_t DefaultFileSource::getMemoryUsage() const {
+    return cache ? cache->getMemoryUsage() : 0;
+}
+
+void DefaultFileSource::releaseMemory() {
+    if (cache) {
+        cache->releaseMemory();
+    }
+}
+
 // ----- Impl -----
 
 DefaultFileSource::Impl::Impl(uv_loop_t* loop_, FileCache* cache_, const std::string& root)
@@ -76,7 +135,26 @@ DefaultFileSource::Impl::Impl(uv_loop_t* loop_, FileCache* cache_, const std::st
       cache(cache_),
       assetRoot(root.empty() ? platform::assetRoot() : root),
       assetContext(AssetContext::createContext(loop_)),
-      httpContext(HTTPContext::createContext(loop_)) {
+      httpContext(HTTPContext::createContext(loop_)),
+      mbtilesContext(MBTilesContext::createContext(loop_)) {
+}
+
+void DefaultFileSource::Impl::setMaxConnections(std::size_t perHost, std::size_t total) {
+    httpContext->setMaxConnections(perHost, total);
+}
+
+void DefaultFileSource::Impl::setMaxActiveRequests(std::size_t requests, std::size_t tileRequests) {
+    maxActiveRequests = requests;
+    maxActiveTileRequests = tileRequests;
+    startQueuedRequests();
+}
+
+void DefaultFileSource::Impl::setPriority(const Resource& resource, double priority) {
+    DefaultFileRequest* request = find(resource);
+    if (request) {
+        // Coalesced requests take the priority that was set last.
+        request->priority = priority;
+    }
 }
 
 DefaultFileRequest* DefaultFileSource::Impl::find(const Resource& resource) {
@@ -99,7 +177,11 @@ void DefaultFileSource::Impl::add(Request* req) {
     request = &pending.emplace(resource, resource).first->second;
     request->observers.insert(req);
 
-    if (cache) {
+    if (resource.kind != Resource::Kind::Buckets && algo::starts_with(resource.url, "mbtiles://")) {
+        // MBTiles files are local already, so storing their tiles in the cache as well would only
+        // duplicate them.
+        startRealRequest(resource);
+    } else if (cache) {
         startCacheRequest(resource);
     } else {
         startRealRequest(resource);
@@ -139,14 +221,88 @@ void DefaultFileSource::Impl::startCacheRequest(const Resource& resource) {
 void DefaultFileSource::Impl::startRealRequest(const Resource& resource, std::shared_ptr<const Response> response) {
     DefaultFileRequest* request = find(resource);
 
+    if (resource.kind == Resource::Kind::Buckets) {
+        // Derived data only ever comes from the cache.
+        auto res = std::make_shared<Response>();
+        res->message = "Not cached";
+        notify(request, res, FileCache::Hint::No);
+        return;
+    }
+
     auto callback = [request, this] (std::shared_ptr<const Response> res, FileCache::Hint hint) {
         notify(request, res, hint);
     };
 
     if (algo::starts_with(resource.url, "asset://")) {
         request->request = assetContext->createRequest(resource, callback, loop, assetRoot);
+    } else if (algo::starts_with(resource.url, "mbtiles://")) {
+        request->request = mbtilesContext->createRequest(resource, callback, assetRoot);
     } else {
-        request->request = httpContext->createRequest(resource, callback, loop, response);
+        // Network requests wait in the queue until there is a free slot.
+        request->existingResponse = std::move(response);
+        request->queued = true;
+        queue.push_back(request);
+        startQueuedRequests();
+    }
+}
+
+void DefaultFileSource::Impl::startNetworkRequest(DefaultFileRequest* request) {
+    request->queued = false;
+    request->active = true;
+    activeRequests++;
+    if (isTile(*request)) {
+        activeTileRequests++;
+    }
+
+    auto callback = [request, this] (std::shared_ptr<const Response> res, FileCache::Hint hint) {
+        notify(request, res, hint);
+    };
+
+    request->request = httpContext->createRequest(request->resource, callback, loop,
+                                                  std::move(request->existingResponse));
+}
+
+void DefaultFileSource::Impl::startQueuedRequests() {
+    while (activeRequests < maxActiveRequests) {
+        // Priorities change while requests are queued, so we're scanning for the next request
+        // like the Worker does. The first request wins ties, so that they start in order.
+        auto next = queue.end();
+        for (auto it = queue.begin(); it != queue.end(); ++it) {
+            if (isTile(**it) && activeTileRequests >= maxActiveTileRequests) {
+                continue;
+            }
+            if (next == queue.end() || startsBefore(**it, **next)) {
+                next = it;
+            }
+        }
+
+        if (next == queue.end()) {
+            return;
+        }
+
+        DefaultFileRequest* request = *next;
+        queue.erase(next);
+        startNetworkRequest(request);
+    }
+}
+
+// Removes a request that was completed or canceled, and starts the next queued request in its
+// slot.
+void DefaultFileSource::Impl::finish(DefaultFileRequest* request) {
+    if (request->queued) {
+        queue.remove(request);
+    }
+
+    const bool active = request->active;
+    const bool tile = isTile(*request);
+    pending.erase(request->resource);
+
+    if (active) {
+        activeRequests--;
+        if (tile) {
+            activeTileRequests--;
+        }
+        startQueuedRequests();
     }
 }
 
@@ -161,7 +317,7 @@ void DefaultFileSource::Impl::cancel(Request* req) {
             if (request->request) {
                 request->request->cancel();
             }
-            pending.erase(request->resource);
+            finish(request);
         }
     } else {
         // There is no request for this URL anymore. Likely, the request already completed
@@ -178,17 +334,18 @@ void DefaultFileSource::Impl::notify(DefaultFileRequest* request, std::shared_pt
     assert(find(request->resource) == request);
     assert(response);
 
+    if (cache) {
+        // Store response in database. This happens before observers are notified, so that
+        // anything they do with the cached response, e.g. pinning it, is queued after it.
+        cache->put(request->resource, response, hint);
+    }
+
     // Notify all observers.
     for (auto req : request->observers) {
         req->notify(response);
     }
 
-    if (cache) {
-        // Store response in database
-        cache->put(request->resource, response, hint);
-    }
-
-    pending.erase(request->resource);
+    finish(request);
 }
 
 }
@@ -4,7 +4,9 @@
 #include <mbgl/storage/default_file_source.hpp>
 #include <mbgl/storage/asset_context.hpp>
 #include <mbgl/storage/http_context.hpp>
+#include <mbgl/storage/mbtiles_context.hpp>
 
+#include <list>
 #include <set>
 #include <unordered_map>
 
@@ -19,6 +21,13 @@ struct DefaultFileRequest {
     std::set<Request*> observers;
     RequestBase* request = nullptr;
 
+    // Network requests wait in the queue until there is a free slot for them. The existing
+    // response of a request that waits for revalidation is kept until then.
+    double priority = 0;
+    bool queued = false;
+    bool active = false;
+    std::shared_ptr<const Response> existingResponse;
+
     inline DefaultFileRequest(const Resource& resource_)
         : resource(resource_) {}
 
@@ -31,24 +40,43 @@ struct DefaultFileRequest {
 
 class DefaultFileSource::Impl {
 public:
+    // As many as the HTTP context has connections. A few of them are kept free of tiles.
+    static const std::size_t defaultMaxActiveRequests = 24;
+    static const std::size_t defaultMaxActiveTileRequests = 20;
+
     Impl(uv_loop_t*, FileCache*, const std::string& = "");
 
     void add(Request*);
     void cancel(Request*);
+    void setMaxConnections(std::size_t perHost, std::size_t total);
+    void setMaxActiveRequests(std::size_t requests, std::size_t tileRequests);
+    void setPriority(const Resource&, double priority);
 
 private:
     DefaultFileRequest* find(const Resource&);
 
     void startCacheRequest(const Resource&);
     void startRealRequest(const Resource&, std::shared_ptr<const Response> = nullptr);
+    void startNetworkRequest(DefaultFileRequest*);
+    void startQueuedRequests();
+    void finish(DefaultFileRequest*);
     void notify(DefaultFileRequest*, std::shared_ptr<const Response>, FileCache::Hint);
 
     std::unordered_map<Resource, DefaultFileRequest, Resource::Hash> pending;
+
+    // Network requests that wait for a free slot, in the order they were added.
+    std::list<DefaultFileRequest*> queue;
+    std::size_t activeRequests = 0;
+    std::size_t activeTileRequests = 0;
+    std::size_t maxActiveRequests = defaultMaxActiveRequests;
+    std::size_t maxActiveTileRequests = defaultMaxActiveTileRequests;
+
     uv_loop_t* loop = nullptr;
     FileCache* cache = nullptr;
     const std::string assetRoot;
     std::unique_ptr<AssetContext> assetContext;
     std::unique_ptr<HTTPContext> httpContext;
+    std::unique_ptr<MBTilesContext> mbtilesContext;
 };
 
 }
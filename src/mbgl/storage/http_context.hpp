@@ -13,6 +13,11 @@ class HTTPContext {
 public:
     static std::unique_ptr<HTTPContext> createContext(uv_loop_t*);
 
+    // Connection limits for bursts of tile requests. Servers that support HTTP/2 are sent
+    // multiple requests over a single connection instead.
+    static const std::size_t defaultMaxConnectionsPerHost = 6;
+    static const std::size_t defaultMaxConnections = 24;
+
     HTTPContext(uv_loop_t*);
     virtual ~HTTPContext();
 
@@ -21,6 +26,11 @@ public:
                                        uv_loop_t*,
                                        std::shared_ptr<const Response>) = 0;
 
+    // Limits the number of open connections. Requests beyond the limit wait for a connection
+    // to become available. Backends that leave connection management to the operating
+    // system ignore this.
+    virtual void setMaxConnections(std::size_t /* perHost */, std::size_t /* total */) {}
+
     void addRequest(RequestBase*);
     void removeRequest(RequestBase*);
 
@@ -0,0 +1,28 @@
+#ifndef MBGL_STORAGE_DEFAULT_MBTILES_CONTEXT
+#define MBGL_STORAGE_DEFAULT_MBTILES_CONTEXT
+
+#include <mbgl/storage/request_base.hpp>
+
+typedef struct uv_loop_s uv_loop_t;
+
+namespace mbgl {
+
+// Serves mbtiles:// URLs from MBTiles files. A Source request for mbtiles://path/to/file.mbtiles
+// returns a TileJSON document built from the metadata of the file, whose tile URLs have the form
+// mbtiles://path/to/file.mbtiles/{z}/{x}/{y}. Relative paths are resolved against the asset root,
+// like asset:// URLs.
+//
+// Responses are read from the file directly and never go through the file cache.
+class MBTilesContext {
+public:
+    static std::unique_ptr<MBTilesContext> createContext(uv_loop_t*);
+
+    virtual ~MBTilesContext() = default;
+    virtual RequestBase* createRequest(const Resource&,
+                                       RequestBase::Callback,
+                                       const std::string& assetRoot) = 0;
+};
+
+}
+
+#endif
@@ -0,0 +1,274 @@
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/response.hpp>
+
+#include <mbgl/map/source.hpp>
+#include <mbgl/platform/log.hpp>
+#include <mbgl/style/style_layout.hpp>
+#include <mbgl/style/style_parser.hpp>
+#include <mbgl/util/box.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/string.hpp>
+#include <mbgl/util/tile_cover.hpp>
+#include <mbgl/util/token.hpp>
+#include <mbgl/util/url.hpp>
+
+#include <rapidjson/document.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <memory>
+
+namespace mbgl {
+
+namespace {
+
+// Projects a coordinate to fractional tile coordinates at zoom level z.
+vec2<double> project(const LatLng& latLng, int32_t z) {
+    const double scale = std::pow(2, z);
+    const double latitude = std::max(-util::LATITUDE_MAX, std::min(util::LATITUDE_MAX, latLng.latitude));
+    const double sine = std::sin(latitude * util::DEG2RAD);
+    return {
+        (latLng.longitude + 180) / 360 * scale,
+        (0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / M_PI) * scale
+    };
+}
+
+// Collects the font stacks of a text-font layout property, which may be a constant or a
+// function with a stop per zoom level.
+void addFontStacks(const rapidjson::Value& value, const rapidjson::Value* constants,
+                   std::set<std::string>& fontStacks) {
+    if (value.IsString()) {
+        const std::string font { value.GetString(), value.GetStringLength() };
+        if (!font.empty() && font[0] == '@' && constants && constants->HasMember(font.c_str())) {
+            addFontStacks((*constants)[font.c_str()], nullptr, fontStacks);
+        } else {
+            fontStacks.insert(font);
+        }
+    } else if (value.IsObject() && value.HasMember("stops") && value["stops"].IsArray()) {
+        const rapidjson::Value& stops = value["stops"];
+        for (rapidjson::SizeType i = 0; i < stops.Size(); i++) {
+            if (stops[i].IsArray() && stops[i].Size() == 2) {
+                addFontStacks(stops[i][rapidjson::SizeType(1)], constants, fontStacks);
+            }
+        }
+    }
+}
+
+}
+
+OfflineDownload::OfflineDownload(FileSource& fileSource_, uv_loop_t* loop_, const OfflineRegion& region_,
+                                 const std::string& progressPath_, Callback callback_)
+    : fileSource(fileSource_),
+      loop(loop_),
+      region(region_),
+      progressPath(progressPath_),
+      callback(callback_) {
+}
+
+OfflineDownload::~OfflineDownload() {
+    stop();
+}
+
+void OfflineDownload::start() {
+    if (running) {
+        return;
+    }
+
+    running = true;
+    queue.clear();
+    progress = {};
+
+    completed.clear();
+    {
+        std::ifstream file(progressPath);
+        std::string url;
+        while (std::getline(file, url)) {
+            completed.insert(url);
+        }
+    }
+    progressFile.open(progressPath, std::ios::app);
+
+    // The style and the TileJSON of its sources are requested even if they were completed
+    // before, since they determine the rest of the resources. They are typically answered
+    // by the cache.
+    ensure({ Resource::Kind::Style, region.styleURL }, [this](const Response& res) {
+        parseStyle(res.data);
+    });
+    requestNext();
+}
+
+void OfflineDownload::stop() {
+    running = false;
+    for (auto request : requests) {
+        fileSource.cancel(request);
+    }
+    requests.clear();
+    queue.clear();
+    progressFile.close();
+}
+
+void OfflineDownload::ensure(const Resource& resource, Parse parse) {
+    progress.requiredResources++;
+
+    if (!parse && completed.find(resource.url) != completed.end()) {
+        progress.completedResources++;
+        return;
+    }
+
+    queue.push_back({ resource, std::move(parse) });
+}
+
+void OfflineDownload::requestNext() {
+    while (running && !queue.empty() && requests.size() < concurrentRequests) {
+        Pending pending = std::move(queue.front());
+        queue.pop_front();
+
+        // The request is only known once request() returns, but its callback can't run before.
+        auto request = std::make_shared<Request*>(nullptr);
+        *request = fileSource.request(pending.resource, loop,
+                                      [this, request, pending](const Response& res) {
+            requests.erase(*request);
+
+            if (res.status == Response::Successful) {
+                // Resources of the region must stay available even when the cache is full.
+                fileSource.pin(pending.resource);
+                progress.completedResources++;
+                progress.completedBytes += res.data.size();
+                if (completed.insert(pending.resource.url).second) {
+                    progressFile << pending.resource.url << '\n';
+                    progressFile.flush();
+                }
+                if (pending.parse) {
+                    pending.parse(res);
+                }
+            } else {
+                progress.failedResources++;
+            }
+
+            requestNext();
+
+            progress.complete = queue.empty() && requests.empty();
+            if (callback) {
+                callback(progress);
+            }
+        });
+        requests.insert(*request);
+    }
+}
+
+void OfflineDownload::parseStyle(const std::string& data) {
+    rapidjson::Document document;
+    document.Parse<0>(data.c_str());
+    if (document.HasParseError() || !document.IsObject()) {
+        Log::Error(Event::ParseStyle, "Failed to parse offline style [%s]", region.styleURL.c_str());
+        return;
+    }
+
+    StyleParser parser;
+    parser.parse(document);
+
+    for (const auto& source : parser.getSources()) {
+        if (source->info.type != SourceType::Vector && source->info.type != SourceType::Raster) {
+            continue;
+        }
+
+        if (source->info.url.empty()) {
+            addTiles(source->info);
+        } else {
+            ensure({ Resource::Kind::Source, source->info.url }, [this, source](const Response& res) {
+                rapidjson::Document tileJSON;
+                tileJSON.Parse<0>(res.data.c_str());
+                if (tileJSON.HasParseError() || !tileJSON.IsObject()) {
+                    Log::Error(Event::ParseStyle, "Failed to parse offline source [%s]", source->info.url.c_str());
+                    return;
+                }
+                source->info.parseTileJSONProperties(tileJSON);
+                addTiles(source->info);
+            });
+        }
+    }
+
+    std::set<std::string> fontStacks;
+    const rapidjson::Value* constants = document.HasMember("constants") ? &document["constants"] : nullptr;
+    if (document.HasMember("layers") && document["layers"].IsArray()) {
+        const rapidjson::Value& layers = document["layers"];
+        for (rapidjson::SizeType i = 0; i < layers.Size(); i++) {
+            if (!layers[i].IsObject() || !layers[i].HasMember("layout")) {
+                continue;
+            }
+            const rapidjson::Value& layout = layers[i]["layout"];
+            if (!layout.IsObject() || !layout.HasMember("text-field")) {
+                continue;
+            }
+            if (layout.HasMember("text-font")) {
+                addFontStacks(layout["text-font"], constants, fontStacks);
+            } else {
+                fontStacks.insert(StyleLayoutSymbol().text.font);
+            }
+        }
+    }
+
+    addGlyphs(parser.getGlyphURL(), fontStacks);
+    addSprite(parser.getSprite());
+}
+
+void OfflineDownload::addTiles(const SourceInfo& info) {
+    if (info.tiles.empty()) {
+        return;
+    }
+
+    // Sources with smaller tiles are loaded at higher zoom levels, like Source::getZoom().
+    const double offset = std::log(util::tileSize / info.tile_size) / std::log(2);
+    const int32_t minZoom = std::max<int32_t>(std::floor(region.minZoom + offset), info.min_zoom);
+    const int32_t maxZoom = std::min<int32_t>(std::floor(region.maxZoom + offset), info.max_zoom);
+
+    for (int32_t z = minZoom; z <= maxZoom; z++) {
+        box bounds;
+        bounds.tl = project({ region.bounds.ne.latitude, region.bounds.sw.longitude }, z);
+        bounds.tr = project(region.bounds.ne, z);
+        bounds.br = project({ region.bounds.sw.latitude, region.bounds.ne.longitude }, z);
+        bounds.bl = project(region.bounds.sw, z);
+        bounds.center = (bounds.tl + bounds.br) * 0.5;
+
+        // The tile cover may contain duplicates and tiles just outside of the world.
+        const int32_t tiles = 1 << z;
+        std::set<std::pair<int32_t, int32_t>> covered;
+        for (const auto& id : tileCover(z, bounds, z)) {
+            if (id.x >= 0 && id.x < tiles && id.y >= 0 && id.y < tiles && covered.emplace(id.x, id.y).second) {
+                ensure({ Resource::Kind::Tile, info.tileURL(id, region.pixelRatio) });
+            }
+        }
+    }
+}
+
+void OfflineDownload::addGlyphs(const std::string& glyphURL, const std::set<std::string>& fontStacks) {
+    if (glyphURL.empty()) {
+        return;
+    }
+
+    // Glyphs are requested in ranges of 256 code points.
+    for (const auto& fontStack : fontStacks) {
+        for (uint32_t first = 0; first < 65536; first += 256) {
+            const std::string url = util::replaceTokens(glyphURL, [&](const std::string& name) -> std::string {
+                if (name == "fontstack") return util::percentEncode(fontStack);
+                if (name == "range") return util::toString(first) + "-" + util::toString(first + 255);
+                return "";
+            });
+            ensure({ Resource::Kind::Glyphs, url });
+        }
+    }
+}
+
+void OfflineDownload::addSprite(const std::string& spriteURL) {
+    if (spriteURL.empty()) {
+        return;
+    }
+
+    const std::string base = spriteURL + (region.pixelRatio > 1 ? "@2x" : "");
+    ensure({ Resource::Kind::JSON, base + ".json" });
+    ensure({ Resource::Kind::Image, base + ".png" });
+}
+
+}
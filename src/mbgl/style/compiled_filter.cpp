@@ -0,0 +1,150 @@
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/value_comparison.hpp>
+#include <mbgl/map/geometry_tile.hpp>
+
+namespace mbgl {
+
+class CompiledFilter::Compiler : public mapbox::util::static_visitor<void> {
+public:
+    Compiler(CompiledFilter& filter_, const GeometryTileLayer& layer_)
+        : filter(filter_), layer(layer_) {}
+
+    void operator()(const NullExpression&) const { emit(Op::True); }
+    void operator()(const EqualsExpression& e) const { compare(Op::Equals, e.key, &e.value, &e.value + 1); }
+    void operator()(const NotEqualsExpression& e) const { compare(Op::NotEquals, e.key, &e.value, &e.value + 1); }
+    void operator()(const LessThanExpression& e) const { compare(Op::LessThan, e.key, &e.value, &e.value + 1); }
+    void operator()(const LessThanEqualsExpression& e) const { compare(Op::LessThanEquals, e.key, &e.value, &e.value + 1); }
+    void operator()(const GreaterThanExpression& e) const { compare(Op::GreaterThan, e.key, &e.value, &e.value + 1); }
+    void operator()(const GreaterThanEqualsExpression& e) const { compare(Op::GreaterThanEquals, e.key, &e.value, &e.value + 1); }
+    void operator()(const InExpression& e) const { compare(Op::In, e.key, e.values.data(), e.values.data() + e.values.size()); }
+    void operator()(const NotInExpression& e) const { compare(Op::NotIn, e.key, e.values.data(), e.values.data() + e.values.size()); }
+    void operator()(const AnyExpression& e) const { combine(Op::Any, e.expressions); }
+    void operator()(const AllExpression& e) const { combine(Op::All, e.expressions); }
+    void operator()(const NoneExpression& e) const { combine(Op::None, e.expressions); }
+
+private:
+    std::size_t emit(Op op) const {
+        filter.program.push_back({ op, Key::Missing, 0, 0, 0, 1 });
+        return filter.program.size() - 1;
+    }
+
+    void compare(Op op, const std::string& key, const Value* first, const Value* last) const {
+        Instruction& instruction = filter.program[emit(op)];
+        instruction.first = filter.values.size();
+        instruction.count = last - first;
+        filter.values.insert(filter.values.end(), first, last);
+
+        if (key == "$type") {
+            instruction.key = Key::Type;
+        } else if (!layer.hasKeyIndices()) {
+            instruction.key = Key::Name;
+            instruction.index = filter.names.size();
+            filter.names.push_back(key);
+        } else if (auto index = layer.getKeyIndex(key)) {
+            instruction.key = Key::Index;
+            instruction.index = index.get();
+        }
+    }
+
+    void combine(Op op, const std::vector<FilterExpression>& expressions) const {
+        const std::size_t pc = emit(op);
+        for (const auto& e : expressions) {
+            mapbox::util::apply_visitor(*this, e);
+        }
+
+        // The program may have been reallocated while compiling the operands.
+        Instruction& instruction = filter.program[pc];
+        instruction.count = expressions.size();
+        instruction.size = filter.program.size() - pc;
+    }
+
+    CompiledFilter& filter;
+    const GeometryTileLayer& layer;
+};
+
+CompiledFilter::CompiledFilter(const FilterExpression& expression, const GeometryTileLayer& layer) {
+    mapbox::util::apply_visitor(Compiler(*this, layer), expression);
+}
+
+bool CompiledFilter::evaluate(const GeometryTileFeature& feature, const GeometryTileProperties& properties) const {
+    return run(0, feature, properties);
+}
+
+bool CompiledFilter::run(std::size_t pc, const GeometryTileFeature& feature, const GeometryTileProperties& properties) const {
+    const Instruction& instruction = program[pc];
+
+    switch (instruction.op) {
+    case Op::True:
+        return true;
+
+    case Op::Any:
+    case Op::All:
+    case Op::None: {
+        // Any returns true on the first matching operand, All and None return false on the
+        // first operand that doesn't or does match, respectively.
+        const bool stop = instruction.op != Op::All;
+        std::size_t operand = pc + 1;
+        for (uint32_t i = 0; i < instruction.count; i++) {
+            if (run(operand, feature, properties) == stop) {
+                return instruction.op == Op::Any;
+            }
+            operand += program[operand].size;
+        }
+        return instruction.op != Op::Any;
+    }
+
+    default:
+        break;
+    }
+
+    switch (instruction.key) {
+    case Key::Index:
+        return compare(instruction, properties.get(instruction.index));
+
+    case Key::Name: {
+        mapbox::util::optional<Value> actual = feature.getValue(names[instruction.index]);
+        return compare(instruction, actual ? &actual.get() : nullptr);
+    }
+
+    case Key::Type: {
+        const Value actual(uint64_t(feature.getType()));
+        return compare(instruction, &actual);
+    }
+
+    case Key::Missing:
+    default:
+        return compare(instruction, nullptr);
+    }
+}
+
+bool CompiledFilter::compare(const Instruction& instruction, const Value* actual) const {
+    const Value* first = values.data() + instruction.first;
+    const Value* last = first + instruction.count;
+
+    switch (instruction.op) {
+    case Op::Equals:
+        return actual && util::relaxed_equal(*actual, *first);
+    case Op::NotEquals:
+        return !actual || util::relaxed_not_equal(*actual, *first);
+    case Op::LessThan:
+        return actual && util::relaxed_less(*actual, *first);
+    case Op::LessThanEquals:
+        return actual && util::relaxed_less_equal(*actual, *first);
+    case Op::GreaterThan:
+        return actual && util::relaxed_greater(*actual, *first);
+    case Op::GreaterThanEquals:
+        return actual && util::relaxed_greater_equal(*actual, *first);
+    case Op::In:
+    case Op::NotIn: {
+        bool found = false;
+        for (const Value* v = first; actual && !found && v != last; v++) {
+            found = util::relaxed_equal(*actual, *v);
+        }
+        return found == (instruction.op == Op::In);
+    }
+    default:
+        return false;
+    }
+}
+
+}
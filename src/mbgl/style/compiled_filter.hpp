@@ -0,0 +1,75 @@
+#ifndef MBGL_STYLE_COMPILED_FILTER
+#define MBGL_STYLE_COMPILED_FILTER
+
+#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/style/value.hpp>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+
+class GeometryTileFeature;
+class GeometryTileLayer;
+class GeometryTileProperties;
+
+// A filter expression compiled for one tile layer. The expression tree is flattened
+// into a program, and property keys are resolved to the layer's key indices, so that
+// evaluating the filter for a feature neither walks the variant tree nor looks up keys
+// by name. Keys of layers without key indices are looked up by name instead.
+class CompiledFilter {
+public:
+    CompiledFilter(const FilterExpression&, const GeometryTileLayer&);
+
+    // The properties must have been read from the feature with readProperties(), so
+    // that all filters evaluated against the same feature share a single decode.
+    bool evaluate(const GeometryTileFeature&, const GeometryTileProperties&) const;
+
+private:
+    enum class Op : uint8_t {
+        True,
+        Equals,
+        NotEquals,
+        LessThan,
+        LessThanEquals,
+        GreaterThan,
+        GreaterThanEquals,
+        In,
+        NotIn,
+        Any,
+        All,
+        None
+    };
+
+    enum class Key : uint8_t {
+        Index,   // a key index of the layer
+        Name,    // an index into names, for layers without key indices
+        Type,    // $type
+        Missing  // no feature of the layer has the key
+    };
+
+    // Instructions are stored in prefix order: the operands of Any, All and None
+    // immediately follow the instruction itself.
+    struct Instruction {
+        Op op;
+        Key key;
+        uint32_t index; // of the key, see Key
+        uint32_t first; // first value in values, for comparisons
+        uint32_t count; // number of values, or number of operands of Any, All and None
+        uint32_t size;  // number of instructions, including the operands
+    };
+
+    class Compiler;
+
+    bool run(std::size_t pc, const GeometryTileFeature&, const GeometryTileProperties&) const;
+    bool compare(const Instruction&, const Value*) const;
+
+    std::vector<Instruction> program;
+    std::vector<Value> values;
+    std::vector<std::string> names;
+};
+
+}
+
+#endif
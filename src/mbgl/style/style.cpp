@@ -9,6 +9,7 @@
 #include <mbgl/geometry/sprite_atlas.hpp>
 #include <mbgl/geometry/line_atlas.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/binary.hpp>
 #include <mbgl/util/uv_detail.hpp>
 #include <mbgl/platform/log.hpp>
 #include <csscolorparser/csscolorparser.hpp>
@@ -22,7 +23,8 @@ namespace mbgl {
 Style::Style(const std::string& data, const std::string&,
              uv_loop_t* loop, Environment& env)
     : glyphStore(std::make_unique<GlyphStore>(loop, env)),
-      glyphAtlas(std::make_unique<GlyphAtlas>(1024, 1024)),
+      // Allow a second page of glyphs for maps with large character sets, e.g. CJK labels.
+      glyphAtlas(std::make_unique<GlyphAtlas>(1024, 1024, 2)),
       spriteAtlas(std::make_unique<SpriteAtlas>(512, 512)),
       lineAtlas(std::make_unique<LineAtlas>(512, 512)),
       mtx(std::make_unique<uv::rwlock>()),
@@ -41,11 +43,23 @@ Style::Style(const std::string& data, const std::string&,
     sources = parser.getSources();
     layers = parser.getLayers();
 
+    std::string geometryBuckets;
+    util::BinaryWriter writer(geometryBuckets);
+    for (const auto& layer : layers) {
+        const auto& bucket = layer->bucket;
+        if (bucket && (bucket->type == StyleLayerType::Fill || bucket->type == StyleLayerType::Line)) {
+            writer.writeString(bucket->name);
+            writer.write<uint64_t>(bucket->hash);
+        }
+    }
+    geometryHash = util::hash(geometryBuckets);
+
     spriteURL = parser.getSprite();
     glyphStore->setURL(parser.getGlyphURL());
 
     for (const auto& source : sources) {
         source->setObserver(this);
+        source->setCacheWorker(&workers);
         source->load();
     }
 
@@ -55,6 +69,7 @@ Style::Style(const std::string& data, const std::string&,
 Style::~Style() {
     for (const auto& source : sources) {
         source->setObserver(nullptr);
+        source->setCacheWorker(nullptr);
     }
 
     glyphStore->setObserver(nullptr);
@@ -91,6 +106,13 @@ void Style::update(MapData& data,
     }
 }
 
+void Style::prefetch(const std::vector<TransformState>& path) {
+    for (const auto& source : sources) {
+        // Sources without visible layers don't need their tiles.
+        source->prefetch(source->enabled ? path : std::vector<TransformState>());
+    }
+}
+
 void Style::cascade(const std::vector<std::string>& classes) {
     TimePoint now = Clock::now();
 
@@ -53,6 +53,10 @@ public:
     // a tile is ready so observers can render the tile.
     void update(MapData&, const TransformState&, TexturePool&);
 
+    // Fetch the tiles along the predicted path of the map ahead of time (see
+    // "Source::prefetch()").
+    void prefetch(const std::vector<TransformState>& path);
+
     void cascade(const std::vector<std::string>&);
     void recalculate(float z, TimePoint now);
 
@@ -72,6 +76,10 @@ public:
     std::vector<util::ptr<Source>> sources;
     std::vector<util::ptr<StyleLayer>> layers;
 
+    // Identifies the fill and line buckets of the style, e.g. in the keys of cached buckets.
+    // Changes to paint properties, or to other layers, don't change it.
+    uint64_t geometryHash = 0;
+
 private:
     // GlyphStore::Observer implementation.
     void onGlyphRangeLoaded() override;
@@ -27,6 +27,10 @@ public:
     float min_zoom = -std::numeric_limits<float>::infinity();
     float max_zoom = std::numeric_limits<float>::infinity();
     VisibilityType visibility = VisibilityType::Visible;
+
+    // Identifies the properties that determine the contents of the bucket: its type, source
+    // layer, zoom range, filter and layout. Paint properties don't change it.
+    uint64_t hash = 0;
 };
 
 };
@@ -2,12 +2,16 @@
 #include <mbgl/map/source.hpp>
 #include <mbgl/style/style_layer.hpp>
 #include <mbgl/map/annotation.hpp>
+#include <mbgl/util/binary.hpp>
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/vec.hpp>
 #include <mbgl/util/uv_detail.hpp>
 #include <mbgl/platform/log.hpp>
 #include <csscolorparser/csscolorparser.hpp>
 
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wshadow"
 #pragma GCC diagnostic ignored "-Wunknown-pragmas"
@@ -986,9 +990,41 @@ void StyleParser::parseBucket(JSVal value, util::ptr<StyleLayer> &layer) {
         }
     }
 
+    bucket->hash = hashBucket(value, *bucket);
     layer->bucket = bucket;
 }
 
+uint64_t StyleParser::hashBucket(JSVal value, const StyleBucket& bucket) {
+    // Constants are resolved as they are when parsing, so that changing a constant changes
+    // the hash of the buckets that use it.
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    writer.StartArray();
+    writer.Int(int(bucket.type));
+    writer.String(bucket.source_layer.data(), rapidjson::SizeType(bucket.source_layer.size()));
+    writer.Double(bucket.min_zoom);
+    writer.Double(bucket.max_zoom);
+    if (value.HasMember("filter")) {
+        replaceConstant(value["filter"]).Accept(writer);
+    } else {
+        writer.Null();
+    }
+    writer.StartObject();
+    if (value.HasMember("layout")) {
+        JSVal layout = replaceConstant(value["layout"]);
+        if (layout.IsObject()) {
+            for (auto it = layout.MemberBegin(); it != layout.MemberEnd(); ++it) {
+                writer.String(it->name.GetString(), it->name.GetStringLength());
+                replaceConstant(it->value).Accept(writer);
+            }
+        }
+    }
+    writer.EndObject();
+    writer.EndArray();
+
+    return util::hash(buffer.GetString(), buffer.Size());
+}
+
 void StyleParser::parseSprite(JSVal value) {
     if (value.IsString()) {
         sprite = { value.GetString(), value.GetStringLength() };
@@ -0,0 +1,35 @@
+#include <mbgl/text/collision_grid.hpp>
+
+namespace mbgl {
+
+void CollisionGrid::reset(float minX, float minY, float maxX, float maxY) {
+    originX = minX;
+    originY = minY;
+    scaleX = maxX > minX ? size / (maxX - minX) : 1;
+    scaleY = maxY > minY ? size / (maxY - minY) : 1;
+
+    bounds.clear();
+    boxes.clear();
+    stamps.clear();
+    stamp = 0;
+    for (auto& cell : cells) {
+        cell.clear();
+    }
+}
+
+void CollisionGrid::insert(float x1, float y1, float x2, float y2, const CollisionBox& box) {
+    const uint32_t i = boxes.size();
+    bounds.push_back({{ x1, y1, x2, y2 }});
+    boxes.push_back(box);
+    stamps.push_back(0);
+
+    const int cx1 = cellX(x1), cx2 = cellX(x2);
+    const int cy1 = cellY(y1), cy2 = cellY(y2);
+    for (int cy = cy1; cy <= cy2; cy++) {
+        for (int cx = cx1; cx <= cx2; cx++) {
+            cells[cy * size + cx].push_back(i);
+        }
+    }
+}
+
+}
@@ -0,0 +1,86 @@
+#ifndef MBGL_TEXT_COLLISION_GRID
+#define MBGL_TEXT_COLLISION_GRID
+
+#include <mbgl/text/collision_feature.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace mbgl {
+
+// A uniform grid of the boxes of the labels that were placed in a tile. Boxes are stored
+// in flat arrays, and every cell lists the boxes that overlap it. Unlike an R-tree, queries
+// don't allocate, and inserting doesn't rebalance anything. Boxes that reach outside of the
+// area covered by the grid end up in the cells at its edges.
+class CollisionGrid {
+public:
+    // The number of cells along each axis.
+    static const int size = 32;
+
+    // Removes all boxes, and spreads the cells over the given area.
+    void reset(float minX, float minY, float maxX, float maxY);
+
+    void insert(float x1, float y1, float x2, float y2, const CollisionBox&);
+
+    // Calls fn with each box that intersects the given one, including boxes that only touch
+    // it, until it returns false. Boxes are reported once, in no particular order.
+    template <typename Fn>
+    void query(float x1, float y1, float x2, float y2, Fn fn) {
+        if (++stamp == 0) {
+            // The stamps wrapped around, so they can't tell which boxes were seen.
+            std::fill(stamps.begin(), stamps.end(), 0);
+            stamp = 1;
+        }
+
+        const int cx1 = cellX(x1), cx2 = cellX(x2);
+        const int cy1 = cellY(y1), cy2 = cellY(y2);
+        for (int cy = cy1; cy <= cy2; cy++) {
+            for (int cx = cx1; cx <= cx2; cx++) {
+                for (const uint32_t i : cells[cy * size + cx]) {
+                    // Test all four edges without branching, so that the comparisons can
+                    // run in parallel.
+                    const std::array<float, 4>& b = bounds[i];
+                    const bool hit = (b[0] <= x2) & (x1 <= b[2]) & (b[1] <= y2) & (y1 <= b[3]);
+                    if (hit && stamps[i] != stamp) {
+                        stamps[i] = stamp;
+                        if (!fn(boxes[i])) {
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    inline std::size_t count() const { return boxes.size(); }
+
+private:
+    // Maps a coordinate to the cell it falls into, clamped to the grid. The mapping never
+    // decreases, so boxes that touch always share a cell. NaN ends up in the first cell.
+    inline int cell(float v) const {
+        return v > 0 ? (v < size - 1 ? int(v) : size - 1) : 0;
+    }
+    inline int cellX(float x) const { return cell((x - originX) * scaleX); }
+    inline int cellY(float y) const { return cell((y - originY) * scaleY); }
+
+    float originX = 0, originY = 0;
+    float scaleX = 1, scaleY = 1;
+
+    // x1, y1, x2, y2 of each box, next to each other so that a box is tested with one load.
+    std::vector<std::array<float, 4>> bounds;
+    std::vector<CollisionBox> boxes;
+
+    // The query that last reported each box.
+    std::vector<uint32_t> stamps;
+    uint32_t stamp = 0;
+
+    // The boxes that overlap each cell, row by row. The vectors keep their capacity when
+    // the grid is reset, so placing a tile again doesn't allocate.
+    std::array<std::vector<uint32_t>, size * size> cells;
+};
+
+}
+
+#endif
@@ -4,7 +4,6 @@
 namespace mbgl {
 
 void CollisionTile::reset(const float _angle, const float pitch) {
-    tree.clear();
     angle = _angle;
 
      // Compute the transformation matrix.
@@ -18,6 +17,22 @@ void CollisionTile::reset(const float _angle, const float pitch) {
     // The amount the map is squished depends on the y position.
     // Sort of account for this by making all boxes a bit bigger.
     yStretch = std::pow(_yStretch, 1.3);
+
+    if (index == CollisionIndex::Grid) {
+        // Spread the grid over the rotated tile. Labels are placed at anchors within or
+        // close to the tile, and boxes farther out share the cells at the edges.
+        float minX = 0, minY = 0, maxX = 0, maxY = 0;
+        for (const auto& corner : { vec2<float>(extent, 0), vec2<float>(0, extent), vec2<float>(extent, extent) }) {
+            const auto rotated = corner.matMul(rotationMatrix);
+            minX = std::fmin(minX, rotated.x);
+            minY = std::fmin(minY, rotated.y);
+            maxX = std::fmax(maxX, rotated.x);
+            maxY = std::fmax(maxY, rotated.y);
+        }
+        grid.reset(minX, minY, maxX, maxY);
+    } else {
+        tree.clear();
+    }
 }
 
 float CollisionTile::placeFeature(const CollisionFeature &feature) {
@@ -27,11 +42,8 @@ float CollisionTile::placeFeature(const CollisionFeature &feature) {
     for (auto& box : feature.boxes) {
         const auto anchor = box.anchor.matMul(rotationMatrix);
 
-        std::vector<CollisionTreeBox> blockingBoxes;
-        tree.query(bgi::intersects(getTreeBox(anchor, box)), std::back_inserter(blockingBoxes));
-
-        for (auto& blockingTreeBox : blockingBoxes) {
-            const auto& blocking = std::get<1>(blockingTreeBox);
+        // Returns whether other blocking boxes could still raise the placement scale.
+        auto collide = [&](const CollisionBox& blocking) {
             auto blockingAnchor = blocking.anchor.matMul(rotationMatrix);
 
             // Find the lowest scale at which the two boxes can fit side by side without overlapping.
@@ -67,8 +79,22 @@ float CollisionTile::placeFeature(const CollisionFeature &feature) {
                 minPlacementScale = collisionFreeScale;
             }
 
-            if (minPlacementScale >= maxScale) return minPlacementScale;
+            return minPlacementScale < maxScale;
+        };
+
+        const Box treeBox = getTreeBox(anchor, box);
+        if (index == CollisionIndex::Grid) {
+            grid.query(treeBox.min_corner().get<0>(), treeBox.min_corner().get<1>(),
+                       treeBox.max_corner().get<0>(), treeBox.max_corner().get<1>(), collide);
+        } else {
+            blockingBoxes.clear();
+            tree.query(bgi::intersects(treeBox), std::back_inserter(blockingBoxes));
+            for (auto& blockingTreeBox : blockingBoxes) {
+                if (!collide(std::get<1>(blockingTreeBox))) break;
+            }
         }
+
+        if (minPlacementScale >= maxScale) return minPlacementScale;
     }
 
     return minPlacementScale;
@@ -80,11 +106,19 @@ void CollisionTile::insertFeature(CollisionFeature &feature, const float minPlac
     }
 
     if (minPlacementScale < maxScale) {
-        std::vector<CollisionTreeBox> treeBoxes;
-        for (auto& box : feature.boxes) {
-            treeBoxes.emplace_back(getTreeBox(box.anchor.matMul(rotationMatrix), box), box);
+        if (index == CollisionIndex::Grid) {
+            for (auto& box : feature.boxes) {
+                const Box treeBox = getTreeBox(box.anchor.matMul(rotationMatrix), box);
+                grid.insert(treeBox.min_corner().get<0>(), treeBox.min_corner().get<1>(),
+                            treeBox.max_corner().get<0>(), treeBox.max_corner().get<1>(), box);
+            }
+        } else {
+            std::vector<CollisionTreeBox> treeBoxes;
+            for (auto& box : feature.boxes) {
+                treeBoxes.emplace_back(getTreeBox(box.anchor.matMul(rotationMatrix), box), box);
+            }
+            tree.insert(treeBoxes.begin(), treeBoxes.end());
         }
-        tree.insert(treeBoxes.begin(), treeBoxes.end());
     }
 
 }
@@ -2,6 +2,7 @@
 #define MBGL_TEXT_COLLISION_TILE
 
 #include <mbgl/text/collision_feature.hpp>
+#include <mbgl/text/collision_grid.hpp>
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wunused-function"
@@ -32,11 +33,25 @@ namespace mbgl {
     typedef std::pair<Box, CollisionBox> CollisionTreeBox;
     typedef bgi::rtree<CollisionTreeBox, bgi::linear<16,4>> Tree;
 
+// The spatial index that holds the boxes of the labels that were placed. Both find the same
+// collisions; the grid is faster for tiles with many labels.
+enum class CollisionIndex : uint8_t {
+    RTree,
+    Grid,
+};
+
+#if defined(MBGL_COLLISION_RTREE)
+const CollisionIndex defaultCollisionIndex = CollisionIndex::RTree;
+#else
+const CollisionIndex defaultCollisionIndex = CollisionIndex::Grid;
+#endif
+
 class CollisionTile {
 
     public:
-    inline explicit CollisionTile(float _zoom, float tileExtent, float tileSize, float angle_, bool debug_) :
-        zoom(_zoom), tilePixelRatio(tileExtent / tileSize), debug(debug_) { reset(angle_, 0); }
+    inline explicit CollisionTile(float _zoom, float tileExtent, float tileSize, float angle_, bool debug_,
+                                  CollisionIndex index_ = defaultCollisionIndex) :
+        zoom(_zoom), tilePixelRatio(tileExtent / tileSize), index(index_), extent(tileExtent), debug(debug_) { reset(angle_, 0); }
 
     void reset(const float angle, const float pitch);
     float placeFeature(const CollisionFeature &feature);
@@ -47,6 +62,7 @@ class CollisionTile {
 
     const float zoom;
     const float tilePixelRatio;
+    const CollisionIndex index;
     float angle = 0;
 
     const float minScale = 0.5f;
@@ -57,8 +73,12 @@ class CollisionTile {
     Box getTreeBox(const vec2<float> &anchor, const CollisionBox &box);
 
     Tree tree;
+    CollisionGrid grid;
+    // Reused by R-tree queries.
+    std::vector<CollisionTreeBox> blockingBoxes;
     std::array<float, 4> rotationMatrix;
     float yStretch;
+    const float extent;
     bool debug;
 
 };
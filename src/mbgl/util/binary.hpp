@@ -0,0 +1,95 @@
+#ifndef MBGL_UTIL_BINARY
+#define MBGL_UTIL_BINARY
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace mbgl {
+namespace util {
+
+// Writes plain values in native byte order. Only suitable for data that is read back on
+// the same platform, e.g. caches.
+class BinaryWriter {
+public:
+    BinaryWriter(std::string& out_) : out(out_) {}
+
+    template <typename T>
+    void write(T value) {
+        static_assert(std::is_trivial<T>::value, "only plain values can be written");
+        write(&value, sizeof(T));
+    }
+
+    void write(const void* data, std::size_t size) {
+        out.append(reinterpret_cast<const char*>(data), size);
+    }
+
+    void writeString(const std::string& value) {
+        write<uint32_t>(value.size());
+        write(value.data(), value.size());
+    }
+
+private:
+    std::string& out;
+};
+
+// Reads values written by BinaryWriter. Throws std::runtime_error when reading past the
+// end of the data.
+class BinaryReader {
+public:
+    BinaryReader(const char* data, std::size_t size) : pos(data), end(data + size) {}
+    BinaryReader(const std::string& data) : BinaryReader(data.data(), data.size()) {}
+
+    template <typename T>
+    T read() {
+        static_assert(std::is_trivial<T>::value, "only plain values can be read");
+        T value;
+        std::memcpy(&value, read(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // Returns a pointer to the next size bytes, which stays valid as long as the data.
+    const char* read(std::size_t size) {
+        if (std::size_t(end - pos) < size) {
+            throw std::runtime_error("unexpected end of binary data");
+        }
+        const char* result = pos;
+        pos += size;
+        return result;
+    }
+
+    std::string readString() {
+        const auto size = read<uint32_t>();
+        return std::string(read(size), size);
+    }
+
+    bool atEnd() const {
+        return pos == end;
+    }
+
+private:
+    const char* pos;
+    const char* const end;
+};
+
+// FNV-1a. Unlike std::hash, the result is the same across builds and platforms, so it
+// can be stored.
+inline uint64_t hash(const char* data, std::size_t size) {
+    uint64_t result = 14695981039346656037ull;
+    for (std::size_t i = 0; i < size; i++) {
+        result ^= uint8_t(data[i]);
+        result *= 1099511628211ull;
+    }
+    return result;
+}
+
+inline uint64_t hash(const std::string& data) {
+    return hash(data.data(), data.size());
+}
+
+}
+}
+
+#endif
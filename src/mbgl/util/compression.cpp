@@ -2,6 +2,7 @@
 
 #include <zlib.h>
 
+#include <algorithm>
 #include <cstring>
 #include <stdexcept>
 
@@ -23,74 +24,99 @@ const static bool zlibVersionCheck = []() {
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string &raw) {
-    z_stream deflate_stream;
-    memset(&deflate_stream, 0, sizeof(deflate_stream));
-
-    // TODO: reuse z_streams
-    if (deflateInit(&deflate_stream, Z_DEFAULT_COMPRESSION) != Z_OK) {
+Compressor::Compressor(int level_)
+    : stream(std::make_unique<z_stream>()), level(level_) {
+    if (deflateInit(stream.get(), level) != Z_OK) {
         throw std::runtime_error("failed to initialize deflate");
     }
+}
 
-    deflate_stream.next_in = (Bytef *)raw.data();
-    deflate_stream.avail_in = uInt(raw.size());
+Compressor::~Compressor() {
+    deflateEnd(stream.get());
+}
 
-    std::string result;
-    char out[16384];
+void Compressor::setLevel(int level_) {
+    // Changing the parameters of a freshly reset stream doesn't flush anything.
+    deflateReset(stream.get());
+    if (deflateParams(stream.get(), level_, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to set compression level");
+    }
+    level = level_;
+}
 
-    int code;
-    do {
-        deflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        deflate_stream.avail_out = sizeof(out);
-        code = deflate(&deflate_stream, Z_FINISH);
-        if (result.size() < deflate_stream.total_out) {
-            // append the block to the output string
-            result.append(out, deflate_stream.total_out - result.size());
-        }
-    } while (code == Z_OK);
+std::string Compressor::compress(const std::string &raw) {
+    if (deflateReset(stream.get()) != Z_OK) {
+        throw std::runtime_error("failed to reset deflate");
+    }
 
-    deflateEnd(&deflate_stream);
+    // The bound is large enough to compress everything in a single call.
+    std::string result(deflateBound(stream.get(), uLong(raw.size())), '\0');
 
-    if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+    stream->next_in = (Bytef *)raw.data();
+    stream->avail_in = uInt(raw.size());
+    stream->next_out = reinterpret_cast<Bytef *>(&result[0]);
+    stream->avail_out = uInt(result.size());
+
+    if (deflate(stream.get(), Z_FINISH) != Z_STREAM_END) {
+        throw std::runtime_error(stream->msg ? stream->msg : "compression error");
     }
 
+    result.resize(stream->total_out);
     return result;
 }
 
-std::string decompress(const std::string &raw) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
-
-    // TODO: reuse z_streams
-    if (inflateInit(&inflate_stream) != Z_OK) {
+Decompressor::Decompressor()
+    : stream(std::make_unique<z_stream>()) {
+    // Detect zlib and gzip headers automatically.
+    if (inflateInit2(stream.get(), MAX_WBITS + 32) != Z_OK) {
         throw std::runtime_error("failed to initialize inflate");
     }
+}
 
-    inflate_stream.next_in = (Bytef *)raw.data();
-    inflate_stream.avail_in = uInt(raw.size());
+Decompressor::~Decompressor() {
+    inflateEnd(stream.get());
+}
+
+std::string Decompressor::decompress(const std::string &raw) {
+    if (inflateReset(stream.get()) != Z_OK) {
+        throw std::runtime_error("failed to reset inflate");
+    }
+
+    stream->next_in = (Bytef *)raw.data();
+    stream->avail_in = uInt(raw.size());
 
-    std::string result;
-    char out[15384];
+    // Most data we compress shrinks to less than a quarter.
+    std::string result(std::max<size_t>(raw.size() * 4, 1024), '\0');
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        // result.append(out, sizeof(out) - inflate_stream.avail_out);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (stream->total_out == result.size()) {
+            result.resize(result.size() * 2);
         }
-    } while (code == Z_OK);
-
-    inflateEnd(&inflate_stream);
+        stream->next_out = reinterpret_cast<Bytef *>(&result[stream->total_out]);
+        stream->avail_out = uInt(result.size() - stream->total_out);
+        code = inflate(stream.get(), Z_NO_FLUSH);
+    } while (code == Z_OK && (stream->avail_in > 0 || stream->avail_out == 0));
 
     if (code != Z_STREAM_END) {
-        throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
+        throw std::runtime_error(stream->msg ? stream->msg : "decompression error");
     }
 
+    result.resize(stream->total_out);
     return result;
 }
+
+std::string compress(const std::string &raw, int level) {
+    return Compressor(level).compress(raw);
+}
+
+std::string decompress(const std::string &raw) {
+    return Decompressor().decompress(raw);
+}
+
+bool isGzip(const std::string &raw) {
+    return raw.size() >= 2 && uint8_t(raw[0]) == 0x1F && uint8_t(raw[1]) == 0x8B;
+}
+
 }
 }
@@ -1,14 +1,60 @@
 #ifndef MBGL_UTIL_COMPRESSION
 #define MBGL_UTIL_COMPRESSION
 
+#include <mbgl/util/noncopyable.hpp>
+
+#include <memory>
 #include <string>
 
+struct z_stream_s;
+
 namespace mbgl {
 namespace util {
 
-std::string compress(const std::string &raw);
+// zlib compression levels. The fast level compresses several times faster than the
+// default level, at a slightly worse ratio.
+constexpr int fastCompression = 1;
+constexpr int defaultCompression = -1;
+constexpr int bestCompression = 9;
+
+// Compresses data with zlib. The stream state is kept and reset between calls, so that
+// compressing many small pieces of data doesn't allocate and initialize it each time.
+// Not thread-safe: threads that compress a lot should each own one.
+class Compressor : private util::noncopyable {
+public:
+    explicit Compressor(int level = defaultCompression);
+    ~Compressor();
+
+    void setLevel(int level);
+    int getLevel() const { return level; }
+
+    std::string compress(const std::string &raw);
+
+private:
+    const std::unique_ptr<z_stream_s> stream;
+    int level;
+};
+
+// Decompresses zlib or gzip data, reusing the stream state like Compressor.
+class Decompressor : private util::noncopyable {
+public:
+    Decompressor();
+    ~Decompressor();
+
+    std::string decompress(const std::string &raw);
+
+private:
+    const std::unique_ptr<z_stream_s> stream;
+};
+
+// One-off compression and decompression. Prefer the classes above for repeated use.
+std::string compress(const std::string &raw, int level = defaultCompression);
 std::string decompress(const std::string &raw);
 
+// Whether the data starts with a gzip header, e.g. because it was served with a
+// Content-Encoding of gzip and not decoded.
+bool isGzip(const std::string &raw);
+
 }
 }
 
@@ -2,6 +2,15 @@
 
 const float mbgl::util::tileSize = 512.0f;
 
+const size_t mbgl::util::tileCacheBytes = 32 * 1024 * 1024;
+const size_t mbgl::util::compressedTileCacheBytes = 8 * 1024 * 1024;
+const size_t mbgl::util::memoryBudget = 128 * 1024 * 1024;
+const size_t mbgl::util::maximumCacheSize = 50 * 1024 * 1024;
+const size_t mbgl::util::prefetchRequests = 8;
+const size_t mbgl::util::prefetchBytes = 4 * 1024 * 1024;
+const double mbgl::util::hiddenTilePriority = 1e3;
+const double mbgl::util::prefetchTilePriority = 1e6;
+
 const double mbgl::util::DEG2RAD = M_PI / 180.0;
 const double mbgl::util::RAD2DEG = 180.0 / M_PI;
 const double mbgl::util::M2PI = 2 * M_PI;
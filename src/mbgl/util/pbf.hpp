@@ -10,9 +10,13 @@
 
 #include <string>
 #include <cstring>
+#include <cstdint>
+#include <iterator>
 
 namespace mbgl {
 
+template <typename T> class pbf_varints;
+
 struct pbf {
     struct exception : std::exception { const char *what() const noexcept { return "pbf exception"; } };
     struct unterminated_varint_exception : exception { const char *what() const noexcept { return "pbf unterminated varint exception"; } };
@@ -29,6 +33,19 @@ struct pbf {
     inline bool next(uint32_t tag);
     template <typename T = uint32_t> inline T varint();
     template <typename T = uint32_t> inline T svarint();
+    template <typename T = uint32_t> inline static T zigzag(T n);
+
+    // Decodes the varint at data and advances data past it.
+    inline static uint64_t decodeVarint(const uint8_t *&data, const uint8_t *end);
+
+    // The two ways in which decodeVarint() decodes a varint: unrolled, which requires at
+    // least 10 bytes to remain in the buffer, and byte by byte with a bounds check.
+    inline static uint64_t decodeVarintUnrolled(const uint8_t *&data);
+    inline static uint64_t decodeVarintChecked(const uint8_t *&data, const uint8_t *end);
+
+    // Returns the values of a packed repeated varint field, such as the tags
+    // and the geometry of a vector tile feature.
+    template <typename T = uint32_t> inline pbf_varints<T> packed();
 
     template <typename T = uint32_t, int bytes = 4> inline T fixed();
     inline float float32();
@@ -88,16 +105,45 @@ bool pbf::next(uint32_t requested_tag) {
     return false;
 }
 
-template <typename T>
-T pbf::varint() {
+uint64_t pbf::decodeVarint(const uint8_t *&data, const uint8_t *end) {
+    // A varint is at most 10 bytes long, so if that many bytes remain it can't extend
+    // past the end of the buffer.
+    if (end - data >= 10) {
+        return decodeVarintUnrolled(data);
+    }
+    return decodeVarintChecked(data, end);
+}
+
+uint64_t pbf::decodeVarintUnrolled(const uint8_t *&data) {
+    const uint8_t *pos = data;
+    uint64_t byte;
+    uint64_t result;
+    do {
+        byte = *pos++; result  = (byte & 0x7F);       if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 7;  if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 14; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 21; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 28; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 35; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 42; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 49; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 56; if (!(byte & 0x80)) break;
+        byte = *pos++; result |= (byte & 0x7F) << 63; if (!(byte & 0x80)) break;
+        throw varint_too_long_exception();
+    } while (false);
+    data = pos;
+    return result;
+}
+
+uint64_t pbf::decodeVarintChecked(const uint8_t *&data, const uint8_t *end) {
     uint8_t byte = 0x80;
-    T result = 0;
+    uint64_t result = 0;
     int bitpos;
     for (bitpos = 0; bitpos < 70 && (byte & 0x80); bitpos += 7) {
         if (data >= end) {
             throw unterminated_varint_exception();
         }
-        result |= ((T)(byte = *data) & 0x7F) << bitpos;
+        result |= ((uint64_t)(byte = *data) & 0x7F) << bitpos;
 
         data++;
     }
@@ -108,9 +154,18 @@ T pbf::varint() {
     return result;
 }
 
+template <typename T>
+T pbf::varint() {
+    return static_cast<T>(decodeVarint(data, end));
+}
+
 template <typename T>
 T pbf::svarint() {
-    T n = varint<T>();
+    return zigzag<T>(varint<T>());
+}
+
+template <typename T>
+T pbf::zigzag(T n) {
     return (n >> 1) ^ -(T)(n & 1);
 }
 
@@ -149,6 +204,11 @@ pbf pbf::message() {
     return pbf(pos, bytes);
 }
 
+template <typename T>
+pbf_varints<T> pbf::packed() {
+    return pbf_varints<T>(message());
+}
+
 void pbf::skip() {
     skipValue(value);
 }
@@ -179,6 +239,67 @@ void pbf::skipBytes(uint32_t bytes) {
     data += bytes;
 }
 
+// A range over the values of a packed repeated varint field. The range doesn't
+// own the data, so the buffer must outlive it.
+template <typename T = uint32_t>
+class pbf_varints {
+public:
+    class iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        inline iterator(const uint8_t *pos_, const uint8_t *end_)
+            : pos(pos_), next(pos_), end(end_) {
+            decode();
+        }
+
+        inline const T& operator*() const { return value; }
+
+        inline iterator& operator++() {
+            pos = next;
+            decode();
+            return *this;
+        }
+
+        inline iterator operator++(int) {
+            iterator result = *this;
+            ++*this;
+            return result;
+        }
+
+        inline bool operator==(const iterator& rhs) const { return pos == rhs.pos; }
+        inline bool operator!=(const iterator& rhs) const { return pos != rhs.pos; }
+
+    private:
+        inline void decode() {
+            if (next < end) {
+                value = static_cast<T>(pbf::decodeVarint(next, end));
+            }
+        }
+
+        const uint8_t *pos;
+        const uint8_t *next;
+        const uint8_t *end;
+        T value = 0;
+    };
+
+    inline pbf_varints() = default;
+    inline explicit pbf_varints(const pbf& field)
+        : data(field.data), end_(field.end) {}
+
+    inline iterator begin() const { return iterator(data, end_); }
+    inline iterator end() const { return iterator(end_, end_); }
+    inline bool empty() const { return data >= end_; }
+
+private:
+    const uint8_t *data = nullptr;
+    const uint8_t *end_ = nullptr;
+};
+
 } // end namespace mbgl
 
 #endif
@@ -16,7 +16,7 @@ Raster::Raster(TexturePool& texturePool_)
 
 Raster::~Raster() {
     if (textured) {
-        texturePool.removeTextureID(texture);
+        texturePool.removeTextureID(texture, size_t(width) * height * 4);
     }
 }
 
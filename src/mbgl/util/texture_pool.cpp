@@ -12,25 +12,28 @@ GLuint TexturePool::getTextureID() {
         GLuint new_texture_ids[TextureMax];
         MBGL_CHECK_ERROR(glGenTextures(TextureMax, new_texture_ids));
         for (uint32_t id = 0; id < TextureMax; id++) {
-            texture_ids.insert(new_texture_ids[id]);
+            texture_ids.emplace(new_texture_ids[id], 0);
         }
     }
 
     GLuint id = 0;
 
     if (!texture_ids.empty()) {
-        std::set<GLuint>::iterator id_iterator = texture_ids.begin();
-        id = *id_iterator;
+        auto id_iterator = texture_ids.begin();
+        id = id_iterator->first;
+        bytes -= id_iterator->second;
         texture_ids.erase(id_iterator);
     }
 
     return id;
 }
 
-void TexturePool::removeTextureID(GLuint texture_id) {
+void TexturePool::removeTextureID(GLuint texture_id, size_t texture_bytes) {
     bool needs_clear = false;
 
-    texture_ids.insert(texture_id);
+    if (texture_ids.emplace(texture_id, texture_bytes).second) {
+        bytes += texture_bytes;
+    }
 
     if (texture_ids.size() > TextureMax) {
         needs_clear = true;
@@ -44,8 +47,9 @@ void TexturePool::removeTextureID(GLuint texture_id) {
 
 void TexturePool::clearTextureIDs() {
     auto& env = Environment::Get();
-    for (auto texture : texture_ids) {
-        env.abandonTexture(texture);
+    for (auto& texture : texture_ids) {
+        env.abandonTexture(texture.first);
     }
     texture_ids.clear();
+    bytes = 0;
 }
@@ -4,7 +4,7 @@
 #include <mbgl/util/noncopyable.hpp>
 #include <mbgl/platform/gl.hpp>
 
-#include <set>
+#include <map>
 #include <mutex>
 
 namespace mbgl {
@@ -13,11 +13,17 @@ class TexturePool : private util::noncopyable {
 
 public:
     GLuint getTextureID();
-    void removeTextureID(GLuint texture_id);
+    // Returns a texture to the pool. bytes is the size of the image that was uploaded
+    // to it, which the texture holds on to until it is reused.
+    void removeTextureID(GLuint texture_id, size_t bytes = 0);
     void clearTextureIDs();
 
+    size_t getMemoryUsage() const { return bytes; }
+
 private:
-    std::set<GLuint> texture_ids;
+    // Spare textures, and the size of the image each of them holds.
+    std::map<GLuint, size_t> texture_ids;
+    size_t bytes = 0;
 };
 
 }
@@ -13,4 +13,8 @@ WorkRequest::~WorkRequest() {
     task->cancel();
 }
 
+void WorkRequest::setPriority(double priority) {
+    task->setPriority(priority);
+}
+
 }
@@ -15,6 +15,9 @@ public:
     WorkRequest(Task);
     ~WorkRequest();
 
+    // Changes the priority of the work if it is still queued. Lower values are run first.
+    void setPriority(double);
+
 private:
     std::shared_ptr<WorkTask> task;
 };
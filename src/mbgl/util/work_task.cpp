@@ -4,8 +4,8 @@
 
 namespace mbgl {
 
-WorkTask::WorkTask(std::function<void()> task_, std::function<void()> after_)
-    : task(task_), after(after_) {
+WorkTask::WorkTask(std::function<void()> task_, std::function<void()> after_, double priority_)
+    : task(task_), after(after_), priority(priority_) {
     assert(after);
 }
 
@@ -34,4 +34,12 @@ void WorkTask::cancel() {
     after = {};
 }
 
+double WorkTask::getPriority() const {
+    return priority;
+}
+
+void WorkTask::setPriority(double priority_) {
+    priority = priority_;
+}
+
 } // end namespace mbgl
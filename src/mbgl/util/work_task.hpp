@@ -3,6 +3,7 @@
 
 #include <mbgl/util/noncopyable.hpp>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 
@@ -10,16 +11,21 @@ namespace mbgl {
 
 class WorkTask : private util::noncopyable {
 public:
-    WorkTask(std::function<void()> task, std::function<void()> after);
+    WorkTask(std::function<void()> task, std::function<void()> after, double priority = 0);
 
     void runTask();
     void runAfter();
     void cancel();
 
+    // Lower values are run first. The priority may change while the task is queued.
+    double getPriority() const;
+    void setPriority(double);
+
 private:
     const std::function<void()> task;
     std::function<void()> after;
     std::mutex mutex;
+    std::atomic<double> priority;
 };
 
 } // end namespace mbgl
@@ -3,38 +3,208 @@
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/platform/platform.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <condition_variable>
+#include <exception>
 #include <future>
+#include <deque>
+#include <mutex>
+#include <atomic>
 
 namespace mbgl {
 
+struct Worker::Queue {
+    struct Entry {
+        std::shared_ptr<WorkTask> task;
+        std::function<void ()> after;
+    };
+
+    std::mutex mutex;
+    std::deque<Entry> entries;
+
+    // Set when the owning thread has been sent a process() message, or is currently
+    // processing. Cleared by the owning thread once it found no more work to do.
+    std::atomic<bool> awake { false };
+};
+
 class Worker::Impl {
 public:
-    Impl(uv_loop_t*) {}
+    using Queues = std::vector<std::unique_ptr<Worker::Queue>>;
+
+    Impl(uv_loop_t*, Queues& queues_, std::size_t index_)
+        : queues(queues_), index(index_) {}
 
-    void doWork(std::shared_ptr<WorkTask>& task) {
-        task->runTask();
+    void process() {
+        Queue& own = *queues[index];
+
+        while (true) {
+            Queue::Entry entry;
+            while (pop(entry)) {
+                entry.task->runTask();
+                entry.after();
+                entry = {};
+            }
+
+            // Going idle. Work that is queued after we clear the flag will wake us again;
+            // work that was queued before we cleared it is picked up by checking once more.
+            own.awake = false;
+            if (!pending() || own.awake.exchange(true)) {
+                return;
+            }
+        }
     }
+
+private:
+    // Takes the most urgent entry from this thread's own queue, or steals one from one of
+    // the other threads' queues if this thread doesn't have work of its own.
+    bool pop(Queue::Entry& entry) {
+        for (std::size_t i = 0; i < queues.size(); i++) {
+            Queue& queue = *queues[(index + i) % queues.size()];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.entries.empty()) {
+                continue;
+            }
+
+            // Queues are short, and priorities may change while work is queued, so we're
+            // scanning for the entry instead of maintaining a heap. The first entry wins
+            // ties so that work with equal priority is run in order.
+            auto it = queue.entries.begin();
+            double best = it->task->getPriority();
+            for (auto candidate = std::next(it); candidate != queue.entries.end(); ++candidate) {
+                const double priority = candidate->task->getPriority();
+                if (priority < best) {
+                    best = priority;
+                    it = candidate;
+                }
+            }
+
+            entry = std::move(*it);
+            queue.entries.erase(it);
+            return true;
+        }
+
+        return false;
+    }
+
+    bool pending() {
+        for (auto& queue : queues) {
+            std::lock_guard<std::mutex> lock(queue->mutex);
+            if (!queue->entries.empty()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Queues& queues;
+    const std::size_t index;
 };
 
 Worker::Worker(std::size_t count) {
+    assert(count > 0);
     for (std::size_t i = 0; i < count; i++) {
-        threads.emplace_back(std::make_unique<util::Thread<Impl>>("Worker", util::ThreadPriority::Low));
+        queues.emplace_back(std::make_unique<Queue>());
+    }
+    for (std::size_t i = 0; i < count; i++) {
+        threads.emplace_back(std::make_unique<util::Thread<Impl>>("Worker", util::ThreadPriority::Low, queues, i));
     }
 }
 
 Worker::~Worker() = default;
 
-std::unique_ptr<WorkRequest> Worker::send(Fn work, Fn after) {
-    auto task = std::make_shared<WorkTask>(work, after);
+std::unique_ptr<WorkRequest> Worker::send(Fn work, Fn after, double priority) {
+    auto task = std::make_shared<WorkTask>(work, after, priority);
     auto request = std::make_unique<WorkRequest>(task);
 
-    threads[current]->invokeWithResult(&Worker::Impl::doWork, [task] {
+    // The after callback is run on the invoking thread's run loop.
+    Fn callback = util::RunLoop::current.get()->bind(Fn([task] {
         task->runAfter();
-    }, task);
+    }));
+
+    {
+        Queue& queue = *queues[current];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.entries.push_back({ task, callback });
+    }
+
+    // Wake the thread that owns the queue first, then every idle thread so that they can
+    // steal the work if the owner is still busy.
+    for (std::size_t i = 0; i < threads.size(); i++) {
+        wake((current + i) % threads.size());
+    }
 
     current = (current + 1) % threads.size();
     return request;
 }
 
+void Worker::parallel(std::size_t count, std::function<void (std::size_t)> fn, double priority) {
+    struct Batch {
+        Batch(std::size_t count_, std::function<void (std::size_t)> fn_)
+            : count(count_), fn(std::move(fn_)) {}
+
+        // Claims and runs calls until all of them have been claimed. Helpers that start
+        // after that return immediately; they keep the batch alive, but never call fn.
+        void run() {
+            for (std::size_t i = next++; i < count; i = next++) {
+                std::exception_ptr exception;
+                try {
+                    fn(i);
+                } catch (...) {
+                    exception = std::current_exception();
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (exception && !error) {
+                    error = exception;
+                }
+                if (++finished == count) {
+                    done.notify_all();
+                }
+            }
+        }
+
+        const std::size_t count;
+        const std::function<void (std::size_t)> fn;
+        std::atomic<std::size_t> next { 0 };
+
+        std::mutex mutex;
+        std::condition_variable done;
+        std::size_t finished = 0;
+        std::exception_ptr error;
+    };
+
+    if (count == 0) {
+        return;
+    }
+
+    auto batch = std::make_shared<Batch>(count, std::move(fn));
+
+    // The calling thread takes part, so at most count - 1 helpers are useful.
+    const std::size_t helpers = std::min(count - 1, threads.size());
+    for (std::size_t i = 0; i < helpers; i++) {
+        auto task = std::make_shared<WorkTask>([batch] { batch->run(); }, [] {}, priority);
+        {
+            Queue& queue = *queues[i];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.entries.push_back({ task, [] {} });
+        }
+        wake(i);
+    }
+
+    batch->run();
+
+    std::unique_lock<std::mutex> lock(batch->mutex);
+    batch->done.wait(lock, [&] { return batch->finished == count; });
+    if (batch->error) {
+        std::rethrow_exception(batch->error);
+    }
+}
+
+void Worker::wake(std::size_t index) {
+    if (!queues[index]->awake.exchange(true)) {
+        threads[index]->invoke(&Worker::Impl::process);
+    }
+}
+
 } // end namespace mbgl
@@ -28,10 +28,34 @@ public:
     // Together, this means that an object may make a work request with lambdas which
     // bind references to itself, and if and when those lambdas execute, the references
     // will still be valid.
-    std::unique_ptr<WorkRequest> send(Fn work, Fn after);
+    //
+    // Work is queued on one of the threads in round-robin order, but threads that
+    // run out of work will steal queued work from the other threads, so a single
+    // slow task does not hold up the work queued behind it.
+    //
+    // Queued work with a lower priority value is run first; work with equal priority
+    // is run in the order it was sent. The priority of queued work can be changed
+    // through WorkRequest::setPriority().
+    std::unique_ptr<WorkRequest> send(Fn work, Fn after, double priority = 0);
+
+    // Runs fn(0) ... fn(count - 1) in parallel on the thread pool, and returns once all
+    // of them have finished. This may be called from work that is running on the pool:
+    // the calling thread runs the calls that no other thread has picked up yet itself,
+    // and only waits for calls that are already running, so that it never waits for
+    // work queued behind it. The first exception thrown by fn is rethrown.
+    void parallel(std::size_t count, std::function<void (std::size_t)> fn, double priority = 0);
+
+    // The number of threads in the pool.
+    std::size_t size() const { return threads.size(); }
 
 private:
     class Impl;
+    struct Queue;
+
+    void wake(std::size_t index);
+
+    // The queues must outlive the threads, which access each other's queues.
+    std::vector<std::unique_ptr<Queue>> queues;
     std::vector<std::unique_ptr<util::Thread<Impl>>> threads;
     std::size_t current = 0;
 };
@@ -0,0 +1,48 @@
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<std::size_t> allocationCount { 0 };
+
+}
+
+// Count all heap allocations so that benchmarks can report them.
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace mbgl {
+namespace bench {
+
+std::size_t allocations() {
+    return allocationCount;
+}
+
+const std::vector<std::string>& vectorFixtureLayers() {
+    static const std::vector<std::string> layers {
+        "hillshade", "contour", "landuse", "waterway", "water", "barrier_line",
+        "building", "landuse_overlay", "tunnel", "road", "bridge", "admin",
+        "place_label", "water_label", "poi_label", "road_label", "waterway_label",
+        "housenum_label"
+    };
+    return layers;
+}
+
+}
+}
@@ -0,0 +1,48 @@
+#ifndef MBGL_TEST_BENCHMARK
+#define MBGL_TEST_BENCHMARK
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace mbgl {
+namespace bench {
+
+// The number of heap allocations made by this process so far.
+std::size_t allocations();
+
+// The source layers of test/fixtures/resources/vector.pbf.
+const std::vector<std::string>& vectorFixtureLayers();
+
+// Runs fn repeatedly until at least the given time has passed and returns the
+// average duration of a single run.
+template <typename Fn>
+Duration measure(Fn&& fn, Duration minimum = std::chrono::milliseconds(500)) {
+    std::size_t iterations = 0;
+    const TimePoint start = Clock::now();
+    Duration elapsed;
+    do {
+        fn();
+        iterations++;
+        elapsed = Clock::now() - start;
+    } while (elapsed < minimum);
+    return elapsed / iterations;
+}
+
+// Prints the average duration of a run, and the throughput if the run processed
+// a known number of bytes.
+inline void report(const std::string& name, Duration duration, std::size_t bytes = 0) {
+    const double us = std::chrono::duration<double, std::micro>(duration).count();
+    if (bytes) {
+        std::printf("[ BENCHMARK] %-40s %12.2f us %10.2f MB/s\n", name.c_str(), us, bytes / us);
+    } else {
+        std::printf("[ BENCHMARK] %-40s %12.2f us\n", name.c_str(), us);
+    }
+}
+
+}
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/map/vector_tile_data.hpp>
+#include <mbgl/renderer/fill_bucket.hpp>
+#include <mbgl/renderer/line_bucket.hpp>
+#include <mbgl/util/binary.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Adds the polygons of each layer to a fill bucket and the lines to a line bucket, like
+// the parser does for a style with one fill and one line layer per source layer.
+std::vector<std::unique_ptr<Bucket>> createBuckets(const VectorTile& tile, VectorTileData::BucketBuffers& buffers,
+                                                   std::string* serialized = nullptr) {
+    std::vector<std::unique_ptr<Bucket>> buckets;
+    GeometryBuffer geometries;
+
+    for (const auto& name : bench::vectorFixtureLayers()) {
+        auto layer = tile.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+
+        auto fill = std::make_unique<FillBucket>(buffers.fillVertexBuffer, buffers.triangleElementsBuffer,
+                                                 buffers.lineElementsBuffer);
+        auto line = std::make_unique<LineBucket>(buffers.lineVertexBuffer, buffers.triangleElementsBuffer);
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            feature->readGeometries(geometries);
+            if (feature->getType() == FeatureType::Polygon) {
+                fill->addGeometry(geometries);
+            } else if (feature->getType() == FeatureType::LineString) {
+                line->addGeometry(geometries);
+            }
+        }
+
+        if (serialized) {
+            util::BinaryWriter writer(*serialized);
+            fill->serialize(writer);
+            line->serialize(writer);
+        }
+        buckets.emplace_back(std::move(fill));
+        buckets.emplace_back(std::move(line));
+    }
+
+    return buckets;
+}
+
+}
+
+TEST(Benchmark, BucketCache) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+
+    std::string cached;
+    {
+        VectorTileData::BucketBuffers buffers;
+        std::string serializedBuckets;
+        const auto buckets = createBuckets(tile, buffers, &serializedBuckets);
+
+        util::BinaryWriter writer(cached);
+        buffers.serialize(writer);
+        writer.write<uint32_t>(buckets.size());
+        writer.write(serializedBuckets.data(), serializedBuckets.size());
+    }
+
+    bench::report("Buckets: create from tile", bench::measure([&] {
+        VectorTileData::BucketBuffers buffers;
+        createBuckets(tile, buffers);
+    }));
+
+    std::size_t restored = 0;
+    bench::report("Buckets: restore from cache", bench::measure([&] {
+        VectorTileData::BucketBuffers buffers;
+        std::vector<std::unique_ptr<Bucket>> buckets;
+
+        util::BinaryReader reader(cached);
+        buffers.restore(reader);
+        for (auto count = reader.read<uint32_t>(); count > 0; count -= 2) {
+            buckets.emplace_back(std::make_unique<FillBucket>(buffers.fillVertexBuffer,
+                                                              buffers.triangleElementsBuffer,
+                                                              buffers.lineElementsBuffer, reader));
+            buckets.emplace_back(std::make_unique<LineBucket>(buffers.lineVertexBuffer,
+                                                              buffers.triangleElementsBuffer, reader));
+        }
+        restored += buckets.size();
+    }), cached.size());
+    std::printf("[ BENCHMARK] %zu bytes of cached buckets for a %zu byte tile\n", cached.size(), data.size());
+
+    EXPECT_GT(restored, 0u);
+}
@@ -0,0 +1,105 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+// Included ahead of collision_tile.hpp, since PlacementType::Point would shadow its Point.
+#include <mbgl/style/types.hpp>
+#include <mbgl/text/collision_tile.hpp>
+#include <mbgl/text/get_anchors.hpp>
+#include <mbgl/util/clip_lines.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <cmath>
+
+using namespace mbgl;
+
+namespace {
+
+// The collision features of the labels in the symbol layers of the fixture, as a symbol bucket
+// with the default layout would create them. Every label is assumed to be 10 characters of
+// 16px text, each half an em wide.
+std::vector<CollisionFeature> createFeatures(const VectorTile& tile, float tilePixelRatio) {
+    const float glyphSize = 24.0f;
+    const float width = 10 * glyphSize / 2;
+    const float boxScale = tilePixelRatio * 16 / glyphSize;
+    const float padding = 2 * tilePixelRatio;
+    const float spacing = 250 * tilePixelRatio;
+    const float maxAngle = 45 * M_PI / 180;
+
+    std::vector<CollisionFeature> features;
+    for (const auto& name : { "place_label", "water_label", "poi_label", "road_label", "waterway_label",
+                              "housenum_label" }) {
+        auto layer = tile.getLayer(name);
+        for (std::size_t i = 0; layer && i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            const float left = -width / 2, right = width / 2, top = -glyphSize / 2, bottom = glyphSize / 2;
+
+            if (feature->getType() == FeatureType::LineString) {
+                for (const auto& line : util::clipLines(feature->getGeometries(), 0, 0, 4096, 4096)) {
+                    if (line.size() < 2) continue;
+                    for (const Anchor& anchor : getAnchors(line, spacing, maxAngle, left, right, glyphSize, boxScale, 1)) {
+                        features.emplace_back(line, anchor, top, bottom, left, right, boxScale, padding, true);
+                    }
+                }
+            } else {
+                for (const auto& line : feature->getGeometries()) {
+                    if (line.empty()) continue;
+                    const Anchor anchor(line[0].x, line[0].y, 0, 0.5f);
+                    features.emplace_back(line, anchor, top, bottom, left, right, boxScale, padding, false);
+                }
+            }
+        }
+    }
+    return features;
+}
+
+// Places all labels like a symbol bucket does, once for each of 16 angles, and returns the
+// number of labels that are visible at the tile's zoom level.
+std::size_t place(CollisionTile& collision, std::vector<CollisionFeature>& features) {
+    std::size_t visible = 0;
+    for (int i = 0; i < 16; i++) {
+        collision.reset(i * M_PI / 8, 0);
+        for (auto& feature : features) {
+            const float scale = collision.placeFeature(feature);
+            collision.insertFeature(feature, scale);
+            if (scale <= 1) {
+                visible++;
+            }
+        }
+    }
+    return visible;
+}
+
+}
+
+TEST(Benchmark, CollisionIndex) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+
+    std::vector<CollisionFeature> features = createFeatures(tile, 8);
+    std::size_t boxes = 0;
+    for (const auto& feature : features) {
+        boxes += feature.boxes.size();
+    }
+
+    std::vector<std::size_t> visible;
+    for (const auto index : { CollisionIndex::RTree, CollisionIndex::Grid }) {
+        const char* name = index == CollisionIndex::Grid ? "Collision: grid, 16 angles" : "Collision: R-tree, 16 angles";
+        CollisionTile collision(14, 4096, 512, 0, false, index);
+
+        // The first run fills the index, so that later runs measure placing the tile again.
+        visible.push_back(place(collision, features));
+
+        const std::size_t start = bench::allocations();
+        std::size_t runs = 0;
+        bench::report(name, bench::measure([&] {
+            place(collision, features);
+            runs++;
+        }));
+        std::printf("[ BENCHMARK] %zu labels, %zu boxes, %zu visible, %zu allocations per run\n",
+                    features.size(), boxes, visible.back() / 16, (bench::allocations() - start) / runs);
+    }
+
+    // Both indexes find the same collisions.
+    EXPECT_EQ(visible[0], visible[1]);
+}
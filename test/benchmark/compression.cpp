@@ -0,0 +1,45 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+TEST(Benchmark, Compression) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+
+    const struct {
+        const char* name;
+        int level;
+    } levels[] = {
+        { "fast", util::fastCompression },
+        { "default", util::defaultCompression },
+        { "best", util::bestCompression },
+    };
+
+    for (const auto& level : levels) {
+        util::Compressor compressor(level.level);
+        std::string compressed;
+        bench::report(std::string("Compress: ") + level.name, bench::measure([&] {
+            compressed = compressor.compress(data);
+        }), data.size());
+        std::printf("[ BENCHMARK] %-40s %12.1f %%\n", (std::string("Ratio: ") + level.name).c_str(),
+                    100.0 * compressed.size() / data.size());
+
+        EXPECT_EQ(data, util::decompress(compressed));
+    }
+
+    bench::report("Compress: default, one-off", bench::measure([&] {
+        util::compress(data);
+    }), data.size());
+
+    const std::string compressed = util::compress(data, util::fastCompression);
+    util::Decompressor decompressor;
+    bench::report("Decompress: reused", bench::measure([&] {
+        decompressor.decompress(compressed);
+    }), data.size());
+    bench::report("Decompress: one-off", bench::measure([&] {
+        util::decompress(compressed);
+    }), data.size());
+}
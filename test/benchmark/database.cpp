@@ -0,0 +1,76 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include "sqlite_cache_impl.hpp"
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/util/uv_detail.hpp>
+
+#include <cstdlib>
+#include <unistd.h>
+
+using namespace mbgl;
+
+namespace {
+
+// The databases go to a temporary directory instead of the fixtures.
+std::string tempPath(const std::string& name) {
+    static const std::string dir = [] {
+        const char* tmp = std::getenv("TMPDIR");
+        std::string path = std::string(tmp && *tmp ? tmp : "/tmp") + "/mbgl-benchmark-XXXXXX";
+        return mkdtemp(&path[0]) ? path : std::string(tmp && *tmp ? tmp : "/tmp");
+    }();
+    return dir + "/" + name;
+}
+
+std::shared_ptr<Response> tileResponse(std::size_t i) {
+    auto response = std::make_shared<Response>();
+    response->status = Response::Successful;
+    response->data = std::string(4096 + i, char('a' + i % 26));
+    return response;
+}
+
+std::string tileURL(std::size_t i) {
+    return "mapbox://tiles/" + std::to_string(i);
+}
+
+// Puts tiles into a new database and reads them back. Without a loop, every put is committed
+// on its own; with one, puts are committed in batches.
+void measure(const std::string& name, uv_loop_t* loop) {
+    const std::size_t count = 256;
+    const std::string path = tempPath(name + ".db");
+    for (const auto& suffix : { "", "-wal", "-shm" }) {
+        unlink((path + suffix).c_str());
+    }
+
+    SQLiteCache::Impl cache(loop, path);
+
+    std::size_t bytes = 0;
+    const TimePoint start = Clock::now();
+    for (std::size_t i = 0; i < count; i++) {
+        auto response = tileResponse(i);
+        bytes += response->data.size();
+        cache.put({ Resource::Tile, tileURL(i) }, std::move(response));
+    }
+    cache.flush();
+    const TimePoint put = Clock::now();
+
+    std::size_t found = 0;
+    for (std::size_t i = 0; i < count; i++) {
+        found += bool(cache.get({ Resource::Tile, tileURL(i) }));
+    }
+    const TimePoint get = Clock::now();
+
+    bench::report("Database: " + name + " put", (put - start) / count, bytes / count);
+    bench::report("Database: " + name + " get", (get - put) / count, bytes / count);
+    EXPECT_EQ(count, found);
+}
+
+}
+
+TEST(Benchmark, DatabaseThroughput) {
+    uv::loop loop;
+    measure("unbatched", nullptr);
+    measure("batched", loop.get());
+    loop.run();
+}
@@ -0,0 +1,83 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/style/filter_expression.hpp>
+#include <mbgl/style/filter_expression_private.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Filters of the kind street styles apply to the road layer, one per style layer.
+const char* roadFilters[] = {
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"in\", \"class\", \"motorway\", \"motorway_link\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"in\", \"class\", \"main\", \"street_limited\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"in\", \"class\", \"street\", \"service\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"==\", \"class\", \"path\"], [\"!=\", \"type\", \"steps\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"==\", \"class\", \"path\"], [\"==\", \"type\", \"steps\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"==\", \"class\", \"major_rail\"]]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"==\", \"oneway\", 1], [\"in\", \"class\", \"main\", \"street\"]]",
+    "[\"any\", [\"==\", \"$type\", \"Polygon\"], [\"==\", \"class\", \"aerialway\"]]",
+};
+
+FilterExpression parse(const char* expression) {
+    rapidjson::Document doc;
+    doc.Parse<0>(expression);
+    return parseFilterExpression(doc);
+}
+
+}
+
+TEST(Benchmark, FilterEvaluate) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+    auto layer = tile.getLayer("road");
+    ASSERT_TRUE(bool(layer));
+
+    std::vector<FilterExpression> expressions;
+    for (const char* filter : roadFilters) {
+        expressions.push_back(parse(filter));
+    }
+
+    std::size_t treeMatches = 0;
+    bench::report("Filter: expression tree", bench::measure([&] {
+        for (const auto& expression : expressions) {
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                treeMatches += evaluate(expression, GeometryTileFeatureExtractor(*layer->getFeature(i)));
+            }
+        }
+    }));
+
+    std::size_t compiledMatches = 0;
+    GeometryTileProperties properties;
+    bench::report("Filter: compiled, decode per filter", bench::measure([&] {
+        for (const auto& expression : expressions) {
+            const CompiledFilter compiled(expression, *layer);
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                feature->readProperties(properties);
+                compiledMatches += compiled.evaluate(*feature, properties);
+            }
+        }
+    }));
+
+    bench::report("Filter: compiled, decode per feature", bench::measure([&] {
+        std::vector<CompiledFilter> compiled;
+        for (const auto& expression : expressions) {
+            compiled.emplace_back(expression, *layer);
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            feature->readProperties(properties);
+            for (const auto& filter : compiled) {
+                compiledMatches += filter.evaluate(*feature, properties);
+            }
+        }
+    }));
+
+    EXPECT_LT(0u, treeMatches);
+    EXPECT_LT(0u, compiledMatches);
+}
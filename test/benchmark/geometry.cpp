@@ -0,0 +1,59 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+template <typename Fn>
+void forEachFeature(const VectorTile& tile, Fn&& fn) {
+    for (const auto& name : bench::vectorFixtureLayers()) {
+        auto layer = tile.getLayer(name);
+        for (std::size_t i = 0; layer && i < layer->featureCount(); i++) {
+            fn(*layer->getFeature(i));
+        }
+    }
+}
+
+}
+
+TEST(Benchmark, GeometryDecode) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+
+    // Decode all layers up front so that only geometry decoding is measured.
+    std::size_t features = 0;
+    forEachFeature(tile, [&](const GeometryTileFeature&) { features++; });
+
+    std::size_t coordinates = 0;
+    std::size_t start = bench::allocations();
+    std::size_t runs = 0;
+    bench::report("Geometry: GeometryCollection per feature", bench::measure([&] {
+        forEachFeature(tile, [&](const GeometryTileFeature& feature) {
+            for (const auto& line : feature.getGeometries()) {
+                coordinates += line.size();
+            }
+        });
+        runs++;
+    }));
+    std::printf("[ BENCHMARK] %zu features, %zu allocations per tile\n", features, (bench::allocations() - start) / runs);
+
+    GeometryBuffer buffer;
+    start = bench::allocations();
+    runs = 0;
+    bench::report("Geometry: reused GeometryBuffer", bench::measure([&] {
+        forEachFeature(tile, [&](const GeometryTileFeature& feature) {
+            feature.readGeometries(buffer);
+            for (std::size_t i = 0; i < buffer.size(); i++) {
+                coordinates += buffer[i].size();
+            }
+        });
+        runs++;
+    }));
+    std::printf("[ BENCHMARK] %zu features, %zu allocations per tile\n", features, (bench::allocations() - start) / runs);
+
+    EXPECT_GT(coordinates, 0u);
+}
@@ -0,0 +1,124 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/pbf.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+// Creates a buffer of varints with the given maximum value.
+std::string encodeVarints(std::size_t count, uint64_t max) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<uint64_t> distribution(0, max);
+
+    std::string data;
+    for (std::size_t i = 0; i < count; i++) {
+        uint64_t value = distribution(generator);
+        while (value >= 0x80) {
+            data.push_back(static_cast<char>((value & 0x7F) | 0x80));
+            value >>= 7;
+        }
+        data.push_back(static_cast<char>(value));
+    }
+    return data;
+}
+
+}
+
+TEST(Benchmark, PbfVarint) {
+    for (const uint64_t max : { uint64_t(0x7F), uint64_t(0x3FFF), uint64_t(0xFFFFFFFF) }) {
+        const std::string data = encodeVarints(1 << 20, max);
+        const auto bytes = reinterpret_cast<const uint8_t *>(data.data());
+
+        uint64_t sum = 0;
+        bench::report("pbf: varint < " + std::to_string(max + 1), bench::measure([&] {
+            pbf buffer(bytes, data.size());
+            while (buffer) {
+                sum += buffer.varint<uint64_t>();
+            }
+        }), data.size());
+
+        bench::report("pbf: packed varint < " + std::to_string(max + 1), bench::measure([&] {
+            pbf buffer(bytes, data.size());
+            for (uint64_t value : pbf_varints<uint64_t>(buffer)) {
+                sum += value;
+            }
+        }), data.size());
+
+        EXPECT_GT(sum, 0u);
+    }
+}
+
+TEST(Benchmark, PbfVarintPaths) {
+    for (const uint64_t max : { uint64_t(0x7F), uint64_t(0x3FFF), uint64_t(0xFFFFFFFF) }) {
+        const std::string data = encodeVarints(1 << 20, max);
+        const auto bytes = reinterpret_cast<const uint8_t *>(data.data());
+        const uint8_t *end = bytes + data.size();
+
+        // Both paths decode the same varints, all but those in the last 10 bytes, which only
+        // the checked path could decode.
+        uint64_t unrolled = 0;
+        bench::report("pbf: unrolled varint < " + std::to_string(max + 1), bench::measure([&] {
+            unrolled = 0;
+            for (const uint8_t *pos = bytes; end - pos >= 10;) {
+                unrolled += pbf::decodeVarintUnrolled(pos);
+            }
+        }), data.size());
+
+        uint64_t checked = 0;
+        bench::report("pbf: checked varint < " + std::to_string(max + 1), bench::measure([&] {
+            checked = 0;
+            for (const uint8_t *pos = bytes; end - pos >= 10;) {
+                checked += pbf::decodeVarintChecked(pos, end);
+            }
+        }), data.size());
+
+        EXPECT_EQ(checked, unrolled);
+    }
+}
+
+TEST(Benchmark, PbfGeometries) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+
+    std::size_t count = 0;
+    bench::report("pbf: road geometries", bench::measure([&] {
+        auto layer = tile.getLayer("road");
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            count += layer->getFeature(i)->getGeometries().size();
+        }
+    }));
+
+    EXPECT_GT(count, 0u);
+}
+
+TEST(Benchmark, PbfGlyphs) {
+    const std::string data = util::read_file("test/fixtures/resources/glyphs.pbf");
+
+    uint64_t sum = 0;
+    bench::report("pbf: glyphs", bench::measure([&] {
+        pbf glyphs_pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+        while (glyphs_pbf.next(1)) { // stacks
+            pbf fontstack_pbf = glyphs_pbf.message();
+            while (fontstack_pbf.next(3)) { // glyphs
+                pbf glyph_pbf = fontstack_pbf.message();
+                while (glyph_pbf.next()) {
+                    if (glyph_pbf.tag == 5 || glyph_pbf.tag == 6) { // left, top
+                        sum += glyph_pbf.svarint<int32_t>();
+                    } else if (glyph_pbf.tag != 2) {
+                        sum += glyph_pbf.varint();
+                    } else {
+                        glyph_pbf.skip();
+                    }
+                }
+            }
+        }
+    }), data.size());
+
+    EXPECT_GT(sum, 0u);
+}
@@ -0,0 +1,212 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/map.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+// Answers tile requests with the vector tile fixture after the latency of a mobile network,
+// and all other requests, i.e. for cached buckets, right away with an error. Tile requests
+// for a tile that is already being fetched are answered along with the pending one.
+//
+// Requests with a priority below that of prefetching are made for tiles the map needs right
+// now, i.e. tiles that weren't available when they were first needed. The file source records
+// how many of those there were, and how long the map had to wait for them.
+class DelayedFileSource : public FileSource {
+public:
+    DelayedFileSource(Duration latency_)
+        : latency(latency_),
+          tile(util::read_file("test/fixtures/resources/vector.pbf")),
+          thread([this] { run(); }) {
+    }
+
+    ~DelayedFileSource() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopped = true;
+        }
+        condition.notify_one();
+        thread.join();
+    }
+
+    Request* request(const Resource& resource, uv_loop_t* loop, Callback callback) override {
+        auto req = new Request(resource, loop, std::move(callback));
+        const TimePoint now = Clock::now();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            TimePoint due = now;
+            if (resource.kind == Resource::Kind::Tile) {
+                due += latency;
+                for (const auto& pair : pending) {
+                    if (pair.first->resource.url == resource.url) {
+                        due = std::min(due, pair.second);
+                    }
+                }
+            }
+            pending.emplace(req, due);
+        }
+        condition.notify_one();
+        return req;
+    }
+
+    void setPriority(Request* req, double priority) override {
+        if (req->resource.kind != Resource::Kind::Tile || priority >= util::prefetchTilePriority) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = pending.find(req);
+        if (it != pending.end() && needed.insert(req->resource.url).second) {
+            waited += it->second - Clock::now();
+        }
+    }
+
+    void cancel(Request* req) override {
+        req->cancel();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.erase(req);
+        }
+        req->destruct();
+    }
+
+    void reset() {
+        std::lock_guard<std::mutex> lock(mutex);
+        needed.clear();
+        waited = Duration::zero();
+    }
+
+    std::size_t missingTiles() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return needed.size();
+    }
+
+    Duration waitTime() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return waited;
+    }
+
+private:
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stopped) {
+            const TimePoint now = Clock::now();
+            TimePoint next = TimePoint::max();
+            for (auto it = pending.begin(); it != pending.end();) {
+                if (it->second <= now) {
+                    auto response = std::make_shared<Response>();
+                    if (it->first->resource.kind == Resource::Kind::Tile) {
+                        response->status = Response::Successful;
+                        response->data = tile;
+                    } else {
+                        response->message = "Not found";
+                    }
+                    it->first->notify(response);
+                    it = pending.erase(it);
+                } else {
+                    next = std::min(next, it->second);
+                    ++it;
+                }
+            }
+
+            if (next == TimePoint::max()) {
+                condition.wait(lock);
+            } else {
+                condition.wait_until(lock, next);
+            }
+        }
+    }
+
+    const Duration latency;
+    const std::string tile;
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::map<Request*, TimePoint> pending;
+    std::set<std::string> needed;
+    Duration waited = Duration::zero();
+    bool stopped = false;
+
+    std::thread thread;
+};
+
+const char* const style = R"JSON({
+    "version": 7,
+    "sources": {
+        "vector": { "type": "vector", "tiles": [ "http://tiles/{z}/{x}/{y}.pbf" ], "maxzoom": 14 }
+    },
+    "layers": [
+        { "id": "background", "type": "background", "paint": { "background-color": "white" } },
+        { "id": "water", "type": "fill", "source": "vector", "source-layer": "water",
+          "paint": { "fill-color": "blue" } }
+    ]
+})JSON";
+
+struct Fling {
+    std::size_t missingTiles = 0;
+    Duration waitTime = Duration::zero();
+};
+
+// Flings the map, and returns how many tiles weren't available yet when the map first needed
+// them, and the time the map waited for them in total.
+Fling fling(std::shared_ptr<HeadlessDisplay> display, bool prefetch) {
+    HeadlessView view(display, 512, 512, 1);
+    DelayedFileSource fileSource(std::chrono::milliseconds(300));
+    Map map(view, fileSource, MapMode::Continuous);
+
+    map.setTilePrefetchBudget(prefetch ? util::prefetchRequests : 0, util::prefetchBytes);
+    map.setStyleJSON(style, "");
+    map.setLatLngZoom({ 0, 0 }, 12);
+
+    while (!map.isFullyLoaded()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    fileSource.reset();
+
+    // A fling moves the map with a transition, like the platforms do when a pan gesture
+    // ends with some velocity.
+    map.moveBy(-2048, -1024, std::chrono::seconds(1));
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    while (!map.isFullyLoaded()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    Fling result;
+    result.missingTiles = fileSource.missingTiles();
+    result.waitTime = fileSource.waitTime();
+    return result;
+}
+
+}
+
+TEST(Benchmark, Prefetch) {
+    auto display = std::make_shared<HeadlessDisplay>();
+
+    // Without prefetching, none of the tiles the fling reaches are available when it first needs
+    // them, so all of them are requested then.
+    const Fling withoutPrefetching = fling(display, false);
+    const Fling withPrefetching = fling(display, true);
+
+    std::printf("[ BENCHMARK] %-40s %8zu of %zu tiles\n", "Fling: available when first needed",
+                withoutPrefetching.missingTiles - std::min(withoutPrefetching.missingTiles, withPrefetching.missingTiles),
+                withoutPrefetching.missingTiles);
+    bench::report("Fling: waited for tiles, without prefetching", withoutPrefetching.waitTime);
+    bench::report("Fling: waited for tiles, with prefetching", withPrefetching.waitTime);
+
+    EXPECT_LT(withPrefetching.missingTiles, withoutPrefetching.missingTiles);
+    EXPECT_LT(withPrefetching.waitTime, withoutPrefetching.waitTime);
+}
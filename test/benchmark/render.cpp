@@ -0,0 +1,140 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/gl/recording.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/view.hpp>
+#include <mbgl/map/still_image.hpp>
+#include <mbgl/platform/default/headless_view.hpp>
+#include <mbgl/platform/default/headless_display.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/storage/request.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <future>
+#include <sstream>
+
+using namespace mbgl;
+
+namespace {
+
+// Answers all tile requests with the vector tile fixture, and all other requests with an error.
+class FixtureFileSource : public FileSource {
+public:
+    FixtureFileSource() : tile(util::read_file("test/fixtures/resources/vector.pbf")) {}
+
+    Request* request(const Resource& resource, uv_loop_t* loop, Callback callback) override {
+        auto req = new Request(resource, loop, std::move(callback));
+        auto response = std::make_shared<Response>();
+        if (resource.kind == Resource::Kind::Tile) {
+            response->status = Response::Successful;
+            response->data = tile;
+        } else {
+            response->message = "Not found";
+        }
+        req->notify(response);
+        return req;
+    }
+
+    void cancel(Request* req) override {
+        req->cancel();
+        req->destruct();
+    }
+
+private:
+    const std::string tile;
+};
+
+// One antialiased fill layer per polygon layer of the fixture, drawn with the fill and the
+// fringe shader in each tile.
+std::string fillStyle() {
+    std::string layers;
+    for (const auto name : { "hillshade", "landuse", "water", "building", "landuse_overlay" }) {
+        layers += std::string(R"JSON(, { "id": ")JSON") + name + R"JSON(", "type": "fill", "source": "vector", "source-layer": ")JSON" + name +
+                  R"JSON(", "paint": { "fill-color": "rgba(0, 0, 255, 0.5)" } })JSON";
+    }
+
+    return R"JSON({
+        "version": 7,
+        "sources": {
+            "vector": { "type": "vector", "tiles": [ "http://tiles/{z}/{x}/{y}.pbf" ], "maxzoom": 14 }
+        },
+        "layers": [
+            { "id": "background", "type": "background", "paint": { "background-color": "white" } })JSON" +
+        layers + "]}";
+}
+
+}
+
+#if !defined(MBGL_GL_RECORDING)
+TEST(Benchmark, RenderFill) {
+    auto display = std::make_shared<HeadlessDisplay>();
+    HeadlessView view(display, 1024, 1024, 1);
+    FixtureFileSource fileSource;
+    Map map(view, fileSource, MapMode::Still);
+
+    map.setStyleJSON(fillStyle(), "");
+    map.setLatLngZoom({ 0, 0 }, 12);
+
+    const Duration duration = bench::measure([&] {
+        std::promise<void> promise;
+        map.renderStill([&promise](std::exception_ptr, std::unique_ptr<const StillImage>) {
+            promise.set_value();
+        });
+        promise.get_future().get();
+    });
+
+    const RenderStats stats = map.getRenderStats();
+    bench::report("Render fill layers", duration);
+    std::printf("[ BENCHMARK] %-40s %8zu GL calls %8zu tile layers %8zu batched layers\n",
+                "Render fill layers: last frame", stats.glCalls, stats.tileLayers, stats.batchedLayers);
+}
+#else
+namespace {
+
+// Renders without a GL context, since all GL calls go to the recording.
+class RecordingView : public View {
+public:
+    void activate() override {}
+    void deactivate() override {}
+    void notify() override {}
+    void invalidate(std::function<void()> render) override { render(); }
+};
+
+}
+
+TEST(Benchmark, RenderFillRecorded) {
+    RecordingView view;
+    FixtureFileSource fileSource;
+    std::stringstream recording;
+
+    gl::recording::start(recording);
+    {
+        Map map(view, fileSource, MapMode::Still);
+        map.resize(1024, 1024, 1);
+        map.setStyleJSON(fillStyle(), "");
+        map.setLatLngZoom({ 0, 0 }, 12);
+
+        // The first frame uploads the buckets and the second one only draws them.
+        for (int i = 0; i < 2; i++) {
+            std::promise<void> promise;
+            map.renderStill([&promise](std::exception_ptr, std::unique_ptr<const StillImage>) {
+                promise.set_value();
+            });
+            promise.get_future().get();
+        }
+    }
+    gl::recording::stop();
+
+    const auto frames = gl::recording::summarize(recording);
+    ASSERT_LE(3u, frames.size());
+    for (std::size_t i = 1; i < frames.size(); i++) {
+        const auto& frame = frames[i];
+        std::printf("[ BENCHMARK] %-40s %6zu calls %5zu draws %6zu state (%zu redundant) "
+                    "%5zu binds (%zu redundant) %9zu upload bytes\n",
+                    ("Render fill layers: frame " + std::to_string(i)).c_str(), frame.calls, frame.drawCalls,
+                    frame.stateChanges, frame.redundantStateChanges, frame.binds, frame.redundantBinds,
+                    frame.uploadBytes);
+    }
+}
+#endif
@@ -0,0 +1,108 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/work_request.hpp>
+#include <mbgl/util/worker.hpp>
+
+#include <atomic>
+
+using namespace mbgl;
+
+namespace {
+
+// Stands in for parsing a tile: decodes all features of the vector tile fixture.
+void parseTile(const std::string& data) {
+    const pbf tile_pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+    VectorTile tile(tile_pbf);
+    GeometryBuffer geometries;
+    for (const auto& name : bench::vectorFixtureLayers()) {
+        auto layer = tile.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            layer->getFeature(i)->readGeometries(geometries);
+        }
+    }
+}
+
+struct Timings {
+    Duration centerTile = Duration::zero();
+    Duration visibleTiles = Duration::zero();
+};
+
+// Sends the parse work of the tiles of a pan, in the order in which their data arrives: first
+// tiles that are only cached or kept as fallbacks, then the visible tiles, with the tile at
+// the center of the viewport arriving last. Returns when the center tile, and when all visible
+// tiles were parsed.
+Timings pan(const std::string& data, bool prioritized) {
+    const int hidden = 16;
+    const int visible = 16;
+
+    util::RunLoop loop(uv_default_loop());
+    Worker worker(2);
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+
+    Timings timings;
+    std::atomic<int> remaining { visible };
+    int done = 0;
+    TimePoint start;
+
+    loop.invoke([&] {
+        start = Clock::now();
+
+        for (int i = 0; i < hidden; i++) {
+            // Hidden tiles are ordered after all visible tiles, as in Source::getTilePriority().
+            const double priority = prioritized ? util::hiddenTilePriority + i : 0;
+            requests.push_back(worker.send([&] { parseTile(data); }, [] {}, priority));
+        }
+
+        for (int distance = visible - 1; distance >= 0; distance--) {
+            const double priority = prioritized ? distance : 0;
+            // Tiles are timed when they were parsed rather than in the after callback, which
+            // also waits for this thread to get scheduled.
+            requests.push_back(worker.send([&, distance] {
+                parseTile(data);
+                const Duration elapsed = Clock::now() - start;
+                if (distance == 0) {
+                    timings.centerTile = elapsed;
+                }
+                if (--remaining == 0) {
+                    timings.visibleTiles = elapsed;
+                }
+            }, [&] {
+                if (++done == visible) {
+                    loop.stop();
+                }
+            }, priority));
+        }
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    return timings;
+}
+
+}
+
+TEST(Benchmark, TilePriority) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    const int runs = 10;
+
+    for (const bool prioritized : { false, true }) {
+        Timings total;
+        for (int i = 0; i < runs; i++) {
+            const Timings timings = pan(data, prioritized);
+            total.centerTile += timings.centerTile;
+            total.visibleTiles += timings.visibleTiles;
+        }
+
+        const std::string name = prioritized ? "Pan: prioritized" : "Pan: in arrival order";
+        bench::report(name + ", first center tile", total.centerTile / runs);
+        bench::report(name + ", all visible tiles", total.visibleTiles / runs);
+    }
+}
@@ -0,0 +1,55 @@
+#include "../fixtures/util.hpp"
+#include "benchmark.hpp"
+
+#include <mbgl/map/vector_tile.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+const std::vector<std::string> someLayers {
+    "landuse", "water", "building", "road", "road_label"
+};
+
+std::size_t readLayers(const VectorTile& tile, const std::vector<std::string>& names) {
+    GeometryBuffer geometries;
+    std::size_t count = 0;
+    for (const auto& name : names) {
+        auto layer = tile.getLayer(name);
+        if (!layer) {
+            continue;
+        }
+        for (std::size_t i = 0; i < layer->featureCount(); i++) {
+            auto feature = layer->getFeature(i);
+            if (feature->getValue("class")) {
+                count++;
+            }
+            feature->readGeometries(geometries);
+            count += geometries.size();
+        }
+    }
+    return count;
+}
+
+}
+
+TEST(Benchmark, VectorTileDecode) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    const pbf tile_pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size());
+
+    bench::report("VectorTile: layer headers", bench::measure([&] {
+        VectorTile tile(tile_pbf);
+        EXPECT_TRUE(tile.getLayer("road").get());
+    }), data.size());
+
+    bench::report("VectorTile: 5 of 18 layers", bench::measure([&] {
+        VectorTile tile(tile_pbf);
+        EXPECT_GT(readLayers(tile, someLayers), 0u);
+    }), data.size());
+
+    bench::report("VectorTile: all layers", bench::measure([&] {
+        VectorTile tile(tile_pbf);
+        EXPECT_GT(readLayers(tile, bench::vectorFixtureLayers()), 0u);
+    }), data.size());
+}
@@ -49,3 +49,29 @@ TEST(BinPack, Full) {
         rects.clear();
     }
 }
+
+TEST(BinPack, Repack) {
+    mbgl::BinPack<uint16_t> bin(64, 64);
+    EXPECT_EQ(0.0f, bin.fragmentation());
+
+    std::array<mbgl::Rect<uint16_t>, 4> rects;
+    for (auto& rect : rects) {
+        rect = bin.allocate(32, 32);
+        ASSERT_TRUE(rect.hasArea());
+    }
+    EXPECT_EQ(0.0f, bin.fragmentation());
+
+    // Releasing all but the first cell leaves the bottom half split in two.
+    bin.release(rects[1]);
+    bin.release(rects[2]);
+    bin.release(rects[3]);
+    EXPECT_FLOAT_EQ(1.0f / 3, bin.fragmentation());
+    ASSERT_FALSE(bin.allocate(64, 32).hasArea());
+
+    // Rebuilding the free list around the used cell joins the bottom half.
+    bin.repack(64, 64, std::vector<mbgl::Rect<uint16_t>>{ rects[0] });
+    EXPECT_FLOAT_EQ(1.0f / 3, bin.fragmentation());
+    ASSERT_EQ(mbgl::Rect<uint16_t>(0, 32, 64, 32), bin.allocate(64, 32));
+    ASSERT_EQ(mbgl::Rect<uint16_t>(32, 0, 32, 32), bin.allocate(32, 32));
+    EXPECT_FALSE(bin.allocate(4, 4).hasArea());
+}
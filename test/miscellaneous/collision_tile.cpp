@@ -0,0 +1,65 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/text/collision_tile.hpp>
+
+#include <random>
+
+using namespace mbgl;
+
+namespace {
+
+CollisionFeature pointFeature(float x, float y, float width, float height) {
+    return CollisionFeature({}, Anchor(x, y, 0, 0.5f), -height / 2, height / 2, -width / 2, width / 2, 1, 0, false);
+}
+
+}
+
+TEST(CollisionTile, TouchingBoxes) {
+    for (const auto index : { CollisionIndex::RTree, CollisionIndex::Grid }) {
+        CollisionTile collision(0, 4096, 512, 0, false, index);
+
+        CollisionFeature a = pointFeature(1000, 1000, 100, 20);
+        EXPECT_EQ(collision.minScale, collision.placeFeature(a));
+        collision.insertFeature(a, collision.minScale);
+
+        // Touching boxes collide until the labels move apart by zooming in.
+        CollisionFeature b = pointFeature(1100, 1000, 100, 20);
+        EXPECT_EQ(1.0f, collision.placeFeature(b));
+
+        // Boxes that are farther apart don't.
+        CollisionFeature c = pointFeature(1000, 1021, 100, 20);
+        EXPECT_EQ(collision.minScale, collision.placeFeature(c));
+    }
+}
+
+TEST(CollisionTile, GridMatchesRTree) {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-500, 4600);
+    std::uniform_real_distribution<float> size(10, 1500);
+
+    std::vector<CollisionFeature> features;
+    for (int i = 0; i < 2000; i++) {
+        features.push_back(pointFeature(position(random), position(random), size(random), size(random) / 8));
+    }
+
+    for (const float angle : { 0.0f, 0.3f, 1.0f, 2.5f, -2.0f }) {
+        CollisionTile rtree(0, 4096, 512, angle, false, CollisionIndex::RTree);
+        CollisionTile grid(0, 4096, 512, angle, false, CollisionIndex::Grid);
+
+        std::size_t placed = 0;
+        for (auto& feature : features) {
+            const float scale = rtree.placeFeature(feature);
+            // Labels that can't be shown may report any scale from the maximum up.
+            EXPECT_EQ(std::fmin(scale, rtree.maxScale), std::fmin(grid.placeFeature(feature), grid.maxScale));
+            rtree.insertFeature(feature, scale);
+            grid.insertFeature(feature, scale);
+
+            if (scale < rtree.maxScale) {
+                placed++;
+            }
+        }
+
+        EXPECT_GT(placed, 100u);
+        EXPECT_LT(placed, features.size());
+    }
+}
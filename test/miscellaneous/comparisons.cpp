@@ -4,6 +4,9 @@
 #include <mbgl/map/vector_tile.hpp>
 #include <mbgl/style/filter_expression.hpp>
 #include <mbgl/style/filter_expression_private.hpp>
+#include <mbgl/style/compiled_filter.hpp>
+#include <mbgl/map/live_tile.hpp>
+#include <mbgl/util/io.hpp>
 
 #include <map>
 
@@ -108,3 +111,60 @@ TEST(FilterComparison, None) {
     ASSERT_FALSE(evaluate(parse("[\"none\", [\"==\", \"foo\", 0], [\"==\", \"foo\", 1]]"),
                           {{ std::string("foo"), int64_t(1) }}));
 }
+
+static const char* compiledFilters[] = {
+    "[\"==\", \"class\", \"street\"]",
+    "[\"!=\", \"class\", \"street\"]",
+    "[\"in\", \"class\", \"motorway\", \"main\", \"street\"]",
+    "[\"!in\", \"class\", \"motorway\", \"main\"]",
+    "[\"==\", \"$type\", \"Polygon\"]",
+    "[\"all\", [\"==\", \"$type\", \"LineString\"], [\"!=\", \"oneway\", 1]]",
+    "[\"any\", [\"==\", \"class\", \"path\"], [\"<\", \"scalerank\", 3], [\">=\", \"layer\", 1]]",
+    "[\"none\", [\"==\", \"class\", \"path\"], [\"all\", [\"<=\", \"scalerank\", 3], [\">\", \"ldir\", 0]]]",
+    "[\"==\", \"nonexistent\", \"value\"]",
+    "[\"!=\", \"nonexistent\", \"value\"]",
+};
+
+TEST(FilterComparison, CompiledVectorTile) {
+    const std::string data = util::read_file("test/fixtures/resources/vector.pbf");
+    VectorTile tile(pbf(reinterpret_cast<const uint8_t *>(data.data()), data.size()));
+    std::size_t matches = 0;
+
+    for (const char* layerName : { "road", "landuse", "poi_label", "water" }) {
+        auto layer = tile.getLayer(layerName);
+        ASSERT_TRUE(bool(layer));
+
+        for (const char* filter : compiledFilters) {
+            const FilterExpression expression = parse(filter);
+            const CompiledFilter compiled(expression, *layer);
+            GeometryTileProperties properties;
+
+            for (std::size_t i = 0; i < layer->featureCount(); i++) {
+                auto feature = layer->getFeature(i);
+                feature->readProperties(properties);
+                const bool expected = mbgl::evaluate(expression, GeometryTileFeatureExtractor(*feature));
+                EXPECT_EQ(expected, compiled.evaluate(*feature, properties)) << layerName << " " << filter;
+                matches += expected;
+            }
+        }
+    }
+
+    EXPECT_LT(0u, matches);
+}
+
+TEST(FilterComparison, CompiledLiveTile) {
+    LiveTileLayer layer;
+    layer.addFeature(std::make_shared<LiveTileFeature>(FeatureType::LineString, GeometryCollection(),
+        std::map<std::string, std::string> {{ "class", "street" }}));
+    layer.addFeature(std::make_shared<LiveTileFeature>(FeatureType::Polygon, GeometryCollection(),
+        std::map<std::string, std::string> {{ "class", "main" }}));
+
+    const CompiledFilter street(parse("[\"==\", \"class\", \"street\"]"), layer);
+    const CompiledFilter polygon(parse("[\"==\", \"$type\", \"Polygon\"]"), layer);
+    GeometryTileProperties properties;
+
+    EXPECT_TRUE(street.evaluate(*layer.getFeature(0), properties));
+    EXPECT_FALSE(street.evaluate(*layer.getFeature(1), properties));
+    EXPECT_FALSE(polygon.evaluate(*layer.getFeature(0), properties));
+    EXPECT_TRUE(polygon.evaluate(*layer.getFeature(1), properties));
+}
@@ -0,0 +1,46 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/compression.hpp>
+
+#include <stdexcept>
+
+using namespace mbgl;
+
+TEST(Compression, ReusedStreams) {
+    util::Compressor compressor(util::fastCompression);
+    util::Decompressor decompressor;
+
+    const std::string first(10000, 'a');
+    const std::string second = "Hello, World!";
+
+    EXPECT_EQ(first, decompressor.decompress(compressor.compress(first)));
+    EXPECT_EQ(second, decompressor.decompress(compressor.compress(second)));
+
+    compressor.setLevel(util::bestCompression);
+    EXPECT_EQ(util::bestCompression, compressor.getLevel());
+    EXPECT_EQ(first, decompressor.decompress(compressor.compress(first)));
+
+    EXPECT_EQ("", decompressor.decompress(compressor.compress("")));
+    EXPECT_FALSE(util::isGzip(compressor.compress(second)));
+}
+
+TEST(Compression, Gzip) {
+    // "Hello, World!", as served with a Content-Encoding of gzip.
+    const std::string gzip("\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\xf3\x48\xcd\xc9\xc9\xd7\x51\x08"
+                           "\xcf\x2f\xca\x49\x51\x04\x00\xd0\xc3\x4a\xec\x0d\x00\x00\x00", 33);
+
+    EXPECT_TRUE(util::isGzip(gzip));
+    EXPECT_EQ("Hello, World!", util::decompress(gzip));
+
+    util::Decompressor decompressor;
+    EXPECT_EQ("Hello, World!", decompressor.decompress(gzip));
+    EXPECT_EQ("Hello, World!", decompressor.decompress(util::compress("Hello, World!")));
+}
+
+TEST(Compression, Invalid) {
+    util::Decompressor decompressor;
+    EXPECT_THROW(decompressor.decompress("not compressed"), std::runtime_error);
+
+    // The stream is usable again after an error.
+    EXPECT_EQ("Hello, World!", decompressor.decompress(util::compress("Hello, World!")));
+}
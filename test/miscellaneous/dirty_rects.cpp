@@ -0,0 +1,68 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/dirty_rects.hpp>
+
+#include <iosfwd>
+
+namespace mbgl {
+template <typename T> ::std::ostream& operator<<(::std::ostream& os, const Rect<T>& t) {
+    return os << "Rect { " << t.x << ", " << t.y << ", " << t.w << ", " << t.h << " }";
+}
+}
+
+using namespace mbgl;
+
+TEST(DirtyRects, Empty) {
+    DirtyRects<uint16_t> dirty;
+    EXPECT_TRUE(dirty.empty());
+
+    // Rects without an area are ignored.
+    dirty.add({ 10, 10, 0, 20 });
+    EXPECT_TRUE(dirty.empty());
+    EXPECT_EQ(0u, dirty.area());
+}
+
+TEST(DirtyRects, Coalescing) {
+    DirtyRects<uint16_t> dirty;
+
+    // Adjacent rects are merged.
+    dirty.add({ 0, 0, 16, 16 });
+    dirty.add({ 16, 0, 16, 16 });
+    ASSERT_EQ(1u, dirty.get().size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 32, 16), dirty.get()[0]);
+
+    // Contained rects don't add anything.
+    dirty.add({ 4, 4, 8, 8 });
+    ASSERT_EQ(1u, dirty.get().size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 32, 16), dirty.get()[0]);
+
+    // Distant rects are kept separate.
+    dirty.add({ 512, 512, 16, 16 });
+    ASSERT_EQ(2u, dirty.get().size());
+    EXPECT_EQ(32u * 16 + 16 * 16, dirty.area());
+
+    // A rect that closes the gap to another rect is merged with it.
+    dirty.add({ 32, 0, 16, 24 });
+    ASSERT_EQ(2u, dirty.get().size());
+    EXPECT_EQ(Rect<uint16_t>(512, 512, 16, 16), dirty.get()[0]);
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 48, 24), dirty.get()[1]);
+
+    dirty.clear();
+    EXPECT_TRUE(dirty.empty());
+}
+
+TEST(DirtyRects, Collapsing) {
+    DirtyRects<uint16_t> dirty;
+
+    // A diagonal of small rects can't be coalesced pairwise, but once there are too many of
+    // them they are collapsed into their bounding box.
+    for (uint16_t i = 0; i < 17; i++) {
+        dirty.add({ uint16_t(i * 64), uint16_t(i * 64), 8, 8 });
+        if (i < 16) {
+            ASSERT_EQ(i + 1u, dirty.get().size());
+        }
+    }
+
+    ASSERT_EQ(1u, dirty.get().size());
+    EXPECT_EQ(Rect<uint16_t>(0, 0, 16 * 64 + 8, 16 * 64 + 8), dirty.get()[0]);
+}
@@ -0,0 +1,148 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/glyph_atlas.hpp>
+#include <mbgl/gl/recording.hpp>
+#include <mbgl/platform/gl.hpp>
+#include <mbgl/text/font_stack.hpp>
+
+#include <sstream>
+
+using namespace mbgl;
+
+TEST(GLRecording, Summarize) {
+    std::istringstream stream(
+        "glCreateProgram 1\n"
+        "frame\n"
+        "glUseProgram 1\n"
+        "glUniform4fv 3 0 0 1 1\n"
+        "glEnable 2960\n"
+        "glBindBuffer 34962 2\n"
+        "glBufferData 34962 4096\n"
+        "glVertexAttribPointer 0 2 5122 0 0 0\n"
+        "glDrawElements 4 300\n"
+        "glUseProgram 1\n"
+        "glUniform4fv 3 0 0 1 1\n"
+        "glEnable 2960\n"
+        "glBindBuffer 34962 2\n"
+        "glVertexAttribPointer 0 2 5122 0 0 0\n"
+        "glDrawArrays 5 4\n"
+        "frame\n"
+        "glActiveTexture 33984\n"
+        "glBindTexture 3553 5\n"
+        "glTexSubImage2D 3553 16 16 256\n"
+        "glUniform4fv 3 1 0 0 1\n"
+        "glDisable 2960\n"
+        "glStencilFunc 514 1 255\n"
+        "glStencilFunc 514 1 255\n"
+        "glBindBuffer 34962 6\n"
+        "glVertexAttribPointer 0 2 5122 0 0 0\n");
+
+    const auto frames = gl::recording::summarize(stream);
+    ASSERT_EQ(3u, frames.size());
+
+    // Calls before the first frame.
+    EXPECT_EQ(1u, frames[0].calls);
+    EXPECT_EQ(0u, frames[0].drawCalls);
+
+    EXPECT_EQ(13u, frames[1].calls);
+    EXPECT_EQ(2u, frames[1].drawCalls);
+    EXPECT_EQ(304u, frames[1].vertices);
+    EXPECT_EQ(1u, frames[1].uploads);
+    EXPECT_EQ(4096u, frames[1].uploadBytes);
+    EXPECT_EQ(4u, frames[1].binds);
+    EXPECT_EQ(2u, frames[1].redundantBinds);
+    EXPECT_EQ(6u, frames[1].stateChanges);
+    EXPECT_EQ(3u, frames[1].redundantStateChanges);
+
+    // The state carries over to the next frame. The attribute pointer isn't redundant, since
+    // another buffer is bound.
+    EXPECT_EQ(9u, frames[2].calls);
+    EXPECT_EQ(0u, frames[2].drawCalls);
+    EXPECT_EQ(1u, frames[2].uploads);
+    EXPECT_EQ(256u, frames[2].uploadBytes);
+    EXPECT_EQ(3u, frames[2].binds);
+    EXPECT_EQ(0u, frames[2].redundantBinds);
+    EXPECT_EQ(5u, frames[2].stateChanges);
+    EXPECT_EQ(1u, frames[2].redundantStateChanges);
+}
+
+#if defined(MBGL_GL_RECORDING)
+TEST(GLRecording, Record) {
+    std::stringstream stream;
+    gl::recording::start(stream);
+    gl::recording::frame();
+
+    const GLuint program = MBGL_CHECK_ERROR(glCreateProgram());
+    MBGL_CHECK_ERROR(glUseProgram(program));
+    MBGL_CHECK_ERROR(glUseProgram(program));
+    GLuint buffer = 0;
+    MBGL_CHECK_ERROR(glGenBuffers(1, &buffer));
+    MBGL_CHECK_ERROR(glBindBuffer(GL_ARRAY_BUFFER, buffer));
+    MBGL_CHECK_ERROR(glBufferData(GL_ARRAY_BUFFER, 1024, nullptr, GL_STATIC_DRAW));
+    MBGL_CHECK_ERROR(glDrawArrays(GL_TRIANGLES, 0, 6));
+
+    gl::recording::stop();
+    MBGL_CHECK_ERROR(glUseProgram(0));
+
+    EXPECT_NE(0u, program);
+    EXPECT_NE(0u, buffer);
+
+    const auto frames = gl::recording::summarize(stream);
+    ASSERT_EQ(2u, frames.size());
+    EXPECT_EQ(7u, frames[1].calls);
+    EXPECT_EQ(3u, frames[1].binds);
+    EXPECT_EQ(1u, frames[1].redundantBinds);
+    EXPECT_EQ(1u, frames[1].uploads);
+    EXPECT_EQ(1024u, frames[1].uploadBytes);
+    EXPECT_EQ(1u, frames[1].drawCalls);
+    EXPECT_EQ(6u, frames[1].vertices);
+}
+#endif
+
+#if defined(MBGL_GL_RECORDING)
+TEST(GLRecording, GlyphAtlasUpload) {
+    GlyphAtlas atlas(1024, 1024);
+
+    FontStack fontStack;
+    for (uint32_t id = 'a'; id <= 'c'; id++) {
+        SDFGlyph glyph;
+        glyph.id = id;
+        glyph.metrics.width = 18;
+        glyph.metrics.height = 18;
+        glyph.bitmap = std::string(24 * 24, char(id));
+        fontStack.insert(id, glyph);
+    }
+
+    std::stringstream stream;
+    gl::recording::start(stream);
+
+    // The first upload sends the whole texture.
+    GlyphPositions positions;
+    atlas.addGlyphs(1, U"a", "Test", fontStack, positions);
+    gl::recording::frame();
+    atlas.upload();
+
+    // Later uploads only send the glyphs that were added in the meantime.
+    atlas.addGlyphs(2, U"bc", "Test", fontStack, positions);
+    gl::recording::frame();
+    atlas.upload();
+
+    // Nothing changed.
+    gl::recording::frame();
+    atlas.upload();
+
+    gl::recording::stop();
+
+    const auto frames = gl::recording::summarize(stream);
+    ASSERT_EQ(4u, frames.size());
+    EXPECT_EQ(1u, frames[1].uploads);
+    EXPECT_EQ(1024u * 1024, frames[1].uploadBytes);
+
+    // Both glyphs are 28 x 28 pixels including their padding. They are placed to the right of
+    // and below the first glyph, and are coalesced into a single upload of their bounding box.
+    EXPECT_EQ(1u, frames[2].uploads);
+    EXPECT_EQ(56u * 56, frames[2].uploadBytes);
+
+    EXPECT_EQ(0u, frames[3].calls);
+}
+#endif
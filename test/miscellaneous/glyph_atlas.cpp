@@ -0,0 +1,112 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/geometry/glyph_atlas.hpp>
+#include <mbgl/text/font_stack.hpp>
+
+using namespace mbgl;
+
+namespace {
+
+// Glyphs of the default size take up a cell of 28 x 28 pixels, including their buffer and padding.
+FontStack fontStack(uint32_t size = 18) {
+    FontStack stack;
+    for (uint32_t id = 'a'; id <= 'z'; id++) {
+        SDFGlyph glyph;
+        glyph.id = id;
+        glyph.metrics.width = size;
+        glyph.metrics.height = size;
+        glyph.bitmap = std::string((size + 6) * (size + 6), char(id));
+        stack.insert(id, glyph);
+    }
+    return stack;
+}
+
+}
+
+TEST(GlyphAtlas, Eviction) {
+    // Holds four glyphs.
+    GlyphAtlas atlas(64, 64);
+    const FontStack stack = fontStack();
+
+    GlyphPositions positions;
+    EXPECT_TRUE(atlas.addGlyphs(1, U"abcd", "Test", stack, positions));
+    EXPECT_FALSE(atlas.addGlyphs(1, U"e", "Test", stack, positions));
+    EXPECT_FALSE(positions.at('e').rect.hasArea());
+    EXPECT_EQ(1u, atlas.getStats().overflows);
+
+    // The glyphs of removed tiles stay in the atlas, and are used again by other tiles.
+    atlas.removeGlyphs(1);
+    EXPECT_EQ(4u, atlas.getStats().glyphs);
+    EXPECT_EQ(4u, atlas.getStats().unusedGlyphs);
+
+    GlyphPositions reused;
+    EXPECT_TRUE(atlas.addGlyphs(2, U"a", "Test", stack, reused));
+    EXPECT_EQ(positions.at('a').rect, reused.at('a').rect);
+
+    // Unused glyphs make room for new ones, least recently used first.
+    EXPECT_TRUE(atlas.addGlyphs(2, U"e", "Test", stack, reused));
+    EXPECT_EQ(positions.at('b').rect, reused.at('e').rect);
+
+    const auto stats = atlas.getStats();
+    EXPECT_EQ(1u, stats.pages);
+    EXPECT_EQ(4u, stats.glyphs);
+    EXPECT_EQ(2u, stats.unusedGlyphs);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(1u, stats.overflows);
+
+    // Glyphs that were used again are evicted after those that stayed unused.
+    atlas.removeGlyphs(2);
+    EXPECT_TRUE(atlas.addGlyphs(3, U"f", "Test", stack, reused));
+    EXPECT_EQ(positions.at('c').rect, reused.at('f').rect);
+    EXPECT_EQ(2u, atlas.getStats().evictions);
+}
+
+TEST(GlyphAtlas, Compaction) {
+    GlyphAtlas atlas(64, 64);
+
+    GlyphPositions positions;
+    EXPECT_TRUE(atlas.addGlyphs(1, U"abcd", "Small", fontStack(), positions));
+    atlas.removeGlyphs(1);
+
+    // This glyph needs a cell of 48 x 48 pixels. The free space between the small glyphs is
+    // scattered, so it is rebuilt first. That isn't enough room, so the unused glyphs are
+    // evicted until it fits.
+    EXPECT_TRUE(atlas.addGlyphs(2, U"a", "Large", fontStack(38), positions));
+
+    const auto stats = atlas.getStats();
+    EXPECT_EQ(1u, stats.glyphs);
+    EXPECT_EQ(0u, stats.unusedGlyphs);
+    EXPECT_EQ(4u, stats.evictions);
+    EXPECT_EQ(1u, stats.compactions);
+    EXPECT_EQ(0u, stats.overflows);
+}
+
+TEST(GlyphAtlas, SecondPage) {
+    GlyphAtlas atlas(64, 64, 2);
+    const FontStack stack = fontStack();
+
+    GlyphPositions positions;
+    EXPECT_TRUE(atlas.addGlyphs(1, U"abcd", "Test", stack, positions, 0));
+    EXPECT_EQ(1u, atlas.getStats().pages);
+
+    // Glyphs that don't fit on the first page aren't counted as overflows, since they can be
+    // added to the second page instead.
+    positions.clear();
+    EXPECT_FALSE(atlas.addGlyphs(2, U"ef", "Test", stack, positions, 0));
+    EXPECT_EQ(0u, atlas.getStats().overflows);
+
+    positions.clear();
+    EXPECT_TRUE(atlas.addGlyphs(2, U"ef", "Test", stack, positions, 1));
+    EXPECT_TRUE(positions.at('e').rect.hasArea());
+    EXPECT_TRUE(positions.at('f').rect.hasArea());
+
+    const auto stats = atlas.getStats();
+    EXPECT_EQ(2u, stats.pages);
+    EXPECT_EQ(6u, stats.glyphs);
+    EXPECT_EQ(0u, stats.overflows);
+    EXPECT_EQ(2u * 64 * 64, atlas.getMemoryUsage());
+
+    // There is no third page.
+    EXPECT_FALSE(atlas.addGlyphs(3, U"ghijk", "Test", stack, positions, 1));
+    EXPECT_EQ(3u, atlas.getStats().overflows);
+}
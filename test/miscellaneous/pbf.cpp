@@ -0,0 +1,95 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/util/pbf.hpp>
+
+#include <vector>
+
+using namespace mbgl;
+
+namespace {
+
+pbf buffer(const std::vector<uint8_t>& data) {
+    return pbf(data.data(), data.size());
+}
+
+}
+
+TEST(PBF, Varint) {
+    // Short buffers use the checked decoding path, long buffers the fast path.
+    for (std::size_t padding : { 0, 16 }) {
+        std::vector<uint8_t> data { 0x01, 0xAC, 0x02, 0xFF, 0xFF, 0xFF, 0xFF, 0x0F };
+        data.resize(data.size() + padding);
+
+        pbf reader = buffer(data);
+        EXPECT_EQ(1u, reader.varint());
+        EXPECT_EQ(300u, reader.varint());
+        EXPECT_EQ(0xFFFFFFFFu, reader.varint());
+    }
+}
+
+TEST(PBF, Varint64) {
+    for (std::size_t padding : { 0, 16 }) {
+        std::vector<uint8_t> data { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01 };
+        data.resize(data.size() + padding);
+
+        pbf reader = buffer(data);
+        EXPECT_EQ(0xFFFFFFFFFFFFFFFFull, reader.varint<uint64_t>());
+        EXPECT_EQ(data.data() + 10, reader.data);
+    }
+}
+
+TEST(PBF, VarintErrors) {
+    for (std::size_t padding : { 0, 16 }) {
+        std::vector<uint8_t> data(10 + padding, 0xFF);
+        pbf reader = buffer(data);
+        EXPECT_THROW(reader.varint<uint64_t>(), pbf::varint_too_long_exception);
+    }
+
+    std::vector<uint8_t> data { 0xFF, 0xFF };
+    pbf reader = buffer(data);
+    EXPECT_THROW(reader.varint(), pbf::unterminated_varint_exception);
+}
+
+TEST(PBF, VarintPathsAgree) {
+    // Varints of every length, with all payload bits set, followed by padding so that the
+    // unrolled path may read them.
+    for (std::size_t length = 1; length <= 10; length++) {
+        std::vector<uint8_t> data(length - 1, 0xFF);
+        data.push_back(0x01);
+        data.resize(length + 10, 0x00);
+
+        const uint8_t *unrolled = data.data();
+        const uint8_t *checked = data.data();
+        EXPECT_EQ(pbf::decodeVarintChecked(checked, data.data() + data.size()),
+                  pbf::decodeVarintUnrolled(unrolled));
+        EXPECT_EQ(data.data() + length, unrolled);
+        EXPECT_EQ(data.data() + length, checked);
+    }
+}
+
+TEST(PBF, Svarint) {
+    std::vector<uint8_t> data { 0x00, 0x01, 0x02, 0x03 };
+    pbf reader = buffer(data);
+    EXPECT_EQ(0, reader.svarint<int32_t>());
+    EXPECT_EQ(-1, reader.svarint<int32_t>());
+    EXPECT_EQ(1, reader.svarint<int32_t>());
+    EXPECT_EQ(-2, reader.svarint<int32_t>());
+}
+
+TEST(PBF, PackedVarints) {
+    // Field 2, length-delimited, followed by 3 packed varints.
+    std::vector<uint8_t> data { 0x12, 0x06, 0x03, 0x8E, 0x02, 0x9E, 0xA7, 0x05 };
+
+    pbf reader = buffer(data);
+    ASSERT_TRUE(reader.next());
+    EXPECT_EQ(2u, reader.tag);
+
+    std::vector<uint32_t> values;
+    for (uint32_t value : reader.packed()) {
+        values.push_back(value);
+    }
+    EXPECT_EQ((std::vector<uint32_t> { 3, 270, 86942 }), values);
+    EXPECT_FALSE(reader);
+
+    EXPECT_TRUE(pbf_varints<uint32_t>().empty());
+}
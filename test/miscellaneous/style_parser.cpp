@@ -1,6 +1,8 @@
 #include "../fixtures/util.hpp"
 
 #include <mbgl/style/style_parser.hpp>
+#include <mbgl/style/style_bucket.hpp>
+#include <mbgl/style/style_layer.hpp>
 #include <mbgl/util/io.hpp>
 
 #include <rapidjson/document.h>
@@ -90,3 +92,45 @@ INSTANTIATE_TEST_CASE_P(StyleParser, StyleParserTest, ::testing::ValuesIn([] {
     EXPECT_GT(names.size(), 0ul);
     return names;
 }()));
+
+namespace {
+
+uint64_t bucketHash(const std::string& layer) {
+    const std::string style = R"({ "version": 7, "sources": { "mapbox": { "type": "vector" } }, "layers": [ )"
+        + layer + " ] }";
+
+    rapidjson::Document doc;
+    doc.Parse<0>(style.c_str());
+    EXPECT_FALSE(doc.HasParseError());
+
+    StyleParser parser;
+    parser.parse(doc);
+
+    for (const auto& layer_ : parser.getLayers()) {
+        if (layer_->id == "road") {
+            EXPECT_TRUE(layer_->bucket != nullptr);
+            return layer_->bucket ? layer_->bucket->hash : 0;
+        }
+    }
+
+    ADD_FAILURE() << "Layer wasn't parsed";
+    return 0;
+}
+
+}
+
+TEST(StyleParser, BucketHash) {
+    const uint64_t hash = bucketHash(R"({ "id": "road", "type": "line", "source": "mapbox", "source-layer": "road",
+        "filter": ["==", "class", "main"], "layout": { "line-cap": "round" }, "paint": { "line-width": 2 } })");
+
+    // Paint properties don't change the contents of the bucket.
+    EXPECT_EQ(hash, bucketHash(R"({ "id": "road", "type": "line", "source": "mapbox", "source-layer": "road",
+        "filter": ["==", "class", "main"], "layout": { "line-cap": "round" }, "paint": { "line-width": 4 } })"));
+
+    EXPECT_NE(hash, bucketHash(R"({ "id": "road", "type": "line", "source": "mapbox", "source-layer": "road",
+        "filter": ["==", "class", "main"], "layout": { "line-cap": "butt" }, "paint": { "line-width": 2 } })"));
+    EXPECT_NE(hash, bucketHash(R"({ "id": "road", "type": "line", "source": "mapbox", "source-layer": "road",
+        "filter": ["==", "class", "street"], "layout": { "line-cap": "round" }, "paint": { "line-width": 2 } })"));
+    EXPECT_NE(hash, bucketHash(R"({ "id": "road", "type": "line", "source": "mapbox", "source-layer": "road",
+        "minzoom": 10, "filter": ["==", "class", "main"], "layout": { "line-cap": "round" }, "paint": { "line-width": 2 } })"));
+}
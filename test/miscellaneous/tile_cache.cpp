@@ -0,0 +1,206 @@
+#include "../fixtures/util.hpp"
+
+#include <mbgl/map/tile_cache.hpp>
+#include <mbgl/map/source.hpp>
+#include <mbgl/map/environment.hpp>
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/worker.hpp>
+#include <mbgl/util/work_request.hpp>
+
+#include <limits>
+#include <thread>
+
+using namespace mbgl;
+
+namespace {
+
+class StubFileSource : public FileSource {
+public:
+    Request* request(const Resource&, uv_loop_t*, Callback) override { return nullptr; }
+    void cancel(Request*) override {}
+};
+
+class StubTileData : public TileData {
+public:
+    StubTileData(const TileID& id_, const SourceInfo& source_, size_t bytes_, const std::string& data_)
+        : TileData(id_, source_), bytes(bytes_) {
+        data = data_;
+        setState(State::parsed);
+    }
+
+    void parse() override {}
+    Bucket* getBucket(const StyleLayer&) override { return nullptr; }
+    size_t getMemoryUsage() const override { return bytes; }
+
+private:
+    const size_t bytes;
+};
+
+// TileData requires an Environment, which can't be set up on the main thread.
+template <typename Fn>
+void runInEnvironment(Fn fn) {
+    std::thread([&] {
+        StubFileSource fileSource;
+        Environment env(fileSource);
+        EnvironmentScope scope(env, ThreadType::Map, "Map");
+        fn();
+    }).join();
+}
+
+std::shared_ptr<TileData> tile(uint64_t key, size_t bytes, const std::string& data = "") {
+    static const SourceInfo info;
+    return std::make_shared<StubTileData>(TileID(key, 0, 0, key), info, bytes, data);
+}
+
+}
+
+TEST(TileCache, EvictsLeastRecentlyUsedByBytes) {
+    runInEnvironment([] {
+        TileCache cache(300);
+
+        cache.add(1, tile(1, 100));
+        cache.add(2, tile(2, 100));
+        cache.add(3, tile(3, 100));
+        EXPECT_EQ(300u, cache.getStats().bytes);
+
+        // Refreshing a tile makes it the most recently used one.
+        cache.add(1, tile(1, 100));
+        cache.add(4, tile(4, 150));
+
+        EXPECT_TRUE(cache.has(1));
+        EXPECT_FALSE(cache.has(2));
+        EXPECT_FALSE(cache.has(3));
+        EXPECT_TRUE(cache.has(4));
+        EXPECT_EQ(2u, cache.getStats().tiles);
+        EXPECT_EQ(250u, cache.getStats().bytes);
+        EXPECT_EQ(300u, cache.getStats().peakBytes);
+    });
+}
+
+TEST(TileCache, LimitsTileCount) {
+    runInEnvironment([] {
+        TileCache cache(1000, 2);
+
+        cache.add(1, tile(1, 10));
+        cache.add(2, tile(2, 10));
+        cache.add(3, tile(3, 10));
+        EXPECT_FALSE(cache.has(1));
+        EXPECT_EQ(20u, cache.getStats().bytes);
+
+        cache.setSize(0);
+        cache.setMaxBytes(10);
+        EXPECT_FALSE(cache.has(2));
+        EXPECT_TRUE(cache.has(3));
+        EXPECT_EQ(10u, cache.getStats().bytes);
+    });
+}
+
+TEST(TileCache, TrimsWithoutChangingBudget) {
+    runInEnvironment([] {
+        TileCache cache(300);
+
+        cache.add(1, tile(1, 100));
+        cache.add(2, tile(2, 100));
+        cache.add(3, tile(3, 100));
+
+        cache.trim(150);
+        EXPECT_FALSE(cache.has(1));
+        EXPECT_FALSE(cache.has(2));
+        EXPECT_TRUE(cache.has(3));
+        EXPECT_EQ(100u, cache.getStats().bytes);
+
+        cache.add(4, tile(4, 100));
+        cache.add(5, tile(5, 100));
+        EXPECT_EQ(300u, cache.getMaxBytes());
+        EXPECT_EQ(300u, cache.getStats().bytes);
+    });
+}
+
+TEST(TileCache, CountsHitsAndMisses) {
+    runInEnvironment([] {
+        TileCache cache(1000);
+
+        cache.add(1, tile(1, 10));
+        EXPECT_TRUE(bool(cache.get(1)));
+        EXPECT_FALSE(bool(cache.get(1)));
+        EXPECT_FALSE(bool(cache.get(2)));
+
+        EXPECT_EQ(1u, cache.getStats().hits);
+        EXPECT_EQ(2u, cache.getStats().misses);
+        EXPECT_EQ(0u, cache.getStats().bytes);
+        EXPECT_EQ(0u, cache.getStats().tiles);
+
+        cache.add(2, tile(2, 10));
+        cache.clear();
+        EXPECT_EQ(0u, cache.getStats().bytes);
+        EXPECT_EQ(10u, cache.getStats().peakBytes);
+    });
+}
+
+TEST(TileCache, KeepsCompressedDataOfEvictedTiles) {
+    runInEnvironment([] {
+        TileCache cache(100);
+        const std::string data(10000, 'a');
+
+        cache.add(1, tile(1, 100, data));
+        cache.add(2, tile(2, 100, data));
+        EXPECT_FALSE(cache.has(1));
+        EXPECT_EQ(1u, cache.getCompressedStats().tiles);
+        EXPECT_LT(cache.getCompressedStats().bytes, data.size());
+
+        auto result = cache.getData(1);
+        ASSERT_TRUE(bool(result));
+        EXPECT_EQ(data, result.get());
+        EXPECT_FALSE(bool(cache.getData(1)));
+        EXPECT_EQ(1u, cache.getCompressedStats().hits);
+        EXPECT_EQ(1u, cache.getCompressedStats().misses);
+
+        // Trimming evicts into the compressed tier first.
+        cache.trim(80);
+        EXPECT_FALSE(cache.has(2));
+        EXPECT_EQ(1u, cache.getCompressedStats().tiles);
+
+        cache.trim(0);
+        EXPECT_EQ(0u, cache.getCompressedStats().tiles);
+
+        cache.setMaxCompressedBytes(0);
+        cache.add(3, tile(3, 100, data));
+        cache.add(4, tile(4, 100, data));
+        EXPECT_EQ(0u, cache.getCompressedStats().tiles);
+    });
+}
+
+TEST(TileCache, CompressesOnWorker) {
+    util::RunLoop loop(uv_default_loop());
+    Worker worker(1);
+    std::unique_ptr<WorkRequest> request;
+
+    CompressedTileCache cache(1 << 20);
+    cache.setWorker(&worker);
+    const std::string data(10000, 'a');
+
+    loop.invoke([&] {
+        cache.add(1, data);
+        cache.add(2, data);
+        EXPECT_EQ(0u, cache.getStats().tiles);
+
+        // Data that is still being compressed is returned as is.
+        auto result = cache.get(2);
+        ASSERT_TRUE(bool(result));
+        EXPECT_EQ(data, result.get());
+
+        // The worker runs work of equal priority in order, so this runs after compression.
+        request = worker.send([] {}, [&] {
+            EXPECT_EQ(1u, cache.getStats().tiles);
+            EXPECT_LT(cache.getStats().bytes, data.size());
+            loop.stop();
+        }, std::numeric_limits<double>::max());
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    auto result = cache.get(1);
+    ASSERT_TRUE(bool(result));
+    EXPECT_EQ(data, result.get());
+}
@@ -6,6 +6,7 @@
 #include <mbgl/platform/default/headless_view.hpp>
 #include <mbgl/platform/default/headless_display.hpp>
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/util/constants.hpp>
 
 #include <cstdlib>
 
@@ -123,3 +124,61 @@ TEST(Transform, InvalidBearing) {
     ASSERT_DOUBLE_EQ(2, transform.getScale());
     ASSERT_DOUBLE_EQ(2, transform.getAngle());
 }
+
+TEST(Transform, PredictedPathTransition) {
+    MockView view;
+    Transform transform(view);
+    transform.resize(512, 512, 1, 512, 512);
+    transform.setLatLngZoom({ 0, 0 }, 2);
+
+    // The map is at rest.
+    EXPECT_TRUE(transform.predictedPath(std::chrono::milliseconds(500), 4, Clock::now()).empty());
+
+    transform.setLatLngZoom({ 10, 20 }, 4, std::chrono::seconds(1));
+
+    // Transitions are predicted up to their destination, no matter how long they take.
+    const auto path = transform.predictedPath(std::chrono::milliseconds(500), 4, Clock::now());
+    ASSERT_EQ(4u, path.size());
+    EXPECT_NEAR(10, path.back().getLatLng().latitude, 1e-6);
+    EXPECT_NEAR(20, path.back().getLatLng().longitude, 1e-6);
+    EXPECT_DOUBLE_EQ(4, path.back().getZoom());
+    EXPECT_LT(path.front().getZoom(), path.back().getZoom());
+    EXPECT_LT(path.front().getLatLng().longitude, path.back().getLatLng().longitude);
+
+    transform.cancelTransitions();
+}
+
+TEST(Transform, PredictedPathPan) {
+    MockView view;
+    Transform transform(view);
+    transform.resize(512, 512, 1, 512, 512);
+    transform.setLatLngZoom({ 0, 0 }, 2);
+
+    // Pans of a gesture, 10 ms apart.
+    const TimePoint start = Clock::now();
+    const Duration interval = std::chrono::milliseconds(10);
+    for (int i = 0; i < 4; i++) {
+        transform.panBy(-10, 0, start + i * interval);
+    }
+    const TimePoint lastPan = start + 3 * interval;
+
+    // The map keeps moving east with the velocity of the pans.
+    const double longitude = transform.getLatLng().longitude;
+    const auto path = transform.predictedPath(std::chrono::milliseconds(500), 4, lastPan);
+    ASSERT_EQ(4u, path.size());
+    EXPECT_GT(path.front().getLatLng().longitude, longitude);
+    EXPECT_GT(path.back().getLatLng().longitude, path.front().getLatLng().longitude);
+    EXPECT_DOUBLE_EQ(transform.getZoom(), path.back().getZoom());
+
+    // The velocity is smoothed over the pans: after three intervals of 10 px in 10 ms, it is
+    // 875 px/s, which carries the map 437.5 px within the lookahead.
+    const double scale = transform.getScale();
+    const double degreesPerPixel = 360 / (scale * util::tileSize);
+    EXPECT_NEAR(longitude + 437.5 * degreesPerPixel, path.back().getLatLng().longitude, 1e-6);
+
+    // Once the pans stopped, the map comes to rest.
+    EXPECT_EQ(4u, transform.predictedPath(std::chrono::milliseconds(500), 4,
+                                          lastPan + std::chrono::milliseconds(99)).size());
+    EXPECT_TRUE(transform.predictedPath(std::chrono::milliseconds(500), 4,
+                                        lastPan + std::chrono::milliseconds(100)).empty());
+}
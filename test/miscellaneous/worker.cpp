@@ -4,6 +4,10 @@
 #include <mbgl/util/work_request.hpp>
 #include <mbgl/util/run_loop.hpp>
 
+#include <atomic>
+#include <chrono>
+#include <future>
+
 using namespace mbgl;
 using namespace mbgl::util;
 
@@ -102,3 +106,161 @@ TEST(Worker, WorkRequestCancelsImmediately) {
 
     uv_run(uv_default_loop(), UV_RUN_DEFAULT);
 }
+
+TEST(Worker, SkewedWorkloadIsStolen) {
+    RunLoop loop(uv_default_loop());
+
+    Worker worker(4);
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+
+    // Work is dispatched round-robin, so every fourth work item goes to the same queue. The
+    // first of them blocks its thread until the three others that are queued behind it have
+    // run, which only happens if the other threads steal them. Otherwise it gives up after a
+    // while, so that the test fails instead of hanging.
+    const std::size_t total = 16;
+    std::size_t completed = 0;
+
+    std::promise<void> stolen;
+    auto allStolen = stolen.get_future();
+    std::atomic<std::size_t> behind { 0 };
+    bool ranBehind = false;
+
+    loop.invoke([&] {
+        for (std::size_t i = 0; i < total; i++) {
+            Worker::Fn work = [] {};
+            if (i == 0) {
+                work = [&] {
+                    ranBehind = allStolen.wait_for(std::chrono::seconds(10)) == std::future_status::ready;
+                };
+            } else if (i % 4 == 0) {
+                work = [&] {
+                    if (++behind == total / 4 - 1) {
+                        stolen.set_value();
+                    }
+                };
+            }
+
+            requests.push_back(worker.send(work, [&] {
+                if (++completed == total) {
+                    loop.stop();
+                }
+            }));
+        }
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ(total, completed);
+    EXPECT_TRUE(ranBehind);
+}
+
+TEST(Worker, PrioritizedWorkRunsFirst) {
+    RunLoop loop(uv_default_loop());
+
+    Worker worker(1);
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+    std::vector<int> order;
+
+    // Tiles are sent in arrival order, with the tile at the viewport center arriving last.
+    // With first-in-first-out dispatch, it would only finish after all other tiles.
+    const std::size_t total = 8;
+
+    // Keep the worker busy until all work has been queued.
+    std::promise<void> blocked;
+    auto unblock = blocked.get_future();
+
+    loop.invoke([&] {
+        requests.push_back(worker.send([&] { unblock.get(); }, [] {}));
+
+        for (int distance = total - 1; distance >= 0; distance--) {
+            requests.push_back(worker.send([] {}, [&, distance] {
+                order.push_back(distance);
+                if (order.size() == total) {
+                    loop.stop();
+                }
+            }, distance));
+        }
+
+        blocked.set_value();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    ASSERT_EQ(total, order.size());
+    EXPECT_EQ((std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7 }), order);
+}
+
+TEST(Worker, QueuedWorkCanBeReprioritized) {
+    RunLoop loop(uv_default_loop());
+
+    Worker worker(1);
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+    std::vector<int> order;
+
+    // Keep the worker busy until all work has been queued.
+    std::promise<void> blocked;
+    auto unblock = blocked.get_future();
+
+    loop.invoke([&] {
+        requests.push_back(worker.send([&] { unblock.get(); }, [] {}));
+
+        for (int i = 0; i < 3; i++) {
+            requests.push_back(worker.send([] {}, [&, i] {
+                order.push_back(i);
+                if (order.size() == 3) {
+                    loop.stop();
+                }
+            }, i));
+        }
+
+        // The transform changed, and the last tile is now closest to the center.
+        requests.back()->setPriority(-1);
+        blocked.set_value();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ((std::vector<int> { 2, 0, 1 }), order);
+}
+
+TEST(Worker, ParallelWorkFromWorkerThreads) {
+    RunLoop loop(uv_default_loop());
+
+    // Every thread of the pool starts work that is split up in parallel, so the calling
+    // threads can't rely on idle threads picking up their parallel work.
+    Worker worker(2);
+    std::vector<std::unique_ptr<WorkRequest>> requests;
+    std::atomic<std::size_t> calls { 0 };
+    std::size_t remaining = 4;
+
+    loop.invoke([&] {
+        for (int i = 0; i < 4; i++) {
+            requests.push_back(worker.send([&] {
+                worker.parallel(8, [&](std::size_t) {
+                    usleep(5000);
+                    calls++;
+                });
+            }, [&] {
+                if (--remaining == 0) {
+                    loop.stop();
+                }
+            }));
+        }
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    EXPECT_EQ(32u, calls);
+}
+
+TEST(Worker, ParallelWorkRethrowsExceptions) {
+    Worker worker(2);
+    std::atomic<std::size_t> calls { 0 };
+
+    EXPECT_THROW(worker.parallel(4, [&](std::size_t i) {
+        calls++;
+        if (i == 2) {
+            throw std::runtime_error("failed");
+        }
+    }), std::runtime_error);
+    EXPECT_EQ(4u, calls);
+}
@@ -23,6 +23,7 @@ TEST_F(Storage, CacheRevalidate) {
         EXPECT_EQ(0, res.modified);
         EXPECT_EQ("snowfall", res.etag);
         EXPECT_EQ("", res.message);
+        EXPECT_TRUE(res.downloaded);
 
         fs.request(revalidateSame, uv_default_loop(), [&, res](const Response &res2) {
             EXPECT_EQ(Response::Successful, res2.status);
@@ -33,6 +34,8 @@ TEST_F(Storage, CacheRevalidate) {
             // We're not sending the ETag in the 304 reply, but it should still be there.
             EXPECT_EQ("snowfall", res2.etag);
             EXPECT_EQ("", res2.message);
+            // The data wasn't sent again.
+            EXPECT_FALSE(res2.downloaded);
 
             CacheRevalidateSame.finish();
         });
@@ -4,10 +4,14 @@
 #include "sqlite_cache_impl.hpp"
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/io.hpp>
+#include <mbgl/util/uv_detail.hpp>
 
 #include <sqlite3.h>
 
+#include <thread>
+
 TEST_F(Storage, DatabaseDoesNotExist) {
     using namespace mbgl;
 
@@ -303,3 +307,196 @@ TEST_F(Storage, DatabaseInvalid) {
         EXPECT_EQ(1ul, flo->count({ EventSeverity::Warning, Event::Database, -1, "Trashing invalid database" }));
     }
 }
+
+
+
+namespace {
+
+// Reads from the database with a separate connection, like another process would.
+int64_t countCachedRows(const char* path) {
+    sqlite3* db = nullptr;
+    sqlite3_stmt* stmt = nullptr;
+    int64_t count = -1;
+    if (sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM `http_cache`", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return count;
+}
+
+int64_t autoVacuum(const char* path) {
+    sqlite3* db = nullptr;
+    sqlite3_stmt* stmt = nullptr;
+    int64_t mode = -1;
+    if (sqlite3_open_v2(path, &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(db, "PRAGMA auto_vacuum", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        mode = sqlite3_column_int64(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return mode;
+}
+
+std::shared_ptr<mbgl::Response> tileResponse(std::size_t i) {
+    auto response = std::make_shared<mbgl::Response>();
+    response->status = mbgl::Response::Successful;
+    response->data = std::string(4096 + i, char('a' + i % 26));
+    return response;
+}
+
+std::string tileURL(std::size_t i) {
+    return "mapbox://tiles/" + std::to_string(i);
+}
+
+}
+
+TEST_F(Storage, DatabaseBatchedWrites) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/batch.db");
+    deleteFile("test/fixtures/database/batch.db-wal");
+    deleteFile("test/fixtures/database/batch.db-shm");
+
+    uv::loop loop;
+    {
+        SQLiteCache::Impl cache(loop.get(), "test/fixtures/database/batch.db");
+
+        const std::size_t pending = SQLiteCache::Impl::maxBatchSize / 2;
+        for (std::size_t i = 0; i < pending; i++) {
+            cache.put({ Resource::Tile, tileURL(i) }, tileResponse(i));
+        }
+
+        // The writes are visible to the cache, but not committed yet. Other connections can
+        // still read the database while the batch is open.
+        for (std::size_t i = 0; i < pending; i++) {
+            auto res = cache.get({ Resource::Tile, tileURL(i) });
+            ASSERT_NE(nullptr, res.get());
+            EXPECT_EQ(tileResponse(i)->data, res->data);
+        }
+        EXPECT_EQ(0, countCachedRows("test/fixtures/database/batch.db"));
+
+        // The batch is committed by the timer.
+        loop.run();
+        EXPECT_EQ(int64_t(pending), countCachedRows("test/fixtures/database/batch.db"));
+
+        // A full batch is committed right away.
+        for (std::size_t i = 0; i < SQLiteCache::Impl::maxBatchSize; i++) {
+            cache.put({ Resource::Tile, tileURL(pending + i) }, tileResponse(pending + i));
+        }
+        EXPECT_EQ(int64_t(pending + SQLiteCache::Impl::maxBatchSize),
+                  countCachedRows("test/fixtures/database/batch.db"));
+
+        // Pending writes are committed when the cache goes away.
+        cache.refresh({ Resource::Tile, tileURL(0) }, 1234);
+        cache.put({ Resource::Tile, tileURL(1000) }, tileResponse(1000));
+    }
+    loop.run();
+
+    EXPECT_EQ(int64_t(SQLiteCache::Impl::maxBatchSize * 3 / 2 + 1),
+              countCachedRows("test/fixtures/database/batch.db"));
+
+    SQLiteCache::Impl cache(nullptr, "test/fixtures/database/batch.db");
+    auto res = cache.get({ Resource::Tile, tileURL(0) });
+    ASSERT_NE(nullptr, res.get());
+    EXPECT_EQ(1234, res->expires);
+}
+
+TEST_F(Storage, DatabaseEviction) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/eviction.db");
+    deleteFile("test/fixtures/database/eviction.db-wal");
+    deleteFile("test/fixtures/database/eviction.db-shm");
+
+    // Tiles that don't compress, so that their size in the database is known.
+    const std::size_t tileSize = 16 * 1024;
+    const auto tile = [&](std::size_t i) {
+        auto response = std::make_shared<Response>();
+        response->data.resize(tileSize);
+        uint32_t state = uint32_t(i) * 2654435761u + 1;
+        for (auto& c : response->data) {
+            state = state * 1664525u + 1013904223u;
+            c = char(state >> 24);
+        }
+        return response;
+    };
+
+    SQLiteCache::Impl cache(nullptr, "test/fixtures/database/eviction.db");
+    cache.setMaximumSize(64 * tileSize);
+
+    auto style = std::make_shared<Response>();
+    style->data = "{}";
+    cache.put({ Resource::Style, "mapbox://styles/test" }, style);
+    for (std::size_t i = 0; i < 40; i++) {
+        cache.put({ Resource::Tile, tileURL(i) }, tile(i));
+    }
+    EXPECT_EQ(0u, cache.getEvictedBytes());
+
+    // Access times have a resolution of one second.
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+
+    // Use the even tiles again, then add more tiles than fit.
+    for (std::size_t i = 0; i < 40; i += 2) {
+        EXPECT_NE(nullptr, cache.get({ Resource::Tile, tileURL(i) }).get());
+    }
+    for (std::size_t i = 40; i < 80; i++) {
+        cache.put({ Resource::Tile, tileURL(i) }, tile(i));
+    }
+
+    EXPECT_LE(cache.getSize(), 68 * tileSize);
+    EXPECT_GE(cache.getEvictedBytes(), 16 * tileSize);
+
+    // The odd tiles were used least recently and are evicted first. Styles are kept.
+    std::size_t oddTiles = 0;
+    std::size_t evenTiles = 0;
+    for (std::size_t i = 0; i < 40; i++) {
+        if (cache.get({ Resource::Tile, tileURL(i) })) {
+            (i % 2 ? oddTiles : evenTiles)++;
+        }
+    }
+    EXPECT_EQ(0u, oddTiles);
+    EXPECT_EQ(20u, evenTiles);
+    EXPECT_NE(nullptr, cache.get({ Resource::Style, "mapbox://styles/test" }).get());
+    EXPECT_NE(nullptr, cache.get({ Resource::Tile, tileURL(79) }).get());
+
+    // Lowering the maximum size evicts right away.
+    cache.setMaximumSize(16 * tileSize);
+    EXPECT_LE(cache.getSize(), 20 * tileSize);
+    EXPECT_NE(nullptr, cache.get({ Resource::Style, "mapbox://styles/test" }).get());
+}
+
+TEST_F(Storage, DatabaseVacuumWhenIdle) {
+    using namespace mbgl;
+
+    createDir("test/fixtures/database");
+    deleteFile("test/fixtures/database/vacuum.db");
+    deleteFile("test/fixtures/database/vacuum.db-wal");
+    deleteFile("test/fixtures/database/vacuum.db-shm");
+
+    // A database that was created without incremental vacuum.
+    sqlite3* legacy = nullptr;
+    ASSERT_EQ(SQLITE_OK, sqlite3_open("test/fixtures/database/vacuum.db", &legacy));
+    ASSERT_EQ(SQLITE_OK, sqlite3_exec(legacy, "PRAGMA auto_vacuum = NONE; CREATE TABLE `legacy` (`id` INTEGER)",
+                                      nullptr, nullptr, nullptr));
+    sqlite3_close(legacy);
+    ASSERT_EQ(0, autoVacuum("test/fixtures/database/vacuum.db"));
+
+    uv::loop loop;
+    SQLiteCache::Impl cache(loop.get(), "test/fixtures/database/vacuum.db");
+
+    // Opening the database doesn't rebuild it.
+    cache.put({ Resource::Tile, tileURL(0) }, tileResponse(0));
+    EXPECT_NE(nullptr, cache.get({ Resource::Tile, tileURL(0) }).get());
+    EXPECT_EQ(0, autoVacuum("test/fixtures/database/vacuum.db"));
+
+    // It is rebuilt once there were no requests for a while.
+    loop.run();
+    EXPECT_EQ(2 /* INCREMENTAL */, autoVacuum("test/fixtures/database/vacuum.db"));
+    EXPECT_NE(nullptr, cache.get({ Resource::Tile, tileURL(0) }).get());
+}
@@ -0,0 +1,77 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include <mbgl/storage/default_file_source.hpp>
+
+#include <string>
+#include <vector>
+
+TEST_F(Storage, HTTPPriority) {
+    SCOPED_TEST(HTTPPriority)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    // With a single slot, all requests after the first one wait in the file source.
+    fs.setMaxActiveRequests(1, 1);
+
+    std::vector<std::string> order;
+    const auto request = [&](Resource::Kind kind, const std::string& name) {
+        return fs.request({ kind, "http://127.0.0.1:3000/test?" + name }, uv_default_loop(),
+                          [&, name](const Response &res) {
+            EXPECT_EQ(Response::Successful, res.status);
+            EXPECT_EQ("Hello World!", res.data);
+            order.push_back(name);
+            if (order.size() == 5) {
+                HTTPPriority.finish();
+            }
+        });
+    };
+
+    request(Resource::Unknown, "first");
+    auto far = request(Resource::Tile, "far");
+    auto near = request(Resource::Tile, "near");
+    auto canceled = request(Resource::Tile, "canceled");
+    request(Resource::Glyphs, "glyphs");
+    auto moved = request(Resource::Tile, "moved");
+
+    fs.setPriority(far, 3);
+    fs.setPriority(near, 1);
+    fs.setPriority(moved, 4);
+    fs.setPriority(moved, 2);
+    fs.cancel(canceled);
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    // The glyphs go ahead of all tiles, and tiles start in the order of their latest priority.
+    // The canceled tile never started.
+    const std::vector<std::string> expected { "first", "glyphs", "near", "moved", "far" };
+    EXPECT_EQ(expected, order);
+}
+
+TEST_F(Storage, HTTPPriorityTileLimit) {
+    SCOPED_TEST(HTTPPriorityTileLimit)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    // No tile may start, but other requests still have a slot.
+    fs.setMaxActiveRequests(2, 0);
+
+    auto tile = fs.request({ Resource::Tile, "http://127.0.0.1:3000/test?tile" }, uv_default_loop(),
+                           [&](const Response &) {
+        ADD_FAILURE() << "Callback should not be called";
+    });
+
+    fs.request({ Resource::Style, "http://127.0.0.1:3000/test?style" }, uv_default_loop(),
+               [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+        fs.cancel(tile);
+        HTTPPriorityTileLimit.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
@@ -3,6 +3,7 @@
 #include <uv.h>
 
 #include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/sqlite_cache.hpp>
 
 #include <future>
 
@@ -56,3 +57,44 @@ TEST_F(Storage, HTTPNoCallback) {
 
     HTTPTest.finish();
 }
+
+TEST_F(Storage, HTTPTiming) {
+    SCOPED_TEST(HTTPTest)
+    SCOPED_TEST(CacheTest)
+
+    using namespace mbgl;
+
+    SQLiteCache cache;
+    DefaultFileSource fs(&cache);
+
+    // Expires far in the future, so that the second request is answered by the cache.
+    const Resource resource { Resource::Unknown, "http://127.0.0.1:3000/test?expires=2000000000" };
+
+    fs.request(resource, uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+        EXPECT_TRUE(res.downloaded);
+
+        // Each phase is measured from the start of the request. There is no TLS handshake
+        // for plain HTTP.
+        EXPECT_LT(Duration::zero(), res.timing.nameLookup);
+        EXPECT_LE(res.timing.nameLookup, res.timing.connect);
+        EXPECT_EQ(Duration::zero(), res.timing.tlsHandshake);
+        EXPECT_LT(res.timing.connect, res.timing.firstByte);
+        HTTPTest.finish();
+
+        fs.request(resource, uv_default_loop(), [&](const Response &cached) {
+            EXPECT_EQ(Response::Successful, cached.status);
+            EXPECT_EQ("Hello World!", cached.data);
+            EXPECT_FALSE(cached.downloaded);
+
+            // Responses that didn't come from the network have no timings.
+            EXPECT_EQ(Duration::zero(), cached.timing.nameLookup);
+            EXPECT_EQ(Duration::zero(), cached.timing.connect);
+            EXPECT_EQ(Duration::zero(), cached.timing.tlsHandshake);
+            EXPECT_EQ(Duration::zero(), cached.timing.firstByte);
+            CacheTest.finish();
+        });
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
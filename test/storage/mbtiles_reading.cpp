@@ -0,0 +1,146 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/file_cache.hpp>
+
+#include <rapidjson/document.h>
+
+#include <atomic>
+
+TEST_F(Storage, MBTilesTile) {
+    SCOPED_TEST(PlainTile)
+    SCOPED_TEST(CompressedTile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles/0/0/0" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+        EXPECT_EQ("tile 0/0/0", res.data);
+        EXPECT_EQ("", res.message);
+        PlainTile.finish();
+    });
+
+    // This tile is stored gzip compressed, in row 1 of zoom level 1, which is y = 0.
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles/1/1/0.pbf" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+        EXPECT_EQ("tile 1/1/0", res.data);
+        EXPECT_EQ("", res.message);
+        CompressedTile.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesMissingTile) {
+    SCOPED_TEST(MissingTile)
+    SCOPED_TEST(InvalidURL)
+    SCOPED_TEST(MissingFile)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles/1/0/0" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Error, res.status);
+        EXPECT_EQ("", res.data);
+        EXPECT_EQ("Tile not found", res.message);
+        MissingTile.finish();
+    });
+
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles/1/2/0" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Error, res.status);
+        EXPECT_EQ("Invalid tile URL", res.message);
+        InvalidURL.finish();
+    });
+
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/does_not_exist.mbtiles/0/0/0" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Error, res.status);
+        EXPECT_EQ("unable to open database file", res.message);
+        MissingFile.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+TEST_F(Storage, MBTilesTileJSON) {
+    SCOPED_TEST(TileJSON)
+
+    using namespace mbgl;
+
+    DefaultFileSource fs(nullptr);
+
+    const std::string url = "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles";
+    fs.request({ Resource::Source, url }, uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+
+        rapidjson::Document d;
+        d.Parse<0>(res.data.c_str());
+        ASSERT_FALSE(d.HasParseError());
+
+        ASSERT_TRUE(d["tiles"].IsArray());
+        EXPECT_EQ(url + "/{z}/{x}/{y}", d["tiles"][rapidjson::SizeType(0)].GetString());
+        EXPECT_EQ(std::string("Test \"tiles\""), d["name"].GetString());
+        EXPECT_EQ(0u, d["minzoom"].GetUint());
+        EXPECT_EQ(1u, d["maxzoom"].GetUint());
+        ASSERT_TRUE(d["bounds"].IsArray());
+        ASSERT_EQ(4u, d["bounds"].Size());
+        EXPECT_EQ(-180, d["bounds"][rapidjson::SizeType(0)].GetDouble());
+        ASSERT_TRUE(d["center"].IsArray());
+        EXPECT_EQ(3u, d["center"].Size());
+        TileJSON.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+}
+
+namespace {
+
+// Counts the lookups and stores made through it, which happen on the file source thread.
+class CountingCache : public mbgl::FileCache {
+public:
+    void get(const mbgl::Resource&, Callback callback) override {
+        gets++;
+        callback(nullptr);
+    }
+
+    void put(const mbgl::Resource&, std::shared_ptr<const mbgl::Response>, Hint hint) override {
+        if (hint != Hint::No) {
+            puts++;
+        }
+    }
+
+    std::atomic<int> gets { 0 };
+    std::atomic<int> puts { 0 };
+};
+
+}
+
+TEST_F(Storage, MBTilesBypassesCache) {
+    SCOPED_TEST(Tile)
+
+    using namespace mbgl;
+
+    CountingCache cache;
+    DefaultFileSource fs(&cache);
+
+    fs.request({ Resource::Tile, "mbtiles://TEST_DATA/fixtures/storage/tiles.mbtiles/0/0/0" },
+               uv_default_loop(), [&](const Response &res) {
+        EXPECT_EQ(Response::Successful, res.status);
+        EXPECT_EQ("tile 0/0/0", res.data);
+        Tile.finish();
+    });
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ(0, cache.gets);
+    EXPECT_EQ(0, cache.puts);
+}
@@ -0,0 +1,208 @@
+#include "storage.hpp"
+
+#include <uv.h>
+
+#include "sqlite_cache_impl.hpp"
+#include <mbgl/storage/default_file_source.hpp>
+#include <mbgl/storage/offline_download.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/storage/sqlite_cache.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+namespace {
+
+// Counts the requests that are passed on to the wrapped file source.
+class CountingFileSource : public mbgl::FileSource {
+public:
+    CountingFileSource(mbgl::FileSource& fileSource_) : fileSource(fileSource_) {}
+
+    mbgl::Request* request(const mbgl::Resource& resource, uv_loop_t* loop, Callback callback) override {
+        requests++;
+        return fileSource.request(resource, loop, callback);
+    }
+
+    void cancel(mbgl::Request* request) override {
+        fileSource.cancel(request);
+    }
+
+    std::size_t requests = 0;
+
+private:
+    mbgl::FileSource& fileSource;
+};
+
+mbgl::OfflineRegion region() {
+    mbgl::OfflineRegion region;
+    region.styleURL = "http://127.0.0.1:3000/offline/style.json";
+    region.bounds = { { -10, -10 }, { 10, 10 } };
+    region.minZoom = 0;
+    region.maxZoom = 1;
+    return region;
+}
+
+// The style, the raster TileJSON, 5 tiles of each source at zoom levels 0 and 1, 256 glyph
+// ranges of the single font stack, and the sprite image and JSON.
+const uint64_t regionResources = 270;
+
+// Files that the downloads write go to a temporary directory instead of the fixtures.
+std::string tempPath(const std::string& name) {
+    static const std::string dir = [] {
+        const char* tmp = std::getenv("TMPDIR");
+        std::string path = std::string(tmp && *tmp ? tmp : "/tmp") + "/mbgl-offline-XXXXXX";
+        return mkdtemp(&path[0]) ? path : std::string(tmp && *tmp ? tmp : "/tmp");
+    }();
+    return dir + "/" + name;
+}
+
+std::size_t countLines(const std::string& path) {
+    std::ifstream file(path);
+    std::size_t lines = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines++;
+    }
+    return lines;
+}
+
+}
+
+TEST_F(Storage, OfflineDownload) {
+    SCOPED_TEST(Download)
+
+    using namespace mbgl;
+
+    const std::string progressPath = tempPath("offline_download.progress");
+    std::remove(progressPath.c_str());
+
+    DefaultFileSource defaultFileSource(nullptr);
+    CountingFileSource fs(defaultFileSource);
+
+    OfflineDownload download(fs, uv_default_loop(), region(), progressPath, [&](const OfflineProgress& progress) {
+        EXPECT_LE(progress.completedResources, progress.requiredResources);
+        if (progress.complete) {
+            EXPECT_EQ(regionResources, progress.requiredResources);
+            EXPECT_EQ(regionResources, progress.completedResources);
+            EXPECT_EQ(0u, progress.failedResources);
+            EXPECT_LT(0u, progress.completedBytes);
+            Download.finish();
+        }
+    });
+    download.setConcurrentRequests(4);
+    download.start();
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ(regionResources, fs.requests);
+    EXPECT_EQ(regionResources, countLines(progressPath));
+    std::remove(progressPath.c_str());
+}
+
+TEST_F(Storage, OfflineDownloadResume) {
+    SCOPED_TEST(Stopped)
+    SCOPED_TEST(Resumed)
+
+    using namespace mbgl;
+
+    const std::string progressPath = tempPath("offline_resume.progress");
+    std::remove(progressPath.c_str());
+
+    DefaultFileSource defaultFileSource(nullptr);
+
+    // Stop the first download after ten resources, which include the style and the TileJSON.
+    const uint64_t stopAfter = 10;
+    {
+        CountingFileSource fs(defaultFileSource);
+        std::unique_ptr<OfflineDownload> download;
+        download = std::make_unique<OfflineDownload>(fs, uv_default_loop(), region(), progressPath,
+                                                     [&](const OfflineProgress& progress) {
+            if (progress.completedResources == stopAfter) {
+                download->stop();
+                EXPECT_FALSE(progress.complete);
+                Stopped.finish();
+            }
+        });
+        download->setConcurrentRequests(1);
+        download->start();
+
+        uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+        EXPECT_EQ(stopAfter, countLines(progressPath));
+    }
+
+    // The second download only requests what is missing, plus the style and the TileJSON.
+    CountingFileSource fs(defaultFileSource);
+    OfflineDownload download(fs, uv_default_loop(), region(), progressPath, [&](const OfflineProgress& progress) {
+        if (progress.complete) {
+            EXPECT_EQ(regionResources, progress.requiredResources);
+            EXPECT_EQ(regionResources, progress.completedResources);
+            Resumed.finish();
+        }
+    });
+    download.start();
+
+    uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+
+    EXPECT_EQ(regionResources - stopAfter + 2, fs.requests);
+    EXPECT_EQ(regionResources, countLines(progressPath));
+    std::remove(progressPath.c_str());
+}
+
+TEST_F(Storage, OfflineDownloadCached) {
+    SCOPED_TEST(Download)
+
+    using namespace mbgl;
+
+    const std::string progressPath = tempPath("offline_cached.progress");
+    const std::string cachePath = tempPath("offline_cached.db");
+    for (const auto& path : { progressPath, cachePath, cachePath + "-wal", cachePath + "-shm" }) {
+        std::remove(path.c_str());
+    }
+
+    {
+        SQLiteCache cache(cachePath);
+        DefaultFileSource fs(&cache);
+
+        OfflineDownload download(fs, uv_default_loop(), region(), progressPath, [&](const OfflineProgress& progress) {
+            if (progress.complete) {
+                EXPECT_EQ(regionResources, progress.completedResources);
+                EXPECT_EQ(0u, progress.failedResources);
+                Download.finish();
+            }
+        });
+        download.start();
+
+        uv_run(uv_default_loop(), UV_RUN_DEFAULT);
+    }
+
+    // Reads the cache without a file source, so nothing can come from the network.
+    SQLiteCache::Impl cache(nullptr, cachePath);
+
+    auto response = std::make_shared<Response>();
+    response->status = Response::Successful;
+    response->data = "Not part of the region";
+    cache.put({ Resource::Tile, "http://127.0.0.1:3000/offline/unpinned" }, response);
+
+    // Evicts everything that isn't pinned.
+    cache.setMaximumSize(0);
+    EXPECT_LT(0u, cache.getEvictedBytes());
+    EXPECT_EQ(nullptr, cache.get({ Resource::Tile, "http://127.0.0.1:3000/offline/unpinned" }).get());
+
+    std::ifstream file(progressPath);
+    std::size_t cached = 0;
+    std::string url;
+    while (std::getline(file, url)) {
+        auto res = cache.get({ Resource::Unknown, url });
+        EXPECT_NE(nullptr, res.get()) << url;
+        if (res) {
+            EXPECT_EQ(Response::Successful, res->status);
+            cached++;
+        }
+    }
+    EXPECT_EQ(regionResources, cached);
+
+    for (const auto& path : { progressPath, cachePath, cachePath + "-wal", cachePath + "-shm" }) {
+        std::remove(path.c_str());
+    }
+}
@@ -96,6 +96,39 @@ app.get('/load/:number(\\d+)', function(req, res) {
     res.send('Request ' + req.params.number);
 });
 
+app.get('/offline/style.json', function(req, res) {
+    res.json({
+        version: 7,
+        sources: {
+            vector: {
+                type: 'vector',
+                tiles: ['http://127.0.0.1:3000/offline/vector/{z}/{x}/{y}.pbf']
+            },
+            raster: {
+                type: 'raster',
+                url: 'http://127.0.0.1:3000/offline/raster.json'
+            }
+        },
+        glyphs: 'http://127.0.0.1:3000/offline/glyphs/{fontstack}/{range}.pbf',
+        sprite: 'http://127.0.0.1:3000/offline/sprite',
+        layers: [{
+            id: 'labels',
+            type: 'symbol',
+            source: 'vector',
+            'source-layer': 'labels',
+            layout: { 'text-field': '{name}', 'text-font': 'Test Font' }
+        }]
+    });
+});
+
+app.get('/offline/raster.json', function(req, res) {
+    res.json({ tilejson: '2.1.0', tiles: ['http://127.0.0.1:3000/offline/raster/{z}/{x}/{y}.png'] });
+});
+
+app.get(/^\/offline\/(vector|raster|glyphs|sprite)/, function(req, res) {
+    res.send('Offline ' + req.path);
+});
+
 var server = app.listen(3000, function () {
     var host = server.address().address;
     var port = server.address().port;